@@ -0,0 +1,2145 @@
+/**
+ * Host microbenchmarks for the firmware's hot paths. Build and run with:
+ *
+ *     $ pio run -e native -t exec
+ *
+ * Each benchmark reports the mean time and number of heap allocations per
+ * operation. Recorded feed payloads are read from the files named on the
+ * command line (default: bench/feed.json), along with gzip-compressed copies
+ * of them (e.g. bench/feed.json.gz) where present. Each feed is also
+ * re-encoded in the binary departures format to benchmark its decoder.
+ *
+ * Before benchmarking, the generated journey tables are checked against a
+ * reference implementation of the original route-finding DFS and the needle
+ * animation against the original floating point implementation. The feed
+ * parser is benchmarked alongside the jsmn parsing it replaced, reporting the
+ * peak heap each allocates.
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <pgmspace.h>
+
+#include "metrolink.h"
+#include "metrolink_map.h"
+#include "departures.h"
+#include "departures_binary.h"
+#include "display.h"
+#include "config_journal.h"
+#include "perf.h"
+#include "metrics.h"
+#include "scheduler.h"
+#include "power.h"
+#include "dns_message.h"
+#include "dns_cache.h"
+#include "inflate.h"
+#include "http_response.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocation counting
+////////////////////////////////////////////////////////////////////////////////
+
+// The firmware allocates exclusively with new/new[] so counting these is
+// sufficient.
+static size_t num_allocations = 0;
+
+// Bytes currently allocated, and the most allocated at once since
+// heap_peak_bytes was last reset
+static size_t heap_bytes = 0;
+static size_t heap_peak_bytes = 0;
+
+// Each block is preceded by its size, padded to keep malloc's alignment
+static const size_t BLOCK_HEADER_SIZE = alignof(max_align_t);
+
+// Not inlined, so that the compiler doesn't see the header access as out of
+// bounds
+__attribute__((noinline)) void *operator new(size_t size) {
+	num_allocations++;
+	char *block = (char *)malloc(BLOCK_HEADER_SIZE + size);
+	if (!block) {
+		throw std::bad_alloc();
+	}
+	*(size_t *)block = size;
+	heap_bytes += size;
+	heap_peak_bytes = std::max(heap_peak_bytes, heap_bytes);
+	return block + BLOCK_HEADER_SIZE;
+}
+
+void *operator new[](size_t size) {
+	return operator new(size);
+}
+
+__attribute__((noinline)) void operator delete(void *ptr) noexcept {
+	if (!ptr) {
+		return;
+	}
+	char *block = (char *)ptr - BLOCK_HEADER_SIZE;
+	heap_bytes -= *(size_t *)block;
+	free(block);
+}
+
+void operator delete[](void *ptr) noexcept {
+	operator delete(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+	operator delete(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+	operator delete(ptr);
+}
+
+/**
+ * Run fn once and return the most heap it had allocated at once.
+ */
+static size_t measure_peak_heap(void (*fn)(void *data), void *data) {
+	size_t before = heap_bytes;
+	heap_peak_bytes = heap_bytes;
+	fn(data);
+	return heap_peak_bytes - before;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Harness
+////////////////////////////////////////////////////////////////////////////////
+
+// Minimum wall-clock time to spend running each benchmark
+static const double MIN_BENCHMARK_SECONDS = 0.5;
+
+/**
+ * Repeatedly call fn (which performs ops_per_call operations) until at least
+ * MIN_BENCHMARK_SECONDS have elapsed and print the time and allocations per
+ * operation. Returns the mean time per operation in nanoseconds.
+ */
+static double run_benchmark(const char *name, size_t ops_per_call,
+                            void (*fn)(void *data), void *data) {
+	using namespace std::chrono;
+
+	// Warm up
+	fn(data);
+
+	size_t calls = 0;
+	size_t allocations_before = num_allocations;
+	steady_clock::time_point start = steady_clock::now();
+	double elapsed;
+	do {
+		fn(data);
+		calls++;
+		elapsed = duration<double>(steady_clock::now() - start).count();
+	} while (elapsed < MIN_BENCHMARK_SECONDS);
+	size_t allocations = num_allocations - allocations_before;
+
+	double ops = (double)calls * ops_per_call;
+	double ns_per_op = (elapsed * 1e9) / ops;
+	printf("%-40s %14.1f ns/op %10.2f allocs/op\n",
+	       name, ns_per_op, allocations / ops);
+	return ns_per_op;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Feed payloads
+////////////////////////////////////////////////////////////////////////////////
+
+// Size of the chunks fed to the parser (roughly one TCP segment)
+static const size_t FEED_CHUNK_SIZE = 1460;
+
+typedef struct {
+	const char *filename;
+	char *data;
+	size_t length;
+} feed_t;
+
+/**
+ * Read a whole file into memory. Returns false on failure.
+ */
+static bool load_feed(feed_t *feed, const char *filename) {
+	FILE *f = fopen(filename, "rb");
+	if (!f) {
+		return false;
+	}
+	fseek(f, 0, SEEK_END);
+	feed->filename = filename;
+	feed->length = ftell(f);
+	feed->data = (char *)malloc(feed->length);
+	fseek(f, 0, SEEK_SET);
+	bool ok = fread(feed->data, 1, feed->length, f) == feed->length;
+	fclose(f);
+	return ok;
+}
+
+/**
+ * All distinct names (station locations and destinations) appearing in the
+ * feeds, used as realistic inputs to the name lookup benchmarks.
+ */
+static const size_t MAX_FEED_NAMES = 256;
+static char feed_names[MAX_FEED_NAMES][DEPARTURES_MAX_NAME_LENGTH];
+static size_t num_feed_names = 0;
+
+static void add_feed_name(const char *name) {
+	if (!name[0] || num_feed_names >= MAX_FEED_NAMES) {
+		return;
+	}
+	for (size_t i = 0; i < num_feed_names; i++) {
+		if (strcmp(feed_names[i], name) == 0) {
+			return;
+		}
+	}
+	strcpy(feed_names[num_feed_names++], name);
+}
+
+static void collect_feed_names(const departures_record_t *record, void *data) {
+	(void)data;
+	add_feed_name(record->station_location);
+	for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+		add_feed_name(record->destinations[i].name);
+	}
+}
+
+static void parse_feed(const feed_t *feed,
+                       departures_record_callback_t callback, void *data) {
+	departures_parser_t parser;
+	departures_parser_init(&parser, callback, data);
+	for (size_t i = 0; i < feed->length; i += FEED_CHUNK_SIZE) {
+		size_t length = feed->length - i;
+		if (length > FEED_CHUNK_SIZE) {
+			length = FEED_CHUNK_SIZE;
+		}
+		departures_parser_feed(&parser, feed->data + i, length);
+	}
+}
+
+/**
+ * Check filtered request paths are built as tools/feed_server.py expects, and
+ * that only responses rejecting the filter make the firmware stop filtering.
+ * Returns the number of failures.
+ */
+static size_t check_departures_requests(void) {
+	static const char *stations[] = {"Piccadilly", "St Peter's Square"};
+	char path[512];
+	size_t failures = !departures_build_request_path(path, sizeof(path), "/odata/Metrolinks",
+	                                                 stations, 2);
+	static const char expected[] =
+		"/odata/Metrolinks?$filter=StationLocation%20eq%20%27Piccadilly%27"
+		"%20or%20StationLocation%20eq%20%27St%20Peter%27%27s%20Square%27"
+		"&$select=StationLocation,Dest0,";
+	failures += strncmp(path, expected, sizeof(expected) - 1) != 0;
+	failures += departures_build_request_path(path, 40, "/odata/Metrolinks", stations, 2);
+
+	static const int rejected[] = {400, 414, 501};
+	static const int not_rejected[] = {-1, 200, 401, 404, 408, 429, 500, 502, 503, 504};
+	for (int status : rejected) {
+		failures += !departures_filter_rejected(status);
+	}
+	for (int status : not_rejected) {
+		failures += departures_filter_rejected(status);
+	}
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reference jsmn parsing
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The parsing formerly done by get_next_departure_wait() and parse_value(),
+ * kept to measure the streaming parser against. Each record is accumulated a
+ * character at a time up to its closing brace (as Stream::readStringUntil
+ * did), tokenised twice by jsmn (once to count the tokens, then into a heap
+ * allocated array), and each key and value copied out as a string. std::string
+ * stands in for Arduino's String and the tokeniser below follows jsmn's
+ * non-strict mode.
+ */
+typedef enum {
+	REFERENCE_JSMN_UNDEFINED,
+	REFERENCE_JSMN_OBJECT,
+	REFERENCE_JSMN_ARRAY,
+	REFERENCE_JSMN_STRING,
+	REFERENCE_JSMN_PRIMITIVE,
+} reference_jsmn_type_t;
+
+typedef struct {
+	reference_jsmn_type_t type;
+	int start;
+	int end;
+	int size;
+} reference_jsmn_token_t;
+
+/**
+ * Tokenise js into tokens (or just count the tokens if tokens is NULL).
+ * Returns the number of tokens or -1 if the JSON is malformed or there are
+ * too many tokens.
+ */
+static int reference_jsmn_parse(const char *js, size_t length,
+                                reference_jsmn_token_t *tokens, size_t num_tokens) {
+	size_t next = 0;
+	int super = -1;
+	int count = 0;
+	for (size_t pos = 0; pos < length && js[pos]; pos++) {
+		char c = js[pos];
+		switch (c) {
+			case '{':
+			case '[':
+				count++;
+				if (tokens) {
+					if (next >= num_tokens) {
+						return -1;
+					}
+					if (super >= 0) {
+						tokens[super].size++;
+					}
+					reference_jsmn_token_t *token = &tokens[next];
+					token->type = c == '{' ? REFERENCE_JSMN_OBJECT : REFERENCE_JSMN_ARRAY;
+					token->start = pos;
+					token->end = -1;
+					token->size = 0;
+					super = next++;
+				}
+				break;
+
+			case '}':
+			case ']':
+				if (tokens) {
+					// Find the innermost open container, then its parent
+					reference_jsmn_type_t type =
+						c == '}' ? REFERENCE_JSMN_OBJECT : REFERENCE_JSMN_ARRAY;
+					int i = next - 1;
+					while (i >= 0 && !(tokens[i].start != -1 && tokens[i].end == -1)) {
+						i--;
+					}
+					if (i < 0 || tokens[i].type != type) {
+						return -1;
+					}
+					tokens[i].end = pos + 1;
+					super = -1;
+					for (i--; i >= 0; i--) {
+						if (tokens[i].start != -1 && tokens[i].end == -1) {
+							super = i;
+							break;
+						}
+					}
+				}
+				break;
+
+			case '"': {
+				size_t start = pos;
+				for (pos++; pos < length && js[pos] != '"'; pos++) {
+					if (js[pos] == '\\') {
+						pos++;
+					}
+				}
+				if (pos >= length) {
+					return -1;
+				}
+				count++;
+				if (tokens) {
+					if (next >= num_tokens) {
+						return -1;
+					}
+					tokens[next++] = {REFERENCE_JSMN_STRING, (int)start + 1, (int)pos, 0};
+					if (super >= 0) {
+						tokens[super].size++;
+					}
+				}
+				break;
+			}
+
+			case '\t':
+			case '\r':
+			case '\n':
+			case ' ':
+			case ':':
+			case ',':
+				break;
+
+			default: {
+				size_t start = pos;
+				while (pos < length && js[pos] && !strchr("\t\r\n ,]}:", js[pos])) {
+					pos++;
+				}
+				count++;
+				if (tokens) {
+					if (next >= num_tokens) {
+						return -1;
+					}
+					tokens[next++] = {REFERENCE_JSMN_PRIMITIVE, (int)start, (int)pos, 0};
+					if (super >= 0) {
+						tokens[super].size++;
+					}
+				}
+				pos--;
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+static const metrolink_journey_t *reference_journey;
+
+/**
+ * As parse_value(): the lowest wait in a record at the journey's start station
+ * which stops at its destination, or -1.
+ */
+static int reference_parse_record(const std::string &object) {
+	int num_tokens = reference_jsmn_parse(object.c_str(), object.length(), NULL, 0);
+	if (num_tokens < 1) {
+		return -1;
+	}
+	reference_jsmn_token_t *tokens = new reference_jsmn_token_t[num_tokens];
+	num_tokens = reference_jsmn_parse(object.c_str(), object.length(), tokens, num_tokens);
+	if (num_tokens < 1 || tokens[0].type != REFERENCE_JSMN_OBJECT) {
+		delete[] tokens;
+		return -1;
+	}
+
+	std::string station_location;
+	struct {
+		std::string name;
+		int wait;
+	} destinations[4];
+	for (int i = 1; i < tokens[0].size * 2 + 1 && i + 1 < num_tokens; i += 2) {
+		std::string key = object.substr(tokens[i].start, tokens[i].end - tokens[i].start);
+		std::string value = object.substr(tokens[i + 1].start,
+		                                  tokens[i + 1].end - tokens[i + 1].start);
+		if (key == "StationLocation") {
+			station_location = value;
+		} else if (key.size() == 5 && key.compare(0, 4, "Dest") == 0 &&
+		           key[4] >= '0' && key[4] <= '3') {
+			destinations[key[4] - '0'].name = value;
+		} else if (key.size() == 5 && key.compare(0, 4, "Wait") == 0 &&
+		           key[4] >= '0' && key[4] <= '3') {
+			destinations[key[4] - '0'].wait = atoi(value.c_str());
+		}
+	}
+
+	int min_wait = -1;
+	if (metrolink_get_station_index(station_location.c_str()) == reference_journey->start_index) {
+		for (size_t i = 0; i < 4; i++) {
+			if (destinations[i].name.length() &&
+			    (destinations[i].wait < min_wait || min_wait == -1) &&
+			    metrolink_is_destination_valid(reference_journey, destinations[i].name.c_str())) {
+				min_wait = destinations[i].wait;
+			}
+		}
+	}
+	delete[] tokens;
+	return min_wait;
+}
+
+/**
+ * As get_next_departure_wait(), reading the body from a buffer instead of the
+ * network.
+ */
+static int reference_parse_feed(const char *data, size_t length) {
+	size_t pos = 0;
+	// readStringUntil('[')
+	while (pos < length && data[pos++] != '[') {
+	}
+
+	int min_wait = -1;
+	while (pos < length) {
+		std::string object;
+		while (pos < length && data[pos] != '}') {
+			object += data[pos++];
+		}
+		pos++;
+		object += "}";
+
+		int wait = reference_parse_record(object);
+		if (wait >= 0 && (wait < min_wait || min_wait == -1)) {
+			min_wait = wait;
+		}
+
+		// readStringUntil(',')
+		std::string skipped;
+		while (pos < length && data[pos] != ',') {
+			skipped += data[pos++];
+		}
+		pos++;
+	}
+	return min_wait;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reference route finding
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * The depth-first search formerly used by metrolink_set_journey(): visit every
+ * simple path from a station, marking stations reached on or after the target
+ * as valid destinations. Walks the network's compressed sparse row adjacency.
+ */
+static void reference_visit(bool *visited, bool *valid_destinations,
+                            size_t index, size_t target, bool already_reached) {
+	bool valid = already_reached || (index == target);
+
+	visited[index] = true;
+	if (valid) {
+		valid_destinations[index] = true;
+	}
+
+	const uint8_t *neighbours;
+	size_t num_neighbours = metrolink_get_neighbours(index, &neighbours);
+	for (size_t i = 0; i < num_neighbours; i++) {
+		size_t neighbour_index = pgm_read_byte(&neighbours[i]);
+		if (!visited[neighbour_index]) {
+			reference_visit(visited, valid_destinations,
+			                neighbour_index, target, valid);
+		}
+	}
+
+	visited[index] = false;
+}
+
+// The station names, copied out of flash by load_station_names()
+static char station_names[NUM_METROLINK_STATIONS][METROLINK_NAME_BUFFER_SIZE];
+
+/**
+ * Read every station name out of flash. Returns the number which don't map back
+ * to their own index.
+ */
+static size_t load_station_names(void) {
+	size_t mismatches = 0;
+	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
+		if (!metrolink_get_station_name(i, station_names[i], sizeof(station_names[i])) ||
+		    metrolink_get_station_index(station_names[i]) != (int)i) {
+			fprintf(stderr, "Mismatch: name of station %zu ('%s')\n", i, station_names[i]);
+			mismatches++;
+		}
+	}
+
+	// Truncated names are still terminated
+	char truncated[4];
+	mismatches += !metrolink_get_station_name(0, truncated, sizeof(truncated)) ||
+	              strlen(truncated) != 3 || strncmp(truncated, station_names[0], 3) != 0;
+	mismatches += metrolink_get_station_name(NUM_METROLINK_STATIONS, truncated,
+	                                         sizeof(truncated)) || truncated[0];
+	return mismatches;
+}
+
+/**
+ * Check that the generated adjacency lists exactly the links in
+ * METROLINK_LINKS. Returns the number of mismatches.
+ */
+static size_t check_network(void) {
+	std::vector<std::vector<size_t>> network(NUM_METROLINK_STATIONS);
+	for (size_t i = 0; i < NUM_METROLINK_LINKS; i++) {
+		int a, b;
+		metrolink_get_link(i, &a, &b);
+		network[a].push_back(b);
+		network[b].push_back(a);
+	}
+
+	size_t mismatches = 0;
+	for (size_t station = 0; station < NUM_METROLINK_STATIONS; station++) {
+		const uint8_t *neighbours;
+		size_t num_neighbours = metrolink_get_neighbours(station, &neighbours);
+		std::vector<size_t> adjacent(neighbours, neighbours + num_neighbours);
+		std::sort(adjacent.begin(), adjacent.end());
+		std::sort(network[station].begin(), network[station].end());
+		if (adjacent != network[station]) {
+			fprintf(stderr, "Mismatch: neighbours of %s\n", station_names[station]);
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+/**
+ * Check that metrolink_set_journey() and metrolink_is_destination_valid() agree
+ * with the reference DFS for every journey and destination. Returns the number
+ * of mismatches.
+ */
+static size_t check_journeys(void) {
+	size_t mismatches = load_station_names() + check_network();
+	for (size_t start = 0; start < NUM_METROLINK_STATIONS; start++) {
+		for (size_t target = 0; target < NUM_METROLINK_STATIONS; target++) {
+			// Station indices are 8-bit
+			bool visited[256] = {false};
+			bool valid_destinations[256] = {false};
+			if (start != target) {
+				reference_visit(visited, valid_destinations, start, target, false);
+			}
+
+			metrolink_journey_t journey;
+			metrolink_set_journey(&journey, station_names[start], station_names[target]);
+			for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
+				if (metrolink_is_destination_valid(&journey, station_names[i]) !=
+				    valid_destinations[i]) {
+					fprintf(stderr, "Mismatch: %s -> %s, destination %s\n",
+					        station_names[start], station_names[target],
+					        station_names[i]);
+					mismatches++;
+				}
+			}
+		}
+	}
+	return mismatches;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reference display animation
+////////////////////////////////////////////////////////////////////////////////
+
+// A non-linear calibration (PWM value for each minute)
+static const int DISPLAY_PWM_VALUES[DISPLAY_MAX_VALUE + 1] = {
+	0, 61, 130, 204, 283, 367, 455, 540, 622, 700, 772, 840, 901,
+};
+
+// A calibration with a non-monotone glitch
+static const int GLITCHY_PWM_VALUES[DISPLAY_MAX_VALUE + 1] = {
+	0, 70, 150, 140, 300, 310, 320, 500, 500, 500, 700, 650, 1023,
+};
+
+// A linear calibration, for which the calibration curve is the same as the
+// original linear interpolation
+static const int LINEAR_PWM_VALUES[DISPLAY_MAX_VALUE + 1] = {
+	0, 75, 150, 225, 300, 375, 450, 525, 600, 675, 750, 825, 900,
+};
+
+/**
+ * The original floating point display_update (called update_display in
+ * main.cpp), with its global state gathered into a struct.
+ */
+typedef struct {
+	float display_value;
+	bool display_wobble;
+	bool display_auto_decrement;
+	int last_metrolink_wait;
+	float wobble_phase;
+	const int *pwm_values;
+} reference_display_t;
+
+static const float REFERENCE_WOBBLE_MAGNITUDE = 0.5;
+static const float REFERENCE_UPDATE_INTERVAL = 0.1;
+
+static int reference_display_update(reference_display_t *d) {
+	if (d->display_auto_decrement) {
+		d->display_value -= REFERENCE_UPDATE_INTERVAL / 60.0;
+
+		if (d->display_value < d->last_metrolink_wait - (1 + REFERENCE_WOBBLE_MAGNITUDE)) {
+			d->display_auto_decrement = false;
+			d->display_wobble = true;
+			d->display_value = d->last_metrolink_wait;
+			d->wobble_phase = 3.14 * 1.5;
+		}
+	}
+
+	float value = d->display_value;
+	if (d->display_wobble) {
+		value += sin(d->wobble_phase) * REFERENCE_WOBBLE_MAGNITUDE;
+
+		d->wobble_phase += 3.14 * REFERENCE_UPDATE_INTERVAL;
+		while (d->wobble_phase > (3.14*2)) {
+			d->wobble_phase -= 3.14;
+		}
+	} else {
+		d->wobble_phase = 0.0;
+	}
+
+	if (value < 0.0) {
+		value = 0.0;
+	} else if (value > DISPLAY_MAX_VALUE) {
+		value = DISPLAY_MAX_VALUE;
+	}
+
+	int value_low = floorf(value);
+	int value_high = ceilf(value);
+
+	int pwm_low = d->pwm_values[value_low];
+	int pwm_high = d->pwm_values[value_high];
+	int pwm_range = pwm_high - pwm_low;
+
+	return pwm_low + (pwm_range * (value - value_low));
+}
+
+// Number of updates simulated for each scenario (long enough for countdowns to
+// run out and the needle to wobble for a while)
+static const size_t DISPLAY_SCENARIO_UPDATES = 1200;
+
+/**
+ * Compare the needle trajectories of display_update and the reference (using a
+ * linear calibration, so that only the animation is compared) for an error
+ * display followed by countdowns from every wait (starting at various
+ * points). Returns the largest difference in PWM values, excluding the update
+ * at which a countdown runs out: the reference's accumulated rounding error
+ * makes this happen one update early for some waits.
+ */
+static int check_display(size_t *num_transitions_differing) {
+	int max_difference = 0;
+	*num_transitions_differing = 0;
+
+	for (int wait = -1; wait <= DISPLAY_MAX_VALUE + 1; wait++) {
+		for (unsigned long elapsed_ms = 0; elapsed_ms <= 90000; elapsed_ms += 9300) {
+			display_t display;
+			display_init(&display, LINEAR_PWM_VALUES);
+
+			reference_display_t reference;
+			reference.pwm_values = LINEAR_PWM_VALUES;
+			reference.display_value = REFERENCE_WOBBLE_MAGNITUDE;
+			reference.display_wobble = true;
+			reference.display_auto_decrement = false;
+			reference.last_metrolink_wait = -1;
+			reference.wobble_phase = 0.0;
+
+			for (size_t i = 0; i < 2 * DISPLAY_SCENARIO_UPDATES; i++) {
+				if (wait >= 0 && i == DISPLAY_SCENARIO_UPDATES) {
+					display_show_wait(&display, wait, elapsed_ms);
+
+					// As show_wait_display did
+					float delta = elapsed_ms / (60.0 * 1000.0);
+					if (delta > 1.0 + REFERENCE_WOBBLE_MAGNITUDE) {
+						delta = 1.0 + REFERENCE_WOBBLE_MAGNITUDE;
+					}
+					reference.last_metrolink_wait = wait;
+					reference.display_auto_decrement = true;
+					reference.display_wobble = false;
+					reference.display_value = wait - delta;
+				}
+
+				int pwm = display_update(&display);
+				int reference_pwm = reference_display_update(&reference);
+
+				if (display.auto_decrement != reference.display_auto_decrement) {
+					// The countdowns ran out on different updates: skip this
+					// update and resynchronise with the reference
+					(*num_transitions_differing)++;
+					if (reference.display_auto_decrement) {
+						display.auto_decrement = true;
+						display.wobble = false;
+						display.value = lround(reference.display_value * DISPLAY_UNITS_PER_MINUTE);
+					} else {
+						display.auto_decrement = false;
+						display.wobble = true;
+						display.value = display.reported_wait;
+						// The step after the start of the wobble
+						display.wobble_phase = 16;
+					}
+					continue;
+				}
+
+				int difference = abs(pwm - reference_pwm);
+				if (difference > max_difference) {
+					max_difference = difference;
+				}
+			}
+		}
+	}
+	return max_difference;
+}
+
+/**
+ * Check that the calibration curve passes through every calibration point and
+ * never leaves the range of PWM values between adjacent points. Returns the
+ * number of failures and sets *max_deviation to the largest difference from
+ * linear interpolation.
+ */
+static size_t check_calibration_curve(const int pwm_values[DISPLAY_MAX_VALUE + 1],
+                                      int *max_deviation) {
+	static display_t display;
+	display_init(&display, pwm_values);
+
+	size_t failures = 0;
+	*max_deviation = 0;
+	const int entries_per_minute = DISPLAY_UNITS_PER_MINUTE >> DISPLAY_CURVE_SHIFT;
+	for (int i = 0; i < DISPLAY_CURVE_LENGTH; i++) {
+		int minute = i / entries_per_minute;
+		int offset = i % entries_per_minute;
+		int pwm = display.curve[i];
+		if (offset == 0) {
+			failures += pwm != pwm_values[minute];
+			continue;
+		}
+
+		int low = pwm_values[minute];
+		int high = pwm_values[minute + 1];
+		if (pwm < (low < high ? low : high) || pwm > (low < high ? high : low)) {
+			failures++;
+		}
+
+		int linear = low + ((high - low) * offset) / entries_per_minute;
+		if (abs(pwm - linear) > *max_deviation) {
+			*max_deviation = abs(pwm - linear);
+		}
+	}
+	return failures;
+}
+
+/**
+ * Check that restoring a saved display state and advancing it gives the same
+ * animation as updating the display all along. Returns the number of
+ * mismatches.
+ */
+static size_t check_display_advance() {
+	static display_t display;
+	static display_t restored;
+	display_init(&display, LINEAR_PWM_VALUES);
+	display_init(&restored, LINEAR_PWM_VALUES);
+
+	size_t failures = 0;
+	const uint32_t skips[] = {0, 1, 7, 19, 20, 123, 599, 900, 901, 5000};
+	for (int wait = 0; wait <= 3; wait++) {
+		for (size_t i = 0; i < sizeof(skips) / sizeof(skips[0]); i++) {
+			for (uint32_t start = 0; start < 1200; start += 37) {
+				display_show_wait(&display, wait, 0);
+				for (uint32_t n = 0; n < start; n++) {
+					display_update(&display);
+				}
+
+				display_state_t state;
+				display_save_state(&display, &state);
+				for (uint32_t n = 0; n < skips[i]; n++) {
+					display_update(&display);
+				}
+				display_restore_state(&restored, &state, skips[i]);
+
+				for (int n = 0; n < 25; n++) {
+					failures += display_update(&display) != display_update(&restored);
+				}
+			}
+		}
+	}
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Performance histograms
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Check that histogram percentiles bound the exact percentiles of a set of
+ * values from above, to within a factor of two. Returns the number of
+ * failures.
+ */
+static size_t check_perf_histogram(void) {
+	static perf_histogram_t histogram;
+	perf_histogram_clear(&histogram);
+
+	std::vector<uint32_t> values;
+	uint32_t state = 1;
+	for (int i = 0; i < 10000; i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		// Spread over many orders of magnitude (but below the last, unbounded,
+		// bucket)
+		uint32_t value = (state >> (32 - (PERF_HISTOGRAM_BUCKETS - 2))) >> (state % 16);
+		values.push_back(value);
+		perf_histogram_add(&histogram, value);
+	}
+	std::sort(values.begin(), values.end());
+
+	size_t failures = histogram.min != values.front() || histogram.max != values.back();
+	const unsigned int percents[] = {1, 10, 50, 90, 99, 100};
+	for (unsigned int percent : percents) {
+		uint32_t exact = values[(values.size() * percent + 99) / 100 - 1];
+		uint32_t bound = perf_histogram_percentile(&histogram, percent);
+		if (bound < exact || (uint64_t)bound > (uint64_t)exact * 2 + 1) {
+			fprintf(stderr, "p%u: exact %u, histogram bound %u\n", percent, exact, bound);
+			failures++;
+		}
+	}
+	return failures;
+}
+
+/**
+ * Check the Prometheus rendering of a histogram: buckets must be cumulative
+ * and end with the count, and output which doesn't fit must be flagged.
+ * Returns the number of failures.
+ */
+static size_t check_metrics_writer(void) {
+	static perf_histogram_t histogram;
+	perf_histogram_clear(&histogram);
+	const uint32_t values[] = {0, 1, 1, 5, 300, 70000, 1000000};
+	for (uint32_t value : values) {
+		perf_histogram_add(&histogram, value);
+	}
+
+	static char buf[2048];
+	metrics_writer_t writer;
+	metrics_writer_init(&writer, buf, sizeof(buf));
+	metrics_write_histogram(&writer, "h", "Test.", &histogram, 0);
+
+	size_t failures = writer.overflow || writer.length != strlen(buf);
+	failures += strstr(buf, "h_bucket{le=\"0\"} 1\n") == NULL;
+	failures += strstr(buf, "h_bucket{le=\"1\"} 3\n") == NULL;
+	failures += strstr(buf, "h_bucket{le=\"7\"} 4\n") == NULL;
+	failures += strstr(buf, "h_bucket{le=\"131071\"} 6\n") == NULL;
+	failures += strstr(buf, "h_bucket{le=\"+Inf\"} 7\n") == NULL;
+	failures += strstr(buf, "h_sum 1070307\nh_count 7\n") == NULL;
+
+	// Milliseconds exported as seconds
+	metrics_writer_init(&writer, buf, sizeof(buf));
+	metrics_write_histogram(&writer, "s", "Test.", &histogram, 3);
+	failures += writer.overflow;
+	failures += strstr(buf, "s_bucket{le=\"0.000\"} 1\n") == NULL;
+	failures += strstr(buf, "s_bucket{le=\"0.001\"} 3\n") == NULL;
+	failures += strstr(buf, "s_bucket{le=\"131.071\"} 6\n") == NULL;
+	failures += strstr(buf, "s_sum 1070.307\ns_count 7\n") == NULL;
+
+	// Too small: whatever fitted is kept and terminated
+	metrics_writer_init(&writer, buf, 40);
+	metrics_write_counter(&writer, "c", "Test.", 1);
+	metrics_write_histogram(&writer, "h", "Test.", &histogram, 0);
+	failures += !writer.overflow || writer.length >= 40 || strlen(buf) != writer.length;
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Poll scheduling and power
+////////////////////////////////////////////////////////////////////////////////
+
+// The scheduler's limits (see scheduler.cpp, milliseconds)
+static const unsigned long SCHEDULER_MIN_INTERVAL = 15000;
+static const unsigned long SCHEDULER_MAX_INTERVAL = 120000;
+static const unsigned long SCHEDULER_NO_DEPARTURE_INTERVAL = 60000;
+static const unsigned long SCHEDULER_MIN_BACKOFF = 5000;
+static const unsigned long SCHEDULER_MAX_BACKOFF = 600000;
+static const unsigned long SCHEDULER_JITTER = 32;
+
+/**
+ * Check that successful polls are scheduled within the jitter of the nominal
+ * interval, repeating each to exercise the jitter. Returns the number of
+ * failures.
+ */
+static size_t check_scheduler_interval(scheduler_t *scheduler, int wait,
+                                       unsigned long since_change,
+                                       unsigned long nominal) {
+	unsigned long range = (nominal / 256) * SCHEDULER_JITTER;
+	unsigned long min = ULONG_MAX;
+	unsigned long max = 0;
+	for (int i = 0; i < 100; i++) {
+		unsigned long interval = scheduler_poll_complete(scheduler, true, 0, wait, since_change);
+		min = std::min(min, interval);
+		max = std::max(max, interval);
+	}
+	if (min < nominal - range || max > nominal + range || min == max) {
+		fprintf(stderr, "wait %d, %lu ms since change: intervals %lu-%lu ms, expected %lu+-%lu\n",
+		        wait, since_change, min, max, nominal, range);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Check the backoff after repeated failures doubles up to its maximum and
+ * resets after a success, the interval chosen for each wait and the poll
+ * statistics. Returns the number of failures.
+ */
+static size_t check_scheduler(void) {
+	scheduler_t scheduler;
+	scheduler_init(&scheduler, 1000, 12345);
+	size_t failures = 0;
+
+	// Backoff ('equal jitter': between half and all of the nominal backoff)
+	for (int round = 0; round < 2; round++) {
+		for (unsigned int i = 0; i < 40; i++) {
+			unsigned long nominal = i < 16 ? std::min(SCHEDULER_MIN_BACKOFF << i,
+			                                          SCHEDULER_MAX_BACKOFF)
+			                               : SCHEDULER_MAX_BACKOFF;
+			unsigned long interval = scheduler_poll_complete(&scheduler, false, 0, 5, 0);
+			if (interval < nominal / 2 || interval > nominal) {
+				fprintf(stderr, "failure %u: backoff %lu ms, expected %lu-%lu\n",
+				        i + 1, interval, nominal / 2, nominal);
+				failures++;
+			}
+		}
+		// Reset by a success
+		scheduler_poll_complete(&scheduler, true, 0, 5, 0);
+	}
+
+	failures += check_scheduler_interval(&scheduler, -1, 0, SCHEDULER_NO_DEPARTURE_INTERVAL);
+	failures += check_scheduler_interval(&scheduler, 0, 0, SCHEDULER_MIN_INTERVAL);
+	failures += check_scheduler_interval(&scheduler, 1, 0, SCHEDULER_MIN_INTERVAL);
+	failures += check_scheduler_interval(&scheduler, 5, 0, 50000);
+	failures += check_scheduler_interval(&scheduler, 12, 0, SCHEDULER_MAX_INTERVAL);
+	failures += check_scheduler_interval(&scheduler, 30, 0, SCHEDULER_MAX_INTERVAL);
+
+	// A wait which should have changed by now is caught up on quickly
+	failures += check_scheduler_interval(&scheduler, 5, 60000, 50000);
+	failures += check_scheduler_interval(&scheduler, 5, 60001, SCHEDULER_MIN_INTERVAL);
+	failures += check_scheduler_interval(&scheduler, 30, 120000, SCHEDULER_MIN_INTERVAL);
+
+	// 10 polls of 18 s each in half an hour
+	scheduler_init(&scheduler, 1000, 12345);
+	failures += scheduler_polls_per_hour(&scheduler, 1000) != 0 ||
+	            scheduler_radio_on_percent(&scheduler, 1000) != 0;
+	for (int i = 0; i < 10; i++) {
+		scheduler_poll_complete(&scheduler, true, 18000, 5, 0);
+	}
+	failures += scheduler_polls_per_hour(&scheduler, 1000 + 1800000) != 20 ||
+	            scheduler_radio_on_percent(&scheduler, 1000 + 1800000) != 10;
+	failures += scheduler_polls_per_hour(&scheduler, 1000 + 7200000) != 5 ||
+	            scheduler_radio_on_percent(&scheduler, 1000 + 7200000) != 2;
+	return failures;
+}
+
+/**
+ * Check the radio on and asleep times through toggling and repeated changes to
+ * the same state, that they always add up to an hour, and the CPU time.
+ * Returns the number of failures.
+ */
+static size_t check_power_budget(void) {
+	power_budget_t budget;
+	power_budget_hourly_t hourly;
+	power_budget_init(&budget, 1000);
+	power_budget_per_hour(&budget, 1000, &hourly);
+	size_t failures = hourly.radio_on || hourly.radio_asleep || hourly.cpu_active;
+
+	// On for 10 minutes (switching on again changes nothing), then off
+	power_budget_set_radio(&budget, 1000 + 300000, true);
+	power_budget_set_radio(&budget, 1000 + 600000, false);
+	power_budget_set_radio(&budget, 1000 + 900000, false);
+	power_budget_per_hour(&budget, 1000 + 1200000, &hourly);
+	failures += hourly.radio_on != 1800 || hourly.radio_asleep != 1800;
+
+	// Back on for the last half hour, and 6 minutes of CPU time
+	power_budget_set_radio(&budget, 1000 + 1800000, true);
+	power_budget_set_radio(&budget, 1000 + 2400000, true);
+	power_budget_add_cpu_time(&budget, 300000000);
+	power_budget_add_cpu_time(&budget, 60000000);
+	power_budget_per_hour(&budget, 1000 + 3600000, &hourly);
+	failures += hourly.radio_on != 2400 || hourly.radio_asleep != 1200 ||
+	            hourly.cpu_active != 360;
+
+	// Times which don't divide evenly still add up to an hour
+	power_budget_init(&budget, 0);
+	for (unsigned long now = 1; now < 100000; now += 997) {
+		power_budget_set_radio(&budget, now, (now / 997) % 3 == 0);
+		power_budget_per_hour(&budget, now + 1, &hourly);
+		failures += hourly.radio_on + hourly.radio_asleep != 3600;
+	}
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// DNS
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Check DNS queries are encoded correctly and that responses (reached through a
+ * compressed CNAME) are decoded. Returns the number of failures.
+ */
+static size_t check_dns_message(void) {
+	static const uint8_t expected_query[] = {
+		0x12, 0x34, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		3, 'a', 'p', 'i', 4, 't', 'f', 'g', 'm', 3, 'c', 'o', 'm', 0,
+		0x00, 0x01, 0x00, 0x01,
+	};
+	uint8_t query[DNS_MESSAGE_MAX_SIZE];
+	size_t failures = 0;
+	size_t length = dns_message_build_query(query, sizeof(query), 0x1234, "api.tfgm.com");
+	failures += length != sizeof(expected_query) ||
+	            memcmp(query, expected_query, length) != 0;
+	failures += dns_message_build_query(query, 20, 0x1234, "api.tfgm.com") != 0;
+	failures += dns_message_build_query(query, sizeof(query), 0x1234, "api..com") != 0;
+
+	static const uint8_t response[] = {
+		0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+		3, 'a', 'p', 'i', 4, 't', 'f', 'g', 'm', 3, 'c', 'o', 'm', 0,
+		0x00, 0x01, 0x00, 0x01,
+		// api.tfgm.com CNAME gw.tfgm.com, TTL 300
+		0xC0, 0x0C, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x01, 0x2C, 0x00, 0x05,
+		2, 'g', 'w', 0xC0, 0x10,
+		// gw.tfgm.com A 192.0.2.7, TTL 60
+		0xC0, 0x2A, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x3C, 0x00, 0x04,
+		192, 0, 2, 7,
+	};
+	uint32_t address = 0;
+	uint32_t ttl = 0;
+	static const uint8_t expected_address[] = {192, 0, 2, 7};
+	failures += dns_message_parse_response(response, sizeof(response), 0x1234,
+	                                       &address, &ttl) != DNS_MESSAGE_OK;
+	failures += memcmp(&address, expected_address, 4) != 0 || ttl != 60;
+	failures += dns_message_parse_response(response, sizeof(response), 0x1235,
+	                                       &address, &ttl) != DNS_MESSAGE_MISMATCH;
+	failures += dns_message_parse_response(response, sizeof(response) - 1, 0x1234,
+	                                       &address, &ttl) != DNS_MESSAGE_MALFORMED;
+
+	// NXDOMAIN
+	uint8_t error[sizeof(response)];
+	memcpy(error, response, sizeof(error));
+	error[3] = 0x83;
+	failures += dns_message_parse_response(error, sizeof(error), 0x1234,
+	                                       &address, &ttl) != DNS_MESSAGE_NO_ADDRESS;
+	return failures;
+}
+
+/**
+ * Check cached addresses expire after their (clamped) TTL and are refreshed
+ * beforehand. Returns the number of failures.
+ */
+static size_t check_dns_cache(void) {
+	dns_cache_t cache;
+	dns_cache_init(&cache);
+	uint32_t address = 0;
+	size_t failures = dns_cache_get(&cache, 0, &address) != DNS_CACHE_EMPTY;
+	failures += dns_cache_refresh_due(&cache, 0);
+
+	unsigned long start = 0xFFFFF000ul;
+	dns_cache_store(&cache, start, 42, 100);
+	failures += dns_cache_get(&cache, start + 74999, &address) != DNS_CACHE_FRESH || address != 42;
+	failures += dns_cache_refresh_due(&cache, start + 74999);
+	failures += !dns_cache_refresh_due(&cache, start + 75000);
+	failures += dns_cache_get(&cache, start + 99999, &address) != DNS_CACHE_FRESH;
+	failures += dns_cache_get(&cache, start + 100000, &address) != DNS_CACHE_STALE || address != 42;
+
+	dns_cache_store(&cache, 0, 43, 0);
+	failures += dns_cache_get(&cache, DNS_CACHE_MIN_TTL * 1000 - 1, &address) != DNS_CACHE_FRESH;
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Decompression
+////////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+	uint8_t data[INFLATE_WINDOW_SIZE * 2];
+	size_t length;
+	bool overflow;
+} inflate_output_t;
+
+static void collect_inflate_output(const char *data, size_t length, void *cb_data) {
+	inflate_output_t *output = (inflate_output_t *)cb_data;
+	if (output->length + length > sizeof(output->data)) {
+		output->overflow = true;
+		return;
+	}
+	memcpy(output->data + output->length, data, length);
+	output->length += length;
+}
+
+/**
+ * Decompress a whole stream fed in chunks of chunk_size bytes. Returns false if
+ * the decompressor rejected it or it was incomplete.
+ */
+static bool inflate_stream(inflate_format_t format, const uint8_t *data, size_t length,
+                           size_t chunk_size, inflate_output_t *output) {
+	static inflate_t inflate;
+	inflate_init(&inflate, format, collect_inflate_output, output);
+	output->length = 0;
+	output->overflow = false;
+	for (size_t i = 0; i < length; i += chunk_size) {
+		size_t n = std::min(chunk_size, length - i);
+		if (!inflate_feed(&inflate, (const char *)data + i, n)) {
+			return false;
+		}
+	}
+	return inflate_done(&inflate) && !output->overflow;
+}
+
+/**
+ * Writes a raw deflate stream, least significant bit first.
+ */
+typedef struct {
+	uint8_t data[INFLATE_WINDOW_SIZE + 128];
+	size_t length;
+	uint32_t bits;
+	unsigned int num_bits;
+} deflate_writer_t;
+
+static void write_bits(deflate_writer_t *writer, uint32_t value, unsigned int num_bits) {
+	writer->bits |= value << writer->num_bits;
+	writer->num_bits += num_bits;
+	while (writer->num_bits >= 8) {
+		writer->data[writer->length++] = writer->bits & 0xFF;
+		writer->bits >>= 8;
+		writer->num_bits -= 8;
+	}
+}
+
+// Huffman codes are written most significant bit first
+static void write_code(deflate_writer_t *writer, uint32_t code, unsigned int num_bits) {
+	for (unsigned int i = num_bits; i-- > 0;) {
+		write_bits(writer, (code >> i) & 1, 1);
+	}
+}
+
+/**
+ * Write a raw deflate stream of a stored block filling the window followed by
+ * a fixed Huffman block copying 3 bytes from distance (at least 5) back.
+ */
+static void write_far_reference(deflate_writer_t *writer, unsigned int distance) {
+	writer->length = 0;
+	writer->bits = 0;
+	writer->num_bits = 0;
+
+	uint16_t stored_length = INFLATE_WINDOW_SIZE + 16;
+	write_bits(writer, 0, 3);
+	write_bits(writer, 0, 5);
+	write_bits(writer, stored_length, 16);
+	write_bits(writer, (uint16_t)~stored_length, 16);
+	for (size_t i = 0; i < stored_length; i++) {
+		write_bits(writer, (i * 7) % 251, 8);
+	}
+
+	write_bits(writer, 1, 1);
+	write_bits(writer, 1, 2);
+	// Length 3 (symbol 257), then the distance code (4 for 5-6, ..., 24 for
+	// 4097-6144) and its extra bits
+	write_code(writer, 257 - 256, 7);
+	unsigned int code = 4;
+	unsigned int base = 5;
+	unsigned int extra_bits = 1;
+	while (distance >= base + (1u << extra_bits)) {
+		base += 1u << extra_bits;
+		code++;
+		if (code % 2 == 0) {
+			extra_bits++;
+		}
+	}
+	write_code(writer, code, 5);
+	write_bits(writer, distance - base, extra_bits);
+	write_code(writer, 256 - 256, 7);
+	write_bits(writer, 0, 7);
+}
+
+/**
+ * Check the decompressor's handling of a small gzip stream, its check value and
+ * truncation, and of back references up to and beyond the window. Returns the
+ * number of failures.
+ */
+static size_t check_inflate(void) {
+	// "hello, hello, hello!" as compressed by gzip
+	static const uint8_t hello[] = {
+		0x1F, 0x8B, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xCB, 0x48,
+		0xCD, 0xC9, 0xC9, 0xD7, 0x51, 0xC8, 0x40, 0xA2, 0x14, 0x01, 0xA7, 0xBB,
+		0xD2, 0xFE, 0x14, 0x00, 0x00, 0x00,
+	};
+	static inflate_output_t output;
+	size_t failures = 0;
+	for (size_t chunk_size = 1; chunk_size <= sizeof(hello); chunk_size += 7) {
+		failures += !inflate_stream(INFLATE_GZIP, hello, sizeof(hello), chunk_size, &output) ||
+		            output.length != 20 || memcmp(output.data, "hello, hello, hello!", 20) != 0;
+	}
+	failures += inflate_stream(INFLATE_GZIP, hello, sizeof(hello) - 1, 1, &output);
+	uint8_t corrupt[sizeof(hello)];
+	memcpy(corrupt, hello, sizeof(hello));
+	corrupt[sizeof(corrupt) - 8] ^= 1;
+	failures += inflate_stream(INFLATE_GZIP, corrupt, sizeof(corrupt), 1, &output);
+
+	static deflate_writer_t writer;
+	write_far_reference(&writer, INFLATE_WINDOW_SIZE);
+	failures += !inflate_stream(INFLATE_DEFLATE, writer.data, writer.length, 1460, &output) ||
+	            output.length != INFLATE_WINDOW_SIZE + 19 ||
+	            memcmp(output.data + INFLATE_WINDOW_SIZE + 16, output.data + 16, 3) != 0;
+	write_far_reference(&writer, INFLATE_WINDOW_SIZE + 1);
+	failures += inflate_stream(INFLATE_DEFLATE, writer.data, writer.length, 1460, &output);
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// HTTP responses
+////////////////////////////////////////////////////////////////////////////////
+
+static void collect_response_body(const char *data, size_t length, void *cb_data) {
+	((std::string *)cb_data)->append(data, length);
+}
+
+/**
+ * Parse a response fed in chunks of chunk_size bytes, stopping once the parser
+ * consumes less than it was given. The body is collected into body. Returns the
+ * number of bytes consumed.
+ */
+static size_t parse_response(const std::string &data, size_t chunk_size,
+                             http_response_t *response, std::string *body) {
+	http_response_init(response, collect_response_body, body);
+	body->clear();
+	size_t consumed = 0;
+	while (consumed < data.size()) {
+		size_t n = std::min(chunk_size, data.size() - consumed);
+		size_t used = http_response_feed(response, data.data() + consumed, n);
+		consumed += used;
+		if (used < n) {
+			break;
+		}
+	}
+	return consumed;
+}
+
+/**
+ * Check the response parser's body framing (chunked, Content-Length with a
+ * pipelined response following, until close and none), truncation, long
+ * header lines and interim responses, fed a byte at a time and all at once.
+ * Returns the number of failures.
+ */
+static size_t check_http_response(void) {
+	static http_response_t response;
+	std::string body;
+	size_t failures = 0;
+	const size_t chunk_sizes[] = {1, SIZE_MAX};
+	for (size_t chunk_size : chunk_sizes) {
+		// Chunked, with chunk extensions and trailers
+		std::string chunked =
+			"HTTP/1.1 200 OK\r\n"
+			"Transfer-Encoding: chunked\r\n"
+			"Content-Type: Application/JSON; charset=utf-8\r\n"
+			"\r\n"
+			"5;name=value\r\nhello\r\n"
+			"7 \r\n, world\r\n"
+			"0\r\nX-Trailer: yes\r\n\r\n";
+		failures += parse_response(chunked, chunk_size, &response, &body) != chunked.size() ||
+		            !http_response_done(&response) || body != "hello, world" ||
+		            response.status != 200 || !response.keep_alive ||
+		            strcmp(response.content_type, "application/json") != 0;
+
+		// Cut short part way through a chunk
+		std::string truncated = chunked.substr(0, chunked.find("hello") + 3);
+		parse_response(truncated, chunk_size, &response, &body);
+		failures += http_response_done(&response) || http_response_error(&response);
+		http_response_closed(&response);
+		failures += !http_response_error(&response);
+
+		// Content-Length, followed by the start of the next response
+		std::string pipelined =
+			"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhelloHTTP/1.1 200 OK\r\n";
+		failures += parse_response(pipelined, chunk_size, &response, &body) !=
+		            pipelined.find("HTTP/1.1", 1) ||
+		            !http_response_done(&response) || body != "hello";
+
+		// Until the connection closes
+		std::string until_close = "HTTP/1.0 200 OK\r\n\r\nhello";
+		failures += parse_response(until_close, chunk_size, &response, &body) !=
+		            until_close.size() || http_response_done(&response);
+		http_response_closed(&response);
+		failures += !http_response_done(&response) || body != "hello" || response.keep_alive;
+
+		// No body, whatever the headers say
+		std::string no_content = "HTTP/1.1 204 No Content\r\nContent-Length: 5\r\n\r\n";
+		failures += parse_response(no_content, chunk_size, &response, &body) !=
+		            no_content.size() || !http_response_done(&response) || !body.empty();
+		std::string not_modified =
+			"HTTP/1.1 304 Not Modified\r\nTransfer-Encoding: chunked\r\n\r\n";
+		failures += parse_response(not_modified, chunk_size, &response, &body) !=
+		            not_modified.size() || !http_response_done(&response) ||
+		            response.status != 304 || !body.empty();
+
+		// Lines longer than the line buffer are truncated without disturbing
+		// the following lines
+		std::string long_lines =
+			"HTTP/1.1 200 " + std::string(HTTP_RESPONSE_MAX_LINE_LENGTH * 2, 'x') + "\r\n"
+			"X-Long: " + std::string(HTTP_RESPONSE_MAX_LINE_LENGTH * 2, 'a') + "\r\n"
+			"Content-Type: application/" +
+			std::string(HTTP_RESPONSE_MAX_LINE_LENGTH, 'b') + "\r\n"
+			"Content-Length: 5\r\n\r\nhello";
+		failures += parse_response(long_lines, chunk_size, &response, &body) !=
+		            long_lines.size() || !http_response_done(&response) ||
+		            response.status != 200 || body != "hello" ||
+		            strlen(response.content_type) != HTTP_RESPONSE_MAX_CONTENT_TYPE_LENGTH - 1 ||
+		            strncmp(response.content_type, "application/bbb", 15) != 0;
+
+		// Interim responses are skipped, along with their headers
+		std::string interim =
+			"HTTP/1.1 100 Continue\r\n\r\n"
+			"HTTP/1.1 103 Early Hints\r\n"
+			"Link: </style.css>; rel=preload\r\n"
+			"Content-Type: text/html\r\n"
+			"Content-Encoding: gzip\r\n"
+			"Transfer-Encoding: chunked\r\n\r\n"
+			"HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello";
+		failures += parse_response(interim, chunk_size, &response, &body) != interim.size() ||
+		            !http_response_done(&response) || response.status != 200 ||
+		            body != "hello" || response.content_encoding != HTTP_CONTENT_IDENTITY ||
+		            response.content_type[0] != '\0' || !response.keep_alive;
+	}
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Binary departures format
+////////////////////////////////////////////////////////////////////////////////
+
+typedef std::vector<departures_binary_record_t> binary_records_t;
+
+/**
+ * Start a body in the binary format with no records.
+ */
+static void begin_binary_body(std::vector<char> *body) {
+	const uint8_t header[DEPARTURES_BINARY_HEADER_SIZE] = {
+		'T', 'D', DEPARTURES_BINARY_VERSION,
+		METROLINK_STATIONS_CRC & 0xFF, (METROLINK_STATIONS_CRC >> 8) & 0xFF,
+		(METROLINK_STATIONS_CRC >> 16) & 0xFF, METROLINK_STATIONS_CRC >> 24,
+		0, 0,
+	};
+	body->assign(header, header + sizeof(header));
+}
+
+/**
+ * Append a record to a body in the binary format, given its station indices.
+ */
+static void append_binary_record(std::vector<char> *body, int station,
+                                 const int *destinations, const int *waits, size_t count) {
+	body->push_back(station);
+	body->push_back(count);
+	for (size_t i = 0; i < count; i++) {
+		body->push_back(destinations[i]);
+		body->push_back(std::min(std::max(waits[i], 0), 255));
+	}
+	unsigned int num_records = (uint8_t)(*body)[7] | ((uint8_t)(*body)[8] << 8);
+	num_records++;
+	(*body)[7] = num_records & 0xFF;
+	(*body)[8] = num_records >> 8;
+}
+
+/**
+ * Convert a record from the feed to the binary format's form (as the proxy
+ * does), returning false if its station isn't in the network description.
+ */
+static bool to_binary_record(const departures_record_t *record,
+                             departures_binary_record_t *binary) {
+	binary->station_index = metrolink_get_station_index(record->station_location);
+	binary->num_destinations = 0;
+	for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+		int destination = record->destinations[i].name[0]
+		                  ? metrolink_get_station_index(record->destinations[i].name) : -1;
+		if (destination >= 0) {
+			binary->destinations[binary->num_destinations].station_index = destination;
+			binary->destinations[binary->num_destinations].wait =
+				std::min(std::max(record->destinations[i].wait, 0), 255);
+			binary->num_destinations++;
+		}
+	}
+	return binary->station_index >= 0;
+}
+
+static void collect_binary_record(const departures_record_t *record, void *data) {
+	departures_binary_record_t binary;
+	if (to_binary_record(record, &binary)) {
+		((binary_records_t *)data)->push_back(binary);
+	}
+}
+
+static void collect_decoded_record(const departures_binary_record_t *record, void *data) {
+	((binary_records_t *)data)->push_back(*record);
+}
+
+/**
+ * Decode a body fed in pieces of chunk_size bytes. Returns false if it is
+ * rejected or incomplete.
+ */
+static bool decode_binary(const char *data, size_t length, size_t chunk_size,
+                          binary_records_t *records) {
+	departures_binary_t decoder;
+	departures_binary_init(&decoder, collect_decoded_record, records);
+	records->clear();
+	for (size_t i = 0; i < length; i += chunk_size) {
+		if (!departures_binary_feed(&decoder, data + i, std::min(chunk_size, length - i))) {
+			return false;
+		}
+	}
+	return departures_binary_done(&decoder);
+}
+
+static bool binary_records_equal(const binary_records_t &a, const binary_records_t &b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++) {
+		if (a[i].station_index != b[i].station_index ||
+		    a[i].num_destinations != b[i].num_destinations) {
+			return false;
+		}
+		for (size_t j = 0; j < a[i].num_destinations; j++) {
+			if (a[i].destinations[j].station_index != b[i].destinations[j].station_index ||
+			    a[i].destinations[j].wait != b[i].destinations[j].wait) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void encode_binary_record(const departures_record_t *record, void *data) {
+	departures_binary_record_t binary;
+	if (!to_binary_record(record, &binary)) {
+		return;
+	}
+	int destinations[DEPARTURES_MAX_DESTINATIONS];
+	int waits[DEPARTURES_MAX_DESTINATIONS];
+	for (size_t i = 0; i < binary.num_destinations; i++) {
+		destinations[i] = binary.destinations[i].station_index;
+		waits[i] = binary.destinations[i].wait;
+	}
+	append_binary_record((std::vector<char> *)data, binary.station_index,
+	                     destinations, waits, binary.num_destinations);
+}
+
+/**
+ * Re-encode a feed in the binary format, as the proxy would serve it.
+ */
+static void encode_binary_feed(const feed_t *feed, std::vector<char> *body) {
+	begin_binary_body(body);
+	parse_feed(feed, encode_binary_record, body);
+}
+
+/**
+ * Check a feed's binary encoding decodes to the same records as parsing the
+ * feed, whether received in single bytes or whole segments.
+ */
+static bool check_binary_feed(const feed_t *feed, const std::vector<char> &body) {
+	binary_records_t expected;
+	parse_feed(feed, collect_binary_record, &expected);
+	binary_records_t records;
+	for (size_t chunk_size = 1; chunk_size <= FEED_CHUNK_SIZE; chunk_size += FEED_CHUNK_SIZE - 1) {
+		if (!decode_binary(body.data(), body.size(), chunk_size, &records) ||
+		    !binary_records_equal(records, expected)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Check the binary decoder on a small body, with departures beyond those kept
+ * and in every way it can be malformed. Returns the number of failures.
+ */
+static size_t check_departures_binary(void) {
+	static const int destinations[] = {1, 2, 3, 4, 5, 6};
+	static const int waits[] = {5, 0, 300, 7, 8, 9};
+	std::vector<char> body;
+	begin_binary_body(&body);
+	append_binary_record(&body, 0, destinations, waits, 6);
+	append_binary_record(&body, NUM_METROLINK_STATIONS - 1, destinations, waits, 0);
+
+	binary_records_t expected(2);
+	expected[0].station_index = 0;
+	expected[0].num_destinations = std::min<size_t>(6, DEPARTURES_MAX_DESTINATIONS);
+	for (size_t i = 0; i < expected[0].num_destinations; i++) {
+		expected[0].destinations[i].station_index = destinations[i];
+		expected[0].destinations[i].wait = std::min(waits[i], 255);
+	}
+	expected[1].station_index = NUM_METROLINK_STATIONS - 1;
+	expected[1].num_destinations = 0;
+
+	binary_records_t records;
+	size_t failures = 0;
+	for (size_t chunk_size = 1; chunk_size <= body.size(); chunk_size++) {
+		failures += !decode_binary(body.data(), body.size(), chunk_size, &records) ||
+		            !binary_records_equal(records, expected);
+	}
+
+	// Corrupt the magic, version, station numbering, a station index and a
+	// destination index in turn
+	const size_t corrupt_offsets[] = {0, 2, 5, 9, 11};
+	const char corrupt_values[] = {'X', DEPARTURES_BINARY_VERSION + 1, (char)(body[5] ^ 1),
+	                               NUM_METROLINK_STATIONS, (char)0xFF};
+	for (size_t i = 0; i < sizeof(corrupt_offsets) / sizeof(corrupt_offsets[0]); i++) {
+		std::vector<char> corrupt = body;
+		corrupt[corrupt_offsets[i]] = corrupt_values[i];
+		failures += decode_binary(corrupt.data(), corrupt.size(), 1, &records);
+	}
+	// Truncated, and with data after the last record
+	failures += decode_binary(body.data(), body.size() - 1, 1, &records);
+	body.push_back(0);
+	failures += decode_binary(body.data(), body.size(), 1, &records);
+
+	// No records at all
+	begin_binary_body(&body);
+	failures += !decode_binary(body.data(), body.size(), 1, &records) || !records.empty();
+	return failures;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Configuration journal
+////////////////////////////////////////////////////////////////////////////////
+
+// Flash sectors emulated in RAM
+static uint32_t config_sectors[CONFIG_JOURNAL_NUM_SECTORS][4096 / 4];
+
+// Flash operations left before the power is cut (negative for no cut). The
+// write in progress when the power is cut is torn: only half of it is written.
+static long flash_operations_left = -1;
+
+/**
+ * Count a flash operation. Returns false if the power has been cut.
+ */
+static bool flash_operation(void) {
+	if (flash_operations_left == 0) {
+		return false;
+	}
+	if (flash_operations_left > 0) {
+		flash_operations_left--;
+	}
+	return true;
+}
+
+static bool ram_flash_read(unsigned int sector, uint32_t offset, uint32_t *data, size_t length) {
+	if (flash_operations_left == 0) {
+		return false;
+	}
+	memcpy(data, (const uint8_t *)config_sectors[sector] + offset, length);
+	return true;
+}
+
+static bool ram_flash_write(unsigned int sector, uint32_t offset, const uint32_t *data,
+                            size_t length) {
+	bool powered = flash_operation();
+	if (!powered) {
+		length = (length / 2) & ~(size_t)3;
+	}
+	// Writes can only clear bits
+	for (size_t i = 0; i < length; i++) {
+		((uint8_t *)config_sectors[sector])[offset + i] &= ((const uint8_t *)data)[i];
+	}
+	return powered;
+}
+
+static bool ram_flash_erase(unsigned int sector) {
+	if (!flash_operation()) {
+		return false;
+	}
+	memset(config_sectors[sector], 0xFF, sizeof(config_sectors[sector]));
+	return true;
+}
+
+static const config_journal_flash_t RAM_FLASH = {
+	ram_flash_read, ram_flash_write, ram_flash_erase, sizeof(config_sectors[0]),
+};
+
+// Mirrors the firmware's configuration
+typedef struct {
+	int display_pwm_values[DISPLAY_MAX_VALUE + 1];
+	char wifi_ssid[32];
+	char wifi_password[64];
+	char tfgm_api_key[64];
+	struct {
+		char station_start[32];
+		char station_end[32];
+	} journeys[4];
+} bench_config_t;
+
+static const config_journal_field_t BENCH_CONFIG_FIELDS[] = {
+	{1, offsetof(bench_config_t, display_pwm_values), sizeof(int) * (DISPLAY_MAX_VALUE + 1)},
+	{2, offsetof(bench_config_t, wifi_ssid), 32},
+	{3, offsetof(bench_config_t, wifi_password), 64},
+	{4, offsetof(bench_config_t, tfgm_api_key), 64},
+	{5, offsetof(bench_config_t, journeys[0]), 64},
+	{6, offsetof(bench_config_t, journeys[1]), 64},
+	{7, offsetof(bench_config_t, journeys[2]), 64},
+	{8, offsetof(bench_config_t, journeys[3]), 64},
+};
+
+static config_journal_t bench_journal;
+
+/**
+ * Write a journal containing an initial configuration followed by a series of
+ * edits, then check it loads back correctly. Returns false on mismatch.
+ */
+static bool build_config_journal(size_t num_edits) {
+	config_journal_init(&bench_journal, &RAM_FLASH, BENCH_CONFIG_FIELDS,
+	                    sizeof(BENCH_CONFIG_FIELDS) / sizeof(BENCH_CONFIG_FIELDS[0]), 1);
+
+	bench_config_t config, previous;
+	memset(&config, 0, sizeof(config));
+	for (unsigned int sector = 0; sector < CONFIG_JOURNAL_NUM_SECTORS; sector++) {
+		ram_flash_erase(sector);
+	}
+	config_journal_format(&bench_journal, &config);
+	for (size_t i = 0; i < num_edits; i++) {
+		previous = config;
+		snprintf(config.journeys[i % 4].station_start, 32, "Station %zu", i);
+		config.display_pwm_values[i % (DISPLAY_MAX_VALUE + 1)] = i;
+		config_journal_save(&bench_journal, &config, &previous);
+	}
+
+	bench_config_t loaded;
+	memset(&loaded, 0, sizeof(loaded));
+	return config_journal_load(&bench_journal, &loaded) &&
+	       memcmp(&loaded, &config, sizeof(config)) == 0;
+}
+
+/**
+ * Load the journal afresh, as at boot. Returns false if there isn't one.
+ */
+static bool reload_config_journal(config_journal_t *journal, bench_config_t *config) {
+	config_journal_init(journal, &RAM_FLASH, BENCH_CONFIG_FIELDS,
+	                    sizeof(BENCH_CONFIG_FIELDS) / sizeof(BENCH_CONFIG_FIELDS[0]), 1);
+	memset(config, 0, sizeof(*config));
+	return config_journal_load(journal, config);
+}
+
+/**
+ * Cut the power at every point of a series of compactions and check that,
+ * after each cut, either the configuration before the compaction or the one
+ * being written loads back. Returns the number of failures.
+ */
+static size_t check_config_journal_power_cuts(void) {
+	size_t failures = 0;
+	bench_config_t before, after, loaded;
+	config_journal_t journal;
+	memset(&before, 0, sizeof(before));
+	strcpy(before.wifi_ssid, "Before");
+	for (unsigned int sector = 0; sector < CONFIG_JOURNAL_NUM_SECTORS; sector++) {
+		ram_flash_erase(sector);
+	}
+	reload_config_journal(&journal, &loaded);
+	config_journal_format(&journal, &before);
+
+	// Compact back and forth between the sectors, and also after a retired
+	// sector has been reused
+	for (int i = 0; i < 3; i++) {
+		after = before;
+		snprintf(after.wifi_ssid, sizeof(after.wifi_ssid), "After %d", i);
+		bool compacted = false;
+		for (long operations = 0; !compacted; operations++) {
+			reload_config_journal(&journal, &loaded);
+			flash_operations_left = operations;
+			compacted = config_journal_format(&journal, &after);
+			flash_operations_left = -1;
+
+			if (!reload_config_journal(&journal, &loaded)) {
+				failures++;
+			} else if (compacted) {
+				failures += memcmp(&loaded, &after, sizeof(loaded)) != 0;
+			} else {
+				failures += memcmp(&loaded, &before, sizeof(loaded)) != 0 &&
+				            memcmp(&loaded, &after, sizeof(loaded)) != 0;
+				// Carry on from whichever was loaded
+				before = loaded;
+			}
+		}
+		before = after;
+	}
+
+	// Saves after compactions append to the new journal
+	after.tfgm_api_key[0] = 'K';
+	failures += !config_journal_save(&journal, &after, &before);
+	failures += !reload_config_journal(&journal, &loaded) ||
+	            memcmp(&loaded, &after, sizeof(loaded)) != 0;
+	return failures;
+}
+
+static void bench_config_journal_load(void *data) {
+	(void)data;
+	static bench_config_t config;
+	config_journal_load(&bench_journal, &config);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+////////////////////////////////////////////////////////////////////////////////
+
+// Journey used by the destination validity and feed parsing benchmarks
+static const char *JOURNEY_START = "Piccadilly";
+static const char *JOURNEY_TARGET = "Altrincham";
+static metrolink_journey_t journey;
+
+static void bench_set_journey_all_pairs(void *data) {
+	(void)data;
+	metrolink_journey_t journey;
+	for (size_t start = 0; start < NUM_METROLINK_STATIONS; start++) {
+		for (size_t target = 0; target < NUM_METROLINK_STATIONS; target++) {
+			metrolink_set_journey(&journey, station_names[start],
+			                      station_names[target]);
+		}
+	}
+}
+
+static volatile size_t sink;
+
+static void bench_station_names_equal(void *data) {
+	(void)data;
+	size_t matches = 0;
+	for (size_t i = 0; i < num_feed_names; i++) {
+		for (size_t j = 0; j < NUM_METROLINK_STATIONS; j++) {
+			matches += metrolink_station_names_equal(feed_names[i],
+			                                         station_names[j]);
+		}
+	}
+	sink = matches;
+}
+
+static void bench_is_destination_valid(void *data) {
+	(void)data;
+	size_t valid = 0;
+	for (size_t i = 0; i < num_feed_names; i++) {
+		valid += metrolink_is_destination_valid(&journey, feed_names[i]);
+	}
+	sink = valid;
+}
+
+static void bench_network_dfs(void *data) {
+	(void)data;
+	bool visited[256] = {false};
+	bool reached[256] = {false};
+	for (size_t start = 0; start < NUM_METROLINK_STATIONS; start++) {
+		reference_visit(visited, reached, start, start, false);
+	}
+	sink = reached[0];
+}
+
+// Mirrors the firmware's process_record (for a single journey)
+static void process_record(const departures_record_t *record, void *data) {
+	int *min_wait = (int *)data;
+
+	if (metrolink_get_station_index(record->station_location) != journey.start_index) {
+		return;
+	}
+
+	for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+		if (record->destinations[i].name[0] &&
+		    (record->destinations[i].wait < *min_wait || *min_wait == -1) &&
+		    metrolink_is_destination_valid(&journey, record->destinations[i].name)) {
+			*min_wait = record->destinations[i].wait;
+		}
+	}
+}
+
+static void bench_parse_feed(void *data) {
+	int min_wait = -1;
+	parse_feed((const feed_t *)data, process_record, &min_wait);
+	sink = min_wait;
+}
+
+static void bench_reference_parse_feed(void *data) {
+	const feed_t *feed = (const feed_t *)data;
+	reference_journey = &journey;
+	sink = reference_parse_feed(feed->data, feed->length);
+}
+
+// Mirrors the firmware's process_binary_record (for a single journey)
+static void process_binary_record(const departures_binary_record_t *record, void *data) {
+	int *min_wait = (int *)data;
+
+	if (record->station_index != journey.start_index) {
+		return;
+	}
+
+	for (size_t i = 0; i < record->num_destinations; i++) {
+		if ((record->destinations[i].wait < *min_wait || *min_wait == -1) &&
+		    metrolink_is_destination_index_valid(&journey, record->destinations[i].station_index)) {
+			*min_wait = record->destinations[i].wait;
+		}
+	}
+}
+
+static void bench_decode_binary_feed(void *data) {
+	const std::vector<char> *body = (const std::vector<char> *)data;
+	int min_wait = -1;
+	departures_binary_t decoder;
+	departures_binary_init(&decoder, process_binary_record, &min_wait);
+	for (size_t i = 0; i < body->size(); i += FEED_CHUNK_SIZE) {
+		departures_binary_feed(&decoder, body->data() + i,
+		                       std::min(FEED_CHUNK_SIZE, body->size() - i));
+	}
+	sink = min_wait;
+}
+
+/**
+ * A feed and the same feed compressed with gzip (e.g. by tools/feed_server.py).
+ */
+typedef struct {
+	const feed_t *feed;
+	feed_t compressed;
+
+	// Bytes of the decompressed output matching the feed so far
+	size_t matched;
+	bool mismatch;
+
+	departures_parser_t parser;
+	int min_wait;
+} compressed_feed_t;
+
+static void match_inflated_feed(const char *data, size_t length, void *cb_data) {
+	compressed_feed_t *feed = (compressed_feed_t *)cb_data;
+	if (feed->matched + length > feed->feed->length ||
+	    memcmp(feed->feed->data + feed->matched, data, length) != 0) {
+		feed->mismatch = true;
+		return;
+	}
+	feed->matched += length;
+}
+
+static void parse_inflated_feed(const char *data, size_t length, void *cb_data) {
+	compressed_feed_t *feed = (compressed_feed_t *)cb_data;
+	departures_parser_feed(&feed->parser, data, length);
+}
+
+static bool inflate_feed_chunks(compressed_feed_t *feed, inflate_output_callback_t callback,
+                                size_t chunk_size) {
+	static inflate_t inflate;
+	inflate_init(&inflate, INFLATE_GZIP, callback, feed);
+	const feed_t *compressed = &feed->compressed;
+	for (size_t i = 0; i < compressed->length; i += chunk_size) {
+		size_t length = std::min(chunk_size, compressed->length - i);
+		if (!inflate_feed(&inflate, compressed->data + i, length)) {
+			return false;
+		}
+	}
+	return inflate_done(&inflate);
+}
+
+/**
+ * Check the compressed feed decompresses to the feed, whether received in
+ * single bytes or whole segments.
+ */
+static bool check_compressed_feed(compressed_feed_t *feed) {
+	for (size_t chunk_size = 1; chunk_size <= FEED_CHUNK_SIZE; chunk_size += FEED_CHUNK_SIZE - 1) {
+		feed->matched = 0;
+		feed->mismatch = false;
+		if (!inflate_feed_chunks(feed, match_inflated_feed, chunk_size) ||
+		    feed->mismatch || feed->matched != feed->feed->length) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void bench_inflate_feed(void *data) {
+	compressed_feed_t *feed = (compressed_feed_t *)data;
+	feed->matched = 0;
+	inflate_feed_chunks(feed, match_inflated_feed, FEED_CHUNK_SIZE);
+	sink = feed->matched;
+}
+
+static void bench_inflate_parse_feed(void *data) {
+	compressed_feed_t *feed = (compressed_feed_t *)data;
+	feed->min_wait = -1;
+	departures_parser_init(&feed->parser, process_record, &feed->min_wait);
+	inflate_feed_chunks(feed, parse_inflated_feed, FEED_CHUNK_SIZE);
+	sink = feed->min_wait;
+}
+
+/**
+ * Count down from 7 minutes until the needle has been wobbling for a while.
+ */
+static void bench_display_update(void *data) {
+	display_t *display = (display_t *)data;
+	display_show_wait(display, 7, 0);
+	int total = 0;
+	for (size_t i = 0; i < DISPLAY_SCENARIO_UPDATES; i++) {
+		total += display_update(display);
+	}
+	sink = total;
+}
+
+static void bench_reference_display_update(void *data) {
+	(void)data;
+	reference_display_t reference = {7.0, false, true, 7, 0.0, DISPLAY_PWM_VALUES};
+	int total = 0;
+	for (size_t i = 0; i < DISPLAY_SCENARIO_UPDATES; i++) {
+		total += reference_display_update(&reference);
+	}
+	sink = total;
+}
+
+static void bench_display_set_calibration(void *data) {
+	(void)data;
+	static display_t display;
+	display_set_calibration(&display, DISPLAY_PWM_VALUES);
+	sink = display.curve[DISPLAY_CURVE_LENGTH / 2];
+}
+
+int main(int argc, char *argv[]) {
+	static const char *default_feeds[] = {"bench/feed.json"};
+	const char **filenames = default_feeds;
+	size_t num_feeds = 1;
+	if (argc > 1) {
+		filenames = (const char **)argv + 1;
+		num_feeds = argc - 1;
+	}
+
+	metrolink_init();
+
+	if (check_departures_requests() != 0) {
+		fprintf(stderr, "Filtered requests are built or handled incorrectly!\n");
+		return 1;
+	}
+
+	if (check_journeys() != 0) {
+		fprintf(stderr, "Journey tables do not match reference route finding!\n");
+		return 1;
+	}
+
+	size_t num_transitions_differing;
+	int max_pwm_difference = check_display(&num_transitions_differing);
+	printf("display trajectory: max difference %d PWM steps "
+	       "(%zu countdowns ran out one update apart)\n",
+	       max_pwm_difference, num_transitions_differing);
+	if (max_pwm_difference > 1) {
+		fprintf(stderr, "Needle trajectory differs from reference!\n");
+		return 1;
+	}
+
+	if (check_display_advance() != 0) {
+		fprintf(stderr, "Restored display state differs from continuous updates!\n");
+		return 1;
+	}
+
+	if (check_perf_histogram() != 0) {
+		fprintf(stderr, "Histogram percentiles are wrong!\n");
+		return 1;
+	}
+
+	if (check_metrics_writer() != 0) {
+		fprintf(stderr, "Metrics are rendered incorrectly!\n");
+		return 1;
+	}
+
+	if (check_scheduler() != 0) {
+		fprintf(stderr, "Polls are scheduled incorrectly!\n");
+		return 1;
+	}
+
+	if (check_power_budget() != 0) {
+		fprintf(stderr, "Power budget is measured incorrectly!\n");
+		return 1;
+	}
+
+	if (check_dns_message() != 0 || check_dns_cache() != 0) {
+		fprintf(stderr, "DNS messages or cache are handled incorrectly!\n");
+		return 1;
+	}
+
+	if (check_inflate() != 0) {
+		fprintf(stderr, "Decompression is incorrect!\n");
+		return 1;
+	}
+
+	if (check_http_response() != 0) {
+		fprintf(stderr, "HTTP responses are parsed incorrectly!\n");
+		return 1;
+	}
+
+	if (check_departures_binary() != 0) {
+		fprintf(stderr, "Binary departures are decoded incorrectly!\n");
+		return 1;
+	}
+
+	if (!build_config_journal(1000) || !build_config_journal(20) ||
+	    check_config_journal_power_cuts() != 0) {
+		fprintf(stderr, "Configuration journal did not load back correctly!\n");
+		return 1;
+	}
+
+	const int *calibrations[] = {DISPLAY_PWM_VALUES, GLITCHY_PWM_VALUES, LINEAR_PWM_VALUES};
+	for (size_t i = 0; i < sizeof(calibrations) / sizeof(calibrations[0]); i++) {
+		int max_deviation;
+		if (check_calibration_curve(calibrations[i], &max_deviation) != 0) {
+			fprintf(stderr, "Calibration curve %zu overshoots its points!\n", i);
+			return 1;
+		}
+		printf("calibration curve %zu: max difference from linear %d PWM steps\n",
+		       i, max_deviation);
+	}
+
+	feed_t *feeds = (feed_t *)calloc(num_feeds, sizeof(feed_t));
+	for (size_t i = 0; i < num_feeds; i++) {
+		if (!load_feed(&feeds[i], filenames[i])) {
+			fprintf(stderr, "Could not read feed '%s'.\n", filenames[i]);
+			return 1;
+		}
+		parse_feed(&feeds[i], collect_feed_names, NULL);
+	}
+
+	run_benchmark("metrolink_set_journey (all pairs)",
+	              NUM_METROLINK_STATIONS * NUM_METROLINK_STATIONS,
+	              bench_set_journey_all_pairs, NULL);
+
+	run_benchmark("metrolink_station_names_equal",
+	              num_feed_names * NUM_METROLINK_STATIONS,
+	              bench_station_names_equal, NULL);
+
+	metrolink_set_journey(&journey, JOURNEY_START, JOURNEY_TARGET);
+	run_benchmark("metrolink_is_destination_valid",
+	              num_feed_names,
+	              bench_is_destination_valid, NULL);
+
+	run_benchmark("network DFS (CSR, per start station)",
+	              NUM_METROLINK_STATIONS,
+	              bench_network_dfs, NULL);
+
+	static display_t display;
+	display_init(&display, DISPLAY_PWM_VALUES);
+	run_benchmark("display_update (fixed point)", DISPLAY_SCENARIO_UPDATES,
+	              bench_display_update, &display);
+	run_benchmark("display_update (original float)", DISPLAY_SCENARIO_UPDATES,
+	              bench_reference_display_update, NULL);
+	run_benchmark("display_set_calibration", 1,
+	              bench_display_set_calibration, NULL);
+
+	char name[64];
+	snprintf(name, sizeof(name), "config_journal_load (%u records)",
+	         bench_journal.num_records);
+	run_benchmark(name, 1, bench_config_journal_load, NULL);
+
+	metrolink_cache_stats_t cache_stats_before;
+	metrolink_get_cache_stats(&cache_stats_before);
+	for (size_t i = 0; i < num_feeds; i++) {
+		char name[64];
+		snprintf(name, sizeof(name), "parse %s", feeds[i].filename);
+		double ns = run_benchmark(name, 1, bench_parse_feed, &feeds[i]);
+		printf("%-40s %14.1f MB/s, peak heap %zu bytes\n", "", (feeds[i].length / ns) * 1e3,
+		       measure_peak_heap(bench_parse_feed, &feeds[i]));
+
+		// The jsmn parsing it replaced, which must find the same wait
+		int min_wait = -1;
+		parse_feed(&feeds[i], process_record, &min_wait);
+		reference_journey = &journey;
+		if (reference_parse_feed(feeds[i].data, feeds[i].length) != min_wait) {
+			fprintf(stderr, "Streaming and jsmn parsers disagree on '%s'!\n",
+			        feeds[i].filename);
+			return 1;
+		}
+		snprintf(name, sizeof(name), "parse %s (original jsmn)", feeds[i].filename);
+		ns = run_benchmark(name, 1, bench_reference_parse_feed, &feeds[i]);
+		printf("%-40s %14.1f MB/s, peak heap %zu bytes\n", "", (feeds[i].length / ns) * 1e3,
+		       measure_peak_heap(bench_reference_parse_feed, &feeds[i]));
+
+		// The same departures in the binary format
+		std::vector<char> body;
+		encode_binary_feed(&feeds[i], &body);
+		if (!check_binary_feed(&feeds[i], body)) {
+			fprintf(stderr, "Binary encoding of '%s' decodes differently!\n",
+			        feeds[i].filename);
+			return 1;
+		}
+		snprintf(name, sizeof(name), "decode %s as binary", feeds[i].filename);
+		run_benchmark(name, 1, bench_decode_binary_feed, &body);
+		printf("%-40s %14zu bytes (JSON %zu bytes)\n", "", body.size(), feeds[i].length);
+	}
+
+	// Compressed copies of the feeds, if present alongside them
+	for (size_t i = 0; i < num_feeds; i++) {
+		static compressed_feed_t compressed;
+		char filename[256];
+		snprintf(filename, sizeof(filename), "%s.gz", feeds[i].filename);
+		compressed.feed = &feeds[i];
+		if (!load_feed(&compressed.compressed, filename)) {
+			continue;
+		}
+		if (!check_compressed_feed(&compressed)) {
+			fprintf(stderr, "'%s' does not decompress to '%s'!\n",
+			        filename, feeds[i].filename);
+			return 1;
+		}
+
+		char name[sizeof(filename) + 32];
+		snprintf(name, sizeof(name), "inflate %s", filename);
+		double ns = run_benchmark(name, 1, bench_inflate_feed, &compressed);
+		printf("%-40s %14.1f MB/s out, %zu -> %zu bytes\n", "",
+		       (feeds[i].length / ns) * 1e3, compressed.compressed.length, feeds[i].length);
+		snprintf(name, sizeof(name), "inflate and parse %s", filename);
+		run_benchmark(name, 1, bench_inflate_parse_feed, &compressed);
+	}
+
+	metrolink_cache_stats_t cache_stats;
+	metrolink_get_cache_stats(&cache_stats);
+	printf("destination cache while parsing: %lu hits, %lu misses\n",
+	       cache_stats.hits - cache_stats_before.hits,
+	       cache_stats.misses - cache_stats_before.misses);
+
+	return 0;
+}
@@ -0,0 +1,35 @@
+#ifndef ARDUINO_SHIM_H
+#define ARDUINO_SHIM_H
+
+/**
+ * A minimal stand-in for the Arduino core used when building the
+ * platform-independent parts of the firmware for the host (the 'native'
+ * PlatformIO environment). Only what those modules need is provided.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+static inline unsigned long micros() {
+	using namespace std::chrono;
+	static const steady_clock::time_point start = steady_clock::now();
+	return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+static inline unsigned long millis() {
+	return micros() / 1000;
+}
+
+static inline void delay(unsigned long ms) {
+	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static inline void yield() {
+	std::this_thread::yield();
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef PGMSPACE_SHIM_H
+#define PGMSPACE_SHIM_H
+
+/**
+ * Host stand-in for the ESP8266 core's pgmspace.h: flash-resident data is just
+ * ordinary constant data.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+
+#define strcmp_P strcmp
+
+#endif
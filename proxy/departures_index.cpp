@@ -0,0 +1,197 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "departures_index.h"
+#include "metrolink.h"
+
+void departures_index_init(departures_index_t *index) {
+	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
+		index->records[i].clear();
+		index->binary_records[i].clear();
+		index->num_binary_records[i] = 0;
+	}
+	index->unknown_records.clear();
+	index->num_records = 0;
+	index->feed_bytes = 0;
+}
+
+/**
+ * Append a JSON string literal.
+ */
+static void append_json_string(std::string *out, const char *str) {
+	out->push_back('"');
+	for (const unsigned char *c = (const unsigned char *)str; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			out->push_back('\\');
+			out->push_back(*c);
+		} else if (*c < 0x20) {
+			char escape[8];
+			snprintf(escape, sizeof(escape), "\\u%04x", *c);
+			out->append(escape);
+		} else {
+			out->push_back(*c);
+		}
+	}
+	out->push_back('"');
+}
+
+/**
+ * Add a record at a known station to the binary records.
+ */
+static void add_binary_record(departures_index_t *index, int station,
+                              const departures_record_t *record) {
+	// Destinations missing from the network description are left out: they
+	// can't be any journey's destination
+	uint8_t departures[2 * DEPARTURES_MAX_DESTINATIONS];
+	size_t count = 0;
+	for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+		int destination = record->destinations[i].name[0]
+		                  ? metrolink_get_station_index(record->destinations[i].name) : -1;
+		if (destination < 0) {
+			continue;
+		}
+		int wait = record->destinations[i].wait;
+		departures[2 * count] = destination;
+		departures[2 * count + 1] = wait < 0 ? 0 : wait > 255 ? 255 : wait;
+		count++;
+	}
+
+	std::string *records = &index->binary_records[station];
+	records->push_back((char)station);
+	records->push_back((char)count);
+	records->append((const char *)departures, 2 * count);
+	index->num_binary_records[station]++;
+}
+
+void departures_index_add(const departures_record_t *record, void *data) {
+	departures_index_t *index = (departures_index_t *)data;
+
+	int station = metrolink_get_station_index(record->station_location);
+	std::string *records = station < 0 ? &index->unknown_records : &index->records[station];
+	if (!records->empty()) {
+		records->push_back(',');
+	}
+
+	// Empty destinations are left out: the firmware treats missing and empty
+	// fields alike. Waits are strings, as in the feed.
+	records->append("{\"StationLocation\":");
+	append_json_string(records, record->station_location);
+	for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+		if (!record->destinations[i].name[0]) {
+			continue;
+		}
+		char field[32];
+		snprintf(field, sizeof(field), ",\"Dest%u\":", (unsigned)i);
+		records->append(field);
+		append_json_string(records, record->destinations[i].name);
+		snprintf(field, sizeof(field), ",\"Wait%u\":\"%d\"",
+		         (unsigned)i, record->destinations[i].wait);
+		records->append(field);
+	}
+	records->push_back('}');
+
+	index->num_records++;
+	if (station >= 0) {
+		add_binary_record(index, station, record);
+	}
+}
+
+/**
+ * Builds a response body from the records of one station after another.
+ */
+typedef struct {
+	const departures_index_t *index;
+	departures_index_format_t format;
+	std::string *body;
+
+	// Has no JSON record been written yet? And the number of binary records
+	// written.
+	bool first;
+	size_t num_records;
+} renderer_t;
+
+static void render_begin(renderer_t *renderer, const departures_index_t *index,
+                         departures_index_format_t format, std::string *body) {
+	renderer->index = index;
+	renderer->format = format;
+	renderer->body = body;
+	renderer->first = true;
+	renderer->num_records = 0;
+
+	if (format == DEPARTURES_INDEX_JSON) {
+		body->assign("{\"value\":[");
+		return;
+	}
+	// The record count is filled in by render_end
+	const uint8_t header[DEPARTURES_BINARY_HEADER_SIZE] = {
+		'T', 'D', DEPARTURES_BINARY_VERSION,
+		METROLINK_STATIONS_CRC & 0xFF, (METROLINK_STATIONS_CRC >> 8) & 0xFF,
+		(METROLINK_STATIONS_CRC >> 16) & 0xFF, METROLINK_STATIONS_CRC >> 24,
+		0, 0,
+	};
+	body->assign((const char *)header, sizeof(header));
+}
+
+/**
+ * Append comma separated JSON records to the body.
+ */
+static void render_json(renderer_t *renderer, const std::string &records) {
+	if (records.empty()) {
+		return;
+	}
+	if (!renderer->first) {
+		renderer->body->push_back(',');
+	}
+	renderer->body->append(records);
+	renderer->first = false;
+}
+
+static void render_station(renderer_t *renderer, int station) {
+	if (renderer->format == DEPARTURES_INDEX_JSON) {
+		render_json(renderer, renderer->index->records[station]);
+	} else if (renderer->num_records + renderer->index->num_binary_records[station] <= 0xFFFF) {
+		renderer->body->append(renderer->index->binary_records[station]);
+		renderer->num_records += renderer->index->num_binary_records[station];
+	}
+}
+
+static void render_end(renderer_t *renderer) {
+	if (renderer->format == DEPARTURES_INDEX_JSON) {
+		renderer->body->append("]}");
+	} else {
+		(*renderer->body)[DEPARTURES_BINARY_HEADER_SIZE - 2] = (char)(renderer->num_records & 0xFF);
+		(*renderer->body)[DEPARTURES_BINARY_HEADER_SIZE - 1] = (char)(renderer->num_records >> 8);
+	}
+}
+
+void departures_index_render(const departures_index_t *index,
+                             departures_index_format_t format,
+                             const int *stations, size_t num_stations,
+                             std::string *body) {
+	renderer_t renderer;
+	render_begin(&renderer, index, format, body);
+	for (size_t i = 0; i < num_stations; i++) {
+		int station = stations[i];
+		bool repeated = false;
+		for (size_t j = 0; j < i; j++) {
+			repeated |= stations[j] == station;
+		}
+		if (station >= 0 && station < NUM_METROLINK_STATIONS && !repeated) {
+			render_station(&renderer, station);
+		}
+	}
+	render_end(&renderer);
+}
+
+void departures_index_render_all(const departures_index_t *index,
+                                 departures_index_format_t format, std::string *body) {
+	renderer_t renderer;
+	render_begin(&renderer, index, format, body);
+	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
+		render_station(&renderer, i);
+	}
+	if (format == DEPARTURES_INDEX_JSON) {
+		render_json(&renderer, index->unknown_records);
+	}
+	render_end(&renderer);
+}
@@ -0,0 +1,75 @@
+#ifndef DEPARTURES_INDEX_H
+#define DEPARTURES_INDEX_H
+
+#include <stddef.h>
+
+#include <string>
+
+#include "departures.h"
+#include "departures_binary.h"
+#include "metrolink_map.h"
+
+/**
+ * The formats departures can be served in.
+ */
+typedef enum {
+	DEPARTURES_INDEX_JSON,
+	// See departures_binary.h
+	DEPARTURES_INDEX_BINARY,
+} departures_index_format_t;
+
+/**
+ * The departures feed indexed by station, ready to serve to devices. Each
+ * platform record is rendered once in each format when the index is built: as
+ * compact JSON holding only the fields the firmware uses, and in the binary
+ * format. Requests are then answered by concatenating the records of the
+ * stations asked for.
+ *
+ * Initialise with departures_index_init.
+ */
+typedef struct {
+	// Each station's records (by station index) as comma separated JSON
+	// objects, and likewise the records of stations missing from the network
+	// description (only served to unfiltered requests)
+	std::string records[NUM_METROLINK_STATIONS];
+	std::string unknown_records;
+
+	// Each station's records in the binary format, and how many there are.
+	// Records of stations missing from the network description can't be
+	// encoded.
+	std::string binary_records[NUM_METROLINK_STATIONS];
+	size_t num_binary_records[NUM_METROLINK_STATIONS];
+
+	size_t num_records;
+
+	// Size of the (decompressed) feed the index was built from
+	unsigned long feed_bytes;
+} departures_index_t;
+
+/**
+ * Empty the index.
+ */
+void departures_index_init(departures_index_t *index);
+
+/**
+ * Add a platform record to the index passed as data (a
+ * departures_record_callback_t).
+ */
+void departures_index_add(const departures_record_t *record, void *data);
+
+/**
+ * Write a response body in the given format, listing the records at the given
+ * stations (indices, where -1 or repeats are ignored) into body.
+ */
+void departures_index_render(const departures_index_t *index,
+                             departures_index_format_t format,
+                             const int *stations, size_t num_stations,
+                             std::string *body);
+
+/**
+ * Write a response body in the given format listing every record into body.
+ */
+void departures_index_render_all(const departures_index_t *index,
+                                 departures_index_format_t format, std::string *body);
+
+#endif
@@ -0,0 +1,337 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "load_test.h"
+#include "departures.h"
+#include "departures_binary.h"
+#include "http_response.h"
+#include "metrolink.h"
+#include "metrolink_map.h"
+
+// Most stations a device asks for (one per journey, as in the firmware)
+#define MAX_DEVICE_STATIONS 4
+
+// Size of the buffer used to build the request path (as in the firmware)
+static const size_t PATH_BUFFER_SIZE = 512;
+
+typedef enum {
+	// Waiting until next_request to send a request
+	DEVICE_WAITING,
+	DEVICE_CONNECTING,
+	DEVICE_SENDING,
+	DEVICE_RECEIVING,
+} device_state_t;
+
+/**
+ * A simulated device.
+ */
+typedef struct {
+	device_state_t state;
+
+	// The connection to the proxy or -1
+	int fd;
+
+	std::string request;
+	size_t request_sent;
+
+	http_response_t response;
+	departures_parser_t parser;
+	departures_binary_t binary_decoder;
+
+	// Has the body started, and is it in the binary format?
+	bool body_started;
+	bool binary;
+	bool parse_error;
+
+	// The stations asked for in the current request
+	int stations[MAX_DEVICE_STATIONS];
+	size_t num_stations;
+
+	// When the current request was sent (microseconds) and when the next one
+	// is due (milliseconds)
+	unsigned long request_start;
+	unsigned long next_request;
+
+	const load_test_config_t *config;
+	load_test_result_t *result;
+} device_t;
+
+static unsigned long now_ms(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000ul + now.tv_nsec / 1000000;
+}
+
+static unsigned long now_us(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ul + now.tv_nsec / 1000;
+}
+
+/**
+ * Count a record at the given station.
+ */
+static void count_record(device_t *device, int station) {
+	bool requested = false;
+	for (size_t i = 0; i < device->num_stations; i++) {
+		requested |= device->stations[i] == station;
+	}
+	device->result->records++;
+	if (!requested) {
+		device->result->wrong_records++;
+	}
+}
+
+static void process_record(const departures_record_t *record, void *data) {
+	count_record((device_t *)data, metrolink_get_station_index(record->station_location));
+}
+
+static void process_binary_record(const departures_binary_record_t *record, void *data) {
+	count_record((device_t *)data, record->station_index);
+}
+
+static void process_body(const char *data, size_t length, void *cb_data) {
+	device_t *device = (device_t *)cb_data;
+	if (!device->body_started) {
+		// The proxy must answer in the format asked for
+		device->body_started = true;
+		device->binary = strcmp(device->response.content_type,
+		                        DEPARTURES_BINARY_CONTENT_TYPE) == 0;
+		device->parse_error = device->binary != device->config->binary;
+	}
+	if (!device->parse_error) {
+		device->parse_error = device->binary
+		                      ? !departures_binary_feed(&device->binary_decoder, data, length)
+		                      : !departures_parser_feed(&device->parser, data, length);
+	}
+}
+
+/**
+ * Choose the stations for the next request and build it.
+ */
+static void build_request(device_t *device, const load_test_config_t *config,
+                          unsigned int *seed) {
+	char names[MAX_DEVICE_STATIONS][METROLINK_NAME_BUFFER_SIZE];
+	const char *stations[MAX_DEVICE_STATIONS];
+	device->num_stations = 1 + rand_r(seed) % MAX_DEVICE_STATIONS;
+	for (size_t i = 0; i < device->num_stations; i++) {
+		// Repeats are fine: the firmware drops them but the proxy must cope
+		device->stations[i] = rand_r(seed) % NUM_METROLINK_STATIONS;
+		metrolink_get_station_name(device->stations[i], names[i], sizeof(names[i]));
+		stations[i] = names[i];
+	}
+
+	char path[PATH_BUFFER_SIZE];
+	departures_build_request_path(path, sizeof(path), config->base_path,
+	                              stations, device->num_stations);
+	char request[PATH_BUFFER_SIZE + 256];
+	snprintf(request, sizeof(request),
+	         "GET %s HTTP/1.1\r\n"
+	         "Host: %s:%u\r\n"
+	         "User-Agent: InternetOfTrams\r\n"
+	         "%s"
+	         "Connection: keep-alive\r\n"
+	         "\r\n",
+	         path, config->address, (unsigned)config->port,
+	         config->binary
+	         ? "Accept: " DEPARTURES_BINARY_CONTENT_TYPE ", application/json;q=0.5\r\n" : "");
+	device->request = request;
+	device->request_sent = 0;
+
+	http_response_init(&device->response, process_body, device);
+	departures_parser_init(&device->parser, process_record, device);
+	departures_binary_init(&device->binary_decoder, process_binary_record, device);
+	device->body_started = false;
+	device->binary = false;
+	device->parse_error = false;
+}
+
+static void disconnect(device_t *device) {
+	if (device->fd >= 0) {
+		close(device->fd);
+		device->fd = -1;
+	}
+}
+
+/**
+ * Finish the current request and wait for the next.
+ */
+static void finish_request(device_t *device, const load_test_config_t *config, bool ok) {
+	load_test_result_t *result = device->result;
+	ok = ok && http_response_done(&device->response) &&
+	     device->response.status == 200 && !device->parse_error &&
+	     (!device->binary || departures_binary_done(&device->binary_decoder));
+	if (ok) {
+		result->requests++;
+		perf_histogram_add(&result->latency, now_us() - device->request_start);
+		perf_histogram_add(&result->body_bytes, device->response.body_length);
+	} else {
+		result->failures++;
+	}
+	if (!ok || !device->response.keep_alive) {
+		disconnect(device);
+	}
+	device->state = DEVICE_WAITING;
+	device->next_request = now_ms() + config->interval;
+}
+
+/**
+ * Begin connecting to the proxy. Returns false on failure.
+ */
+static bool start_connect(device_t *device, const load_test_config_t *config) {
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(config->port);
+	inet_pton(AF_INET, config->address, &addr.sin_addr);
+
+	device->fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	if (device->fd < 0) {
+		return false;
+	}
+	int nodelay = 1;
+	setsockopt(device->fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+	if (connect(device->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 &&
+	    errno != EINPROGRESS) {
+		disconnect(device);
+		return false;
+	}
+	device->result->connections++;
+	return true;
+}
+
+/**
+ * Handle a device's socket becoming ready.
+ */
+static void service_device(device_t *device, const load_test_config_t *config, short revents) {
+	if (device->state == DEVICE_CONNECTING) {
+		int error = 0;
+		socklen_t length = sizeof(error);
+		getsockopt(device->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+		if (error) {
+			finish_request(device, config, false);
+			return;
+		}
+		device->state = DEVICE_SENDING;
+	}
+
+	if (device->state == DEVICE_SENDING) {
+		ssize_t n = send(device->fd, device->request.data() + device->request_sent,
+		                 device->request.size() - device->request_sent, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK) {
+				finish_request(device, config, false);
+			}
+			return;
+		}
+		device->request_sent += n;
+		if (device->request_sent == device->request.size()) {
+			device->state = DEVICE_RECEIVING;
+		}
+		return;
+	}
+
+	if (device->state == DEVICE_RECEIVING && (revents & (POLLIN | POLLHUP | POLLERR))) {
+		char buf[16384];
+		ssize_t n = recv(device->fd, buf, sizeof(buf), 0);
+		if (n > 0) {
+			device->result->bytes_received += n;
+			http_response_feed(&device->response, buf, n);
+		} else if (n == 0) {
+			http_response_closed(&device->response);
+			if (!http_response_done(&device->response)) {
+				finish_request(device, config, false);
+				return;
+			}
+		} else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+			finish_request(device, config, false);
+			return;
+		}
+
+		if (http_response_error(&device->response)) {
+			finish_request(device, config, false);
+		} else if (http_response_done(&device->response)) {
+			finish_request(device, config, true);
+		}
+	}
+}
+
+void load_test_run(const load_test_config_t *config, load_test_result_t *result) {
+	memset(result, 0, sizeof(*result));
+	perf_histogram_clear(&result->latency);
+	perf_histogram_clear(&result->body_bytes);
+
+	unsigned long start = now_ms();
+	unsigned long end = start + config->duration;
+	unsigned int seed = config->seed;
+
+	// Start the devices spread across the first interval, as real devices
+	// would be
+	std::vector<device_t> devices(config->num_devices);
+	for (size_t i = 0; i < devices.size(); i++) {
+		devices[i].state = DEVICE_WAITING;
+		devices[i].fd = -1;
+		devices[i].config = config;
+		devices[i].result = result;
+		devices[i].next_request = start + (config->interval * i) / devices.size();
+	}
+
+	std::vector<struct pollfd> fds(devices.size());
+	unsigned long now;
+	while ((now = now_ms()) < end) {
+		unsigned long next_wake = end;
+		for (size_t i = 0; i < devices.size(); i++) {
+			device_t *device = &devices[i];
+			if (device->state == DEVICE_WAITING && now >= device->next_request) {
+				build_request(device, config, &seed);
+				device->request_start = now_us();
+				if (device->fd >= 0) {
+					device->state = DEVICE_SENDING;
+				} else if (start_connect(device, config)) {
+					device->state = DEVICE_CONNECTING;
+				} else {
+					finish_request(device, config, false);
+				}
+			}
+
+			if (device->state == DEVICE_WAITING) {
+				fds[i] = {-1, 0, 0};
+				if (device->next_request < next_wake) {
+					next_wake = device->next_request;
+				}
+			} else {
+				short events = device->state == DEVICE_RECEIVING ? POLLIN : POLLOUT;
+				fds[i] = {device->fd, events, 0};
+			}
+		}
+
+		int timeout = next_wake > now ? (int)(next_wake - now) : 0;
+		if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) {
+			perror("poll");
+			break;
+		}
+		for (size_t i = 0; i < devices.size(); i++) {
+			if (fds[i].fd >= 0 && fds[i].revents) {
+				service_device(&devices[i], config, fds[i].revents);
+			}
+		}
+	}
+
+	for (device_t &device : devices) {
+		disconnect(&device);
+	}
+	result->elapsed = now_ms() - start;
+}
@@ -0,0 +1,66 @@
+#ifndef LOAD_TEST_H
+#define LOAD_TEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "perf.h"
+
+/**
+ * Simulates many devices polling the proxy, each over its own keep-alive
+ * connection and asking for the departures at a few random stations just as
+ * the firmware does. The firmware's path builder, response parser and feed
+ * parser (or binary decoder) are used, so each response is checked exactly as
+ * a device would read it.
+ */
+typedef struct {
+	// The proxy's address, port and base path
+	const char *address;
+	uint16_t port;
+	const char *base_path;
+
+	size_t num_devices;
+
+	// How long to run for (milliseconds), and the delay between each device's
+	// requests (0 to send the next as soon as a response arrives)
+	unsigned long duration;
+	unsigned long interval;
+
+	// Ask for the binary format rather than JSON, as the firmware does
+	bool binary;
+
+	unsigned int seed;
+} load_test_config_t;
+
+typedef struct {
+	// Requests which got a usable response, and those which failed (errors,
+	// non-200 statuses or malformed responses)
+	unsigned long requests;
+	unsigned long failures;
+
+	// Records received in total, and those at stations which weren't asked
+	// for
+	unsigned long records;
+	unsigned long wrong_records;
+
+	// Connections made (including reconnections)
+	unsigned long connections;
+
+	// Bytes received in total, including headers
+	unsigned long long bytes_received;
+
+	// Time from sending each request to receiving the whole response
+	// (microseconds) and the size of each response body
+	perf_histogram_t latency;
+	perf_histogram_t body_bytes;
+
+	// How long the test actually ran for (milliseconds)
+	unsigned long elapsed;
+} load_test_result_t;
+
+/**
+ * Run a load test against a running proxy.
+ */
+void load_test_run(const load_test_config_t *config, load_test_result_t *result);
+
+#endif
@@ -0,0 +1,285 @@
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "load_test.h"
+#include "server.h"
+#include "upstream.h"
+
+/**
+ * TramBox proxy: polls the departures feed once and serves each device just
+ * the stations it asks for. Point the firmware at it by defining
+ * TRAMBOX_API_HOST, TRAMBOX_API_PORT and TRAMBOX_API_PLAIN_HTTP (see main.cpp
+ * in src).
+ *
+ * With --load-test, the proxy instead serves on a free local port and
+ * simulates --devices devices polling it for --duration seconds, then prints
+ * a report.
+ */
+
+static const char *DEFAULT_UPSTREAM = "https://api.tfgm.com/odata/Metrolinks";
+static const char *DEFAULT_PATH = "/odata/Metrolinks";
+
+// Number of poll intervals after which the index is too old to serve (i.e.
+// once this many polls in a row have failed)
+static const unsigned long MAX_INDEX_AGE_POLLS = 3;
+
+static std::atomic<bool> stop(false);
+
+typedef struct {
+	const char *upstream_url;
+	const char *api_key;
+	const char *address;
+	uint16_t port;
+	const char *path;
+	unsigned long poll_interval;
+
+	bool load_test;
+	size_t devices;
+	unsigned long duration;
+	unsigned long device_interval;
+	bool binary;
+} options_t;
+
+static void handle_signal(int signal) {
+	(void)signal;
+	stop = true;
+}
+
+static void log_time(void) {
+	char buf[32];
+	time_t now = time(NULL);
+	strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", localtime(&now));
+	printf("[%s] ", buf);
+}
+
+/**
+ * Fetch the feed once and publish the new index. Returns true on success.
+ */
+static bool poll_upstream(upstream_t *upstream, server_t *server) {
+	std::shared_ptr<departures_index_t> index = std::make_shared<departures_index_t>();
+	upstream_result_t result;
+	std::string error;
+	bool ok = upstream_fetch(upstream, index.get(), &result, &error);
+
+	log_time();
+	if (ok) {
+		printf("Fetched %zu records: %lu bytes received, %lu decoded, in %lu ms\n",
+		       index->num_records, result.wire_bytes, result.body_bytes, result.duration_ms);
+		server_publish(server, index);
+	} else {
+		printf("Fetch failed (status %d, %lu ms): %s\n",
+		       result.status, result.duration_ms, error.c_str());
+	}
+	fflush(stdout);
+	server_record_poll(server, ok, result.body_bytes);
+	return ok;
+}
+
+/**
+ * Poll the upstream server every interval seconds, starting after delay
+ * seconds, until stopped. Polls which fall behind (e.g. because the upstream
+ * server was slow to respond) are skipped rather than made in a burst.
+ */
+static void run_poller(upstream_t *upstream, server_t *server,
+                       unsigned long delay, unsigned long interval) {
+	auto next_poll = std::chrono::steady_clock::now() + std::chrono::seconds(delay);
+	while (!stop) {
+		if (std::chrono::steady_clock::now() >= next_poll) {
+			poll_upstream(upstream, server);
+			next_poll += std::chrono::seconds(interval);
+			auto now = std::chrono::steady_clock::now();
+			if (next_poll < now) {
+				next_poll = now + std::chrono::seconds(interval);
+			}
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+}
+
+static void print_report(const server_t *server, const load_test_result_t *result) {
+	char summary[160];
+	double seconds = result->elapsed / 1000.0;
+	unsigned long polls = server->upstream_polls;
+	unsigned long feed_bytes = server->feed_bytes;
+
+	printf("\n");
+	printf("Devices:          %lu connections, %lu requests (%.0f/s), %lu failed\n",
+	       result->connections, result->requests, result->requests / seconds,
+	       result->failures);
+	printf("Records:          %lu (%lu at stations not asked for)\n",
+	       result->records, result->wrong_records);
+	perf_histogram_summary(&result->latency, summary, sizeof(summary));
+	printf("Latency (us):     %s\n", summary);
+	perf_histogram_summary(&result->body_bytes, summary, sizeof(summary));
+	printf("Response bytes:   %s\n", summary);
+	printf("Received:         %llu bytes (%.1f kB/s)\n",
+	       result->bytes_received, result->bytes_received / seconds / 1000);
+	printf("Upstream:         %lu polls (%lu failed), feed %lu bytes\n",
+	       polls, (unsigned long)server->upstream_failures, feed_bytes);
+	if (feed_bytes > 0) {
+		printf("                  mean response is %.2f%% of the feed\n",
+		       100.0 * perf_histogram_mean(&result->body_bytes) / feed_bytes);
+	}
+	if (polls > 0) {
+		printf("                  %.0f device requests per upstream poll\n",
+		       (double)result->requests / polls);
+	}
+}
+
+static void usage(const char *name) {
+	fprintf(stderr,
+	        "Usage: %s [options]\n"
+	        "  --upstream URL          departures feed (default %s)\n"
+	        "  --api-key KEY           subscription key (default $TFGM_API_KEY)\n"
+	        "  --address ADDRESS       address to listen on (default 0.0.0.0)\n"
+	        "  --port PORT             port to listen on (default 8080)\n"
+	        "  --path PATH             path to serve departures at (default %s)\n"
+	        "  --poll-interval SECS    time between upstream polls (default 15)\n"
+	        "  --load-test             simulate devices polling a local proxy\n"
+	        "  --devices N             devices to simulate (default 100)\n"
+	        "  --duration SECS         length of the load test (default 10)\n"
+	        "  --device-interval MS    time between each device's requests (default 0)\n"
+	        "  --binary                have devices ask for the binary format\n",
+	        name, DEFAULT_UPSTREAM, DEFAULT_PATH);
+}
+
+static bool parse_options(int argc, char *argv[], options_t *options) {
+	enum {
+		OPTION_UPSTREAM,
+		OPTION_API_KEY,
+		OPTION_ADDRESS,
+		OPTION_PORT,
+		OPTION_PATH,
+		OPTION_POLL_INTERVAL,
+		OPTION_LOAD_TEST,
+		OPTION_DEVICES,
+		OPTION_DURATION,
+		OPTION_DEVICE_INTERVAL,
+		OPTION_BINARY,
+	};
+	static const struct option long_options[] = {
+		{"upstream", required_argument, NULL, OPTION_UPSTREAM},
+		{"api-key", required_argument, NULL, OPTION_API_KEY},
+		{"address", required_argument, NULL, OPTION_ADDRESS},
+		{"port", required_argument, NULL, OPTION_PORT},
+		{"path", required_argument, NULL, OPTION_PATH},
+		{"poll-interval", required_argument, NULL, OPTION_POLL_INTERVAL},
+		{"load-test", no_argument, NULL, OPTION_LOAD_TEST},
+		{"devices", required_argument, NULL, OPTION_DEVICES},
+		{"duration", required_argument, NULL, OPTION_DURATION},
+		{"device-interval", required_argument, NULL, OPTION_DEVICE_INTERVAL},
+		{"binary", no_argument, NULL, OPTION_BINARY},
+		{NULL, 0, NULL, 0},
+	};
+
+	options->upstream_url = DEFAULT_UPSTREAM;
+	options->api_key = getenv("TFGM_API_KEY");
+	options->address = "0.0.0.0";
+	options->port = 8080;
+	options->path = DEFAULT_PATH;
+	options->poll_interval = 15;
+	options->load_test = false;
+	options->devices = 100;
+	options->duration = 10;
+	options->device_interval = 0;
+	options->binary = false;
+
+	int option;
+	while ((option = getopt_long(argc, argv, "", long_options, NULL)) != -1) {
+		switch (option) {
+			case OPTION_UPSTREAM: options->upstream_url = optarg; break;
+			case OPTION_API_KEY: options->api_key = optarg; break;
+			case OPTION_ADDRESS: options->address = optarg; break;
+			case OPTION_PORT: options->port = atoi(optarg); break;
+			case OPTION_PATH: options->path = optarg; break;
+			case OPTION_POLL_INTERVAL: options->poll_interval = strtoul(optarg, NULL, 10); break;
+			case OPTION_LOAD_TEST: options->load_test = true; break;
+			case OPTION_DEVICES: options->devices = strtoul(optarg, NULL, 10); break;
+			case OPTION_DURATION: options->duration = strtoul(optarg, NULL, 10); break;
+			case OPTION_DEVICE_INTERVAL: options->device_interval = strtoul(optarg, NULL, 10); break;
+			case OPTION_BINARY: options->binary = true; break;
+			default: return false;
+		}
+	}
+	return optind == argc && options->poll_interval > 0 && options->devices > 0;
+}
+
+int main(int argc, char *argv[]) {
+	options_t options;
+	if (!parse_options(argc, argv, &options)) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	signal(SIGPIPE, SIG_IGN);
+	signal(SIGINT, handle_signal);
+	signal(SIGTERM, handle_signal);
+
+	std::string error;
+	static upstream_t upstream;
+	if (!upstream_init(&upstream, options.upstream_url, options.api_key, &error)) {
+		fprintf(stderr, "%s: %s\n", options.upstream_url, error.c_str());
+		return 1;
+	}
+
+	// The load test runs against a server on a free local port
+	const char *address = options.load_test ? "127.0.0.1" : options.address;
+	uint16_t port = options.load_test ? 0 : options.port;
+	static server_t server;
+	if (!server_init(&server, address, port, options.path,
+	                 MAX_INDEX_AGE_POLLS * options.poll_interval * 1000, &error)) {
+		fprintf(stderr, "%s: %s\n", address, error.c_str());
+		return 1;
+	}
+
+	if (!options.load_test) {
+		log_time();
+		printf("Serving %s on %s:%u from %s\n",
+		       options.path, address, (unsigned)server.port, options.upstream_url);
+		std::thread poller(run_poller, &upstream, &server, 0, options.poll_interval);
+		server_run(&server, &stop);
+		poller.join();
+		return 0;
+	}
+
+	// There's nothing to test until the first poll succeeds
+	if (!poll_upstream(&upstream, &server)) {
+		return 1;
+	}
+	std::atomic<bool> server_stop(false);
+	std::thread server_thread(server_run, &server, &server_stop);
+	std::thread poller(run_poller, &upstream, &server,
+	                   options.poll_interval, options.poll_interval);
+
+	load_test_config_t config;
+	config.address = address;
+	config.port = server.port;
+	config.base_path = options.path;
+	config.num_devices = options.devices;
+	config.duration = options.duration * 1000;
+	config.interval = options.device_interval;
+	config.binary = options.binary;
+	config.seed = 1;
+	static load_test_result_t result;
+	printf("Simulating %zu devices for %lu s (%s)\n",
+	       options.devices, options.duration, options.binary ? "binary" : "JSON");
+	fflush(stdout);
+	load_test_run(&config, &result);
+
+	stop = true;
+	server_stop = true;
+	poller.join();
+	server_thread.join();
+	print_report(&server, &result);
+	return result.failures == 0 && result.wrong_records == 0 ? 0 : 1;
+}
@@ -0,0 +1,551 @@
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "server.h"
+#include "metrics.h"
+#include "metrolink.h"
+
+// Longest request (line and headers) accepted
+static const size_t MAX_REQUEST_SIZE = 8192;
+
+// Connections idle for longer than this are closed (milliseconds). Devices
+// poll at most every few minutes.
+static const unsigned long IDLE_TIMEOUT = 5 * 60 * 1000;
+
+// How often server_run checks whether it should stop (milliseconds)
+static const int STOP_CHECK_INTERVAL = 200;
+
+// Largest number of stations accepted in a $filter
+static const size_t MAX_FILTER_STATIONS = 32;
+
+static unsigned long now_ms(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000ul + now.tv_nsec / 1000000;
+}
+
+static unsigned long now_us(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000000ul + now.tv_nsec / 1000;
+}
+
+bool server_init(server_t *server, const char *address, uint16_t port,
+                 const char *base_path, unsigned long max_index_age,
+                 std::string *error) {
+	server->base_path = base_path;
+	server->max_index_age = max_index_age;
+	server->index_time = 0;
+	server->connections.clear();
+	server->requests = 0;
+	server->bad_requests = 0;
+	server->binary_responses = 0;
+	server->upstream_polls = 0;
+	server->upstream_failures = 0;
+	server->feed_bytes = 0;
+	perf_histogram_clear(&server->request_time);
+	perf_histogram_clear(&server->response_bytes);
+
+	struct sockaddr_in addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(port);
+	if (inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+		*error = std::string("Invalid address: ") + address;
+		return false;
+	}
+
+	server->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	int reuse = 1;
+	if (server->listen_fd < 0 ||
+	    setsockopt(server->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+	    bind(server->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+	    listen(server->listen_fd, SOMAXCONN) != 0) {
+		*error = std::string("Couldn't listen: ") + strerror(errno);
+		return false;
+	}
+
+	socklen_t length = sizeof(addr);
+	getsockname(server->listen_fd, (struct sockaddr *)&addr, &length);
+	server->port = ntohs(addr.sin_port);
+	return true;
+}
+
+void server_publish(server_t *server, std::shared_ptr<const departures_index_t> index) {
+	std::lock_guard<std::mutex> lock(server->index_mutex);
+	server->index = index;
+	server->index_time = now_ms();
+}
+
+void server_record_poll(server_t *server, bool ok, unsigned long feed_bytes) {
+	server->upstream_polls++;
+	if (ok) {
+		server->feed_bytes = feed_bytes;
+	} else {
+		server->upstream_failures++;
+	}
+}
+
+/**
+ * Case-insensitive ASCII prefix comparison.
+ */
+static bool starts_with_ignore_case(const char *str, const char *prefix) {
+	for (; *prefix; str++, prefix++) {
+		char a = (*str >= 'A' && *str <= 'Z') ? *str - 'A' + 'a' : *str;
+		if (a != *prefix) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int hex_value(char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	} else if (c >= 'A' && c <= 'F') {
+		return c - 'A' + 10;
+	}
+	return -1;
+}
+
+/**
+ * Decode %XX escapes (and + as a space) in part of a query string.
+ */
+static std::string url_decode(const std::string &str) {
+	std::string decoded;
+	for (size_t i = 0; i < str.size(); i++) {
+		int high, low;
+		if (str[i] == '%' && i + 2 < str.size() &&
+		    (high = hex_value(str[i + 1])) >= 0 && (low = hex_value(str[i + 2])) >= 0) {
+			decoded.push_back((char)(high * 16 + low));
+			i += 2;
+		} else if (str[i] == '+') {
+			decoded.push_back(' ');
+		} else {
+			decoded.push_back(str[i]);
+		}
+	}
+	return decoded;
+}
+
+/**
+ * Find the (decoded) value of a query string parameter. Returns false if it
+ * isn't present.
+ */
+static bool get_query_parameter(const std::string &query, const char *name,
+                                std::string *value) {
+	size_t start = 0;
+	while (start <= query.size()) {
+		size_t end = query.find('&', start);
+		if (end == std::string::npos) {
+			end = query.size();
+		}
+		std::string parameter = query.substr(start, end - start);
+		size_t equals = parameter.find('=');
+		if (url_decode(parameter.substr(0, equals)) == name) {
+			*value = equals == std::string::npos ? "" : url_decode(parameter.substr(equals + 1));
+			return true;
+		}
+		start = end + 1;
+	}
+	return false;
+}
+
+/**
+ * Parse a $filter of "StationLocation eq '...'" clauses joined by "or" into
+ * station indices (-1 for unknown stations, which match no records). Returns
+ * false for unsupported filters.
+ */
+static bool parse_filter(const std::string &filter, std::vector<int> *stations) {
+	static const char PREFIX[] = "StationLocation eq '";
+	static const char SEPARATOR[] = " or ";
+	size_t pos = 0;
+	while (true) {
+		while (pos < filter.size() && filter[pos] == ' ') {
+			pos++;
+		}
+		if (filter.compare(pos, sizeof(PREFIX) - 1, PREFIX) != 0) {
+			return false;
+		}
+		pos += sizeof(PREFIX) - 1;
+
+		// Single quotes within the literal are doubled
+		std::string name;
+		while (true) {
+			if (pos >= filter.size()) {
+				return false;
+			} else if (filter[pos] == '\'' && pos + 1 < filter.size() && filter[pos + 1] == '\'') {
+				name.push_back('\'');
+				pos += 2;
+			} else if (filter[pos] == '\'') {
+				pos++;
+				break;
+			} else {
+				name.push_back(filter[pos++]);
+			}
+		}
+		if (stations->size() == MAX_FILTER_STATIONS) {
+			return false;
+		}
+		stations->push_back(metrolink_get_station_index(name.c_str()));
+
+		while (pos < filter.size() && filter[pos] == ' ' &&
+		       filter.compare(pos, sizeof(SEPARATOR) - 1, SEPARATOR) != 0) {
+			pos++;
+		}
+		if (pos == filter.size()) {
+			return true;
+		}
+		if (filter.compare(pos, sizeof(SEPARATOR) - 1, SEPARATOR) != 0) {
+			return false;
+		}
+		pos += sizeof(SEPARATOR) - 1;
+	}
+}
+
+static void append_response(server_connection_t *connection, int status, const char *reason,
+                            const char *content_type, const std::string &body) {
+	char head[256];
+	snprintf(head, sizeof(head),
+	         "HTTP/1.1 %d %s\r\n"
+	         "Content-Type: %s\r\n"
+	         "Content-Length: %zu\r\n"
+	         "%s"
+	         "\r\n",
+	         status, reason, content_type, body.size(),
+	         connection->closing ? "Connection: close\r\n" : "");
+	connection->output.append(head);
+	connection->output.append(body);
+}
+
+static void append_error(server_t *server, server_connection_t *connection,
+                         int status, const char *reason, const char *message) {
+	server->bad_requests++;
+	append_response(connection, status, reason, "application/json",
+	                std::string("{\"error\":\"") + message + "\"}");
+}
+
+static void append_metrics(server_t *server, server_connection_t *connection) {
+	static char buf[8192];
+	metrics_writer_t writer;
+	metrics_writer_init(&writer, buf, sizeof(buf));
+
+	std::shared_ptr<const departures_index_t> index;
+	unsigned long index_time;
+	{
+		std::lock_guard<std::mutex> lock(server->index_mutex);
+		index = server->index;
+		index_time = server->index_time;
+	}
+
+	metrics_write_counter(&writer, "trambox_proxy_requests_total",
+	                      "Requests answered.", server->requests);
+	metrics_write_counter(&writer, "trambox_proxy_bad_requests_total",
+	                      "Requests which were malformed or unsupported.", server->bad_requests);
+	metrics_write_gauge(&writer, "trambox_proxy_connections",
+	                    "Open connections from devices.", server->connections.size());
+	metrics_write_counter(&writer, "trambox_proxy_binary_responses_total",
+	                      "Departures responses sent in the binary format.",
+	                      server->binary_responses);
+	// request_time is in microseconds
+	metrics_write_histogram(&writer, "trambox_proxy_request_duration_seconds",
+	                        "Time to handle each request.", &server->request_time, 6);
+	metrics_write_histogram(&writer, "trambox_proxy_response_bytes",
+	                        "Size of each departures response body.", &server->response_bytes, 0);
+	metrics_write_counter(&writer, "trambox_proxy_upstream_polls_total",
+	                      "Polls of the upstream feed.", server->upstream_polls);
+	metrics_write_counter(&writer, "trambox_proxy_upstream_failures_total",
+	                      "Polls of the upstream feed which failed.", server->upstream_failures);
+	metrics_write_gauge(&writer, "trambox_proxy_feed_bytes",
+	                    "Size of the last feed fetched.", server->feed_bytes);
+	metrics_write_gauge(&writer, "trambox_proxy_records",
+	                    "Platform records in the last feed fetched.",
+	                    index ? (long)index->num_records : 0);
+	metrics_write_gauge(&writer, "trambox_proxy_feed_age_seconds",
+	                    "Time since the last feed was fetched.",
+	                    index ? (long)((now_ms() - index_time) / 1000) : 0);
+
+	append_response(connection, 200, "OK", "text/plain; version=0.0.4",
+	                std::string(buf, writer.length));
+}
+
+static void append_departures(server_t *server, server_connection_t *connection,
+                              const std::string &query, departures_index_format_t format) {
+	std::shared_ptr<const departures_index_t> index;
+	unsigned long index_time;
+	{
+		std::lock_guard<std::mutex> lock(server->index_mutex);
+		index = server->index;
+		index_time = server->index_time;
+	}
+	if (!index) {
+		append_error(server, connection, 503, "Service Unavailable",
+		             "departures not fetched yet");
+		return;
+	}
+	if (now_ms() - index_time > server->max_index_age) {
+		append_error(server, connection, 503, "Service Unavailable",
+		             "departures out of date");
+		return;
+	}
+
+	std::string filter;
+	std::string body;
+	if (get_query_parameter(query, "$filter", &filter)) {
+		std::vector<int> stations;
+		if (!parse_filter(filter, &stations)) {
+			append_error(server, connection, 400, "Bad Request", "unsupported $filter");
+			return;
+		}
+		departures_index_render(index.get(), format, stations.data(), stations.size(), &body);
+	} else {
+		departures_index_render_all(index.get(), format, &body);
+	}
+
+	perf_histogram_add(&server->response_bytes, body.size());
+	if (format == DEPARTURES_INDEX_BINARY) {
+		server->binary_responses++;
+		append_response(connection, 200, "OK", DEPARTURES_BINARY_CONTENT_TYPE, body);
+	} else {
+		append_response(connection, 200, "OK", "application/json", body);
+	}
+}
+
+/**
+ * Does an Accept header value list the binary departures format (with a
+ * non-zero quality)? Wildcards don't count: devices which can decode it ask
+ * for it by name.
+ */
+static bool accepts_binary(const std::string &accept) {
+	static const char TYPE[] = DEPARTURES_BINARY_CONTENT_TYPE;
+	size_t start = 0;
+	while (start < accept.size()) {
+		size_t end = accept.find(',', start);
+		if (end == std::string::npos) {
+			end = accept.size();
+		}
+		// e.g. " application/x-trambox-departures;q=0.9"
+		std::string range = accept.substr(start, end - start);
+		size_t type_start = range.find_first_not_of(" \t");
+		if (type_start != std::string::npos &&
+		    starts_with_ignore_case(range.c_str() + type_start, TYPE)) {
+			std::string rest = range.substr(type_start + sizeof(TYPE) - 1);
+			size_t rest_start = rest.find_first_not_of(" \t");
+			if (rest_start == std::string::npos) {
+				return true;
+			}
+			if (rest[rest_start] == ';') {
+				size_t q = rest.find("q=");
+				return q == std::string::npos || strtod(rest.c_str() + q + 2, NULL) > 0;
+			}
+		}
+		start = end + 1;
+	}
+	return false;
+}
+
+/**
+ * Answer a request, given its request line and headers.
+ */
+static void handle_request(server_t *server, server_connection_t *connection,
+                           const std::string &head) {
+	unsigned long start = now_us();
+	server->requests++;
+
+	// e.g. "GET /odata/Metrolinks?$filter=... HTTP/1.1"
+	size_t method_end = head.find(' ');
+	size_t target_end = method_end == std::string::npos
+	                    ? std::string::npos : head.find(' ', method_end + 1);
+	size_t line_end = head.find("\r\n");
+	if (target_end == std::string::npos || target_end > line_end ||
+	    head.compare(target_end + 1, 7, "HTTP/1.") != 0) {
+		connection->closing = true;
+		append_error(server, connection, 400, "Bad Request", "malformed request");
+		return;
+	}
+	std::string method = head.substr(0, method_end);
+	std::string target = head.substr(method_end + 1, target_end - method_end - 1);
+
+	// HTTP/1.0 connections are closed after each response unless asked
+	// otherwise, and HTTP/1.1 connections are kept open unless asked otherwise
+	bool keep_alive = head[target_end + 8] != '0';
+	departures_index_format_t format = DEPARTURES_INDEX_JSON;
+	for (size_t pos = line_end; pos != std::string::npos; pos = head.find("\r\n", pos + 2)) {
+		const char *line = head.c_str() + pos + 2;
+		if (starts_with_ignore_case(line, "accept:")) {
+			if (accepts_binary(head.substr(pos + 9, head.find("\r\n", pos + 2) - pos - 9))) {
+				format = DEPARTURES_INDEX_BINARY;
+			}
+		} else if (starts_with_ignore_case(line, "connection:")) {
+			std::string value = head.substr(pos + 13, head.find("\r\n", pos + 2) - pos - 13);
+			for (char &c : value) {
+				c = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+			}
+			if (value.find("close") != std::string::npos) {
+				keep_alive = false;
+			} else if (value.find("keep-alive") != std::string::npos) {
+				keep_alive = true;
+			}
+		}
+	}
+	connection->closing |= !keep_alive;
+
+	size_t question = target.find('?');
+	std::string path = target.substr(0, question);
+	std::string query = question == std::string::npos ? "" : target.substr(question + 1);
+
+	if (method != "GET") {
+		append_error(server, connection, 405, "Method Not Allowed", "only GET is supported");
+	} else if (path == server->base_path) {
+		append_departures(server, connection, query, format);
+	} else if (path == "/metrics") {
+		append_metrics(server, connection);
+	} else {
+		append_error(server, connection, 404, "Not Found", "not found");
+	}
+
+	perf_histogram_add(&server->request_time, now_us() - start);
+}
+
+/**
+ * Read from a connection and answer any complete requests. Returns false if
+ * the connection should be closed straight away.
+ */
+static bool receive(server_t *server, server_connection_t *connection) {
+	char buf[4096];
+	ssize_t n = recv(connection->fd, buf, sizeof(buf), 0);
+	if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+		return false;
+	} else if (n < 0) {
+		return true;
+	}
+	connection->last_active = now_ms();
+	if (connection->closing) {
+		// Requests after one asking to close are ignored
+		return true;
+	}
+	connection->input.append(buf, n);
+
+	size_t end;
+	while (!connection->closing && (end = connection->input.find("\r\n\r\n")) != std::string::npos) {
+		handle_request(server, connection, connection->input.substr(0, end + 2));
+		connection->input.erase(0, end + 4);
+	}
+	if (connection->input.size() > MAX_REQUEST_SIZE) {
+		connection->closing = true;
+		connection->input.clear();
+		append_error(server, connection, 431, "Request Header Fields Too Large",
+		             "request too large");
+	}
+	return true;
+}
+
+/**
+ * Send as much pending output as possible. Returns false if the connection
+ * should be closed.
+ */
+static bool transmit(server_connection_t *connection) {
+	while (connection->output_sent < connection->output.size()) {
+		ssize_t n = send(connection->fd, connection->output.data() + connection->output_sent,
+		                 connection->output.size() - connection->output_sent, MSG_NOSIGNAL);
+		if (n < 0) {
+			return errno == EAGAIN || errno == EWOULDBLOCK;
+		}
+		connection->output_sent += n;
+		connection->last_active = now_ms();
+	}
+	connection->output.clear();
+	connection->output_sent = 0;
+	return !connection->closing;
+}
+
+static void accept_connections(server_t *server) {
+	while (true) {
+		int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK);
+		if (fd < 0) {
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				perror("accept");
+			}
+			return;
+		}
+		int nodelay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+		server_connection_t connection;
+		connection.fd = fd;
+		connection.output_sent = 0;
+		connection.closing = false;
+		connection.last_active = now_ms();
+		server->connections.push_back(std::move(connection));
+	}
+}
+
+void server_run(server_t *server, const std::atomic<bool> *stop) {
+	std::vector<struct pollfd> fds;
+	while (!*stop) {
+		// The listening socket followed by each connection
+		fds.resize(server->connections.size() + 1);
+		fds[0] = {server->listen_fd, POLLIN, 0};
+		for (size_t i = 0; i < server->connections.size(); i++) {
+			const server_connection_t *connection = &server->connections[i];
+			short events = connection->output.empty() ? POLLIN : POLLIN | POLLOUT;
+			fds[i + 1] = {connection->fd, events, 0};
+		}
+
+		if (poll(fds.data(), fds.size(), STOP_CHECK_INTERVAL) < 0 && errno != EINTR) {
+			perror("poll");
+			return;
+		}
+
+		size_t num_polled = server->connections.size();
+		size_t kept = 0;
+		for (size_t i = 0; i < num_polled; i++) {
+			server_connection_t *connection = &server->connections[i];
+			short revents = fds[i + 1].revents;
+			bool open = true;
+			if (revents & POLLIN) {
+				open = receive(server, connection);
+			} else if (revents & (POLLERR | POLLHUP)) {
+				open = false;
+			}
+			if (open && (!connection->output.empty() || connection->closing)) {
+				open = transmit(connection);
+			}
+			// last_active may have been updated just now, so read the clock after
+			if (open && now_ms() - connection->last_active > IDLE_TIMEOUT) {
+				open = false;
+			}
+
+			if (open) {
+				if (kept != i) {
+					server->connections[kept] = std::move(*connection);
+				}
+				kept++;
+			} else {
+				close(connection->fd);
+			}
+		}
+		server->connections.resize(kept);
+
+		if (fds[0].revents & POLLIN) {
+			accept_connections(server);
+		}
+	}
+
+	for (const server_connection_t &connection : server->connections) {
+		close(connection.fd);
+	}
+	server->connections.clear();
+	close(server->listen_fd);
+}
@@ -0,0 +1,109 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "departures_index.h"
+#include "perf.h"
+
+/**
+ * A device's connection to the server.
+ */
+typedef struct {
+	int fd;
+
+	// Bytes received but not yet handled, and the responses being sent
+	std::string input;
+	std::string output;
+	size_t output_sent;
+
+	// Close the connection once the output has been sent?
+	bool closing;
+
+	// Time (milliseconds) of the last data received or sent
+	unsigned long last_active;
+} server_connection_t;
+
+/**
+ * Serves departures to devices from the latest index over HTTP/1.1, keeping
+ * connections alive between polls. It answers the requests the firmware makes
+ * (see departures_build_request_path): a GET of the base path, optionally with
+ * a $filter of "StationLocation eq '...'" clauses joined by "or". Any $select
+ * is ignored, as only the fields the firmware uses are ever sent. Devices
+ * listing DEPARTURES_BINARY_CONTENT_TYPE in their Accept header are sent the
+ * binary format (see departures_binary.h) instead of JSON. Metrics are
+ * served at /metrics in the Prometheus text format.
+ *
+ * A single thread (running server_run) handles every connection using
+ * poll(). Indices are published and polls recorded from other threads.
+ *
+ * Initialise with server_init.
+ */
+typedef struct {
+	int listen_fd;
+	uint16_t port;
+	std::string base_path;
+	std::vector<server_connection_t> connections;
+
+	// The index requests are answered from (NULL until the first successful
+	// poll of the upstream server) and when it was published (milliseconds)
+	std::mutex index_mutex;
+	std::shared_ptr<const departures_index_t> index;
+	unsigned long index_time;
+
+	// Age (milliseconds) beyond which the index is no longer served, so that
+	// devices see an error rather than stale times while the upstream server
+	// is failing
+	unsigned long max_index_age;
+
+	// Requests answered, and those which were malformed or unsupported
+	std::atomic<unsigned long> requests;
+	std::atomic<unsigned long> bad_requests;
+
+	// Departures responses sent in the binary format
+	std::atomic<unsigned long> binary_responses;
+
+	// Polls of the upstream server, those which failed, and the size of the
+	// last feed fetched successfully
+	std::atomic<unsigned long> upstream_polls;
+	std::atomic<unsigned long> upstream_failures;
+	std::atomic<unsigned long> feed_bytes;
+
+	// Time to handle each request (microseconds) and the size of each
+	// departures response body. Only used by the server thread.
+	perf_histogram_t request_time;
+	perf_histogram_t response_bytes;
+} server_t;
+
+/**
+ * Listen on the given address and port (0 to choose any free port, which is
+ * then set in server->port), answering requests from indices no older than
+ * max_index_age milliseconds. Returns false, setting error, on failure.
+ */
+bool server_init(server_t *server, const char *address, uint16_t port,
+                 const char *base_path, unsigned long max_index_age,
+                 std::string *error);
+
+/**
+ * Answer requests from a new index from now on.
+ */
+void server_publish(server_t *server, std::shared_ptr<const departures_index_t> index);
+
+/**
+ * Record a poll of the upstream server, and the size of the feed fetched if
+ * it succeeded.
+ */
+void server_record_poll(server_t *server, bool ok, unsigned long feed_bytes);
+
+/**
+ * Serve requests until *stop is set.
+ */
+void server_run(server_t *server, const std::atomic<bool> *stop);
+
+#endif
@@ -0,0 +1,277 @@
+#include <errno.h>
+#include <netdb.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/x509v3.h>
+
+#include "upstream.h"
+#include "http_response.h"
+#include "inflate.h"
+
+// Size of the buffer data is received into
+static const size_t RECEIVE_BUFFER_SIZE = 16384;
+
+bool upstream_init(upstream_t *upstream, const char *url, const char *api_key,
+                   std::string *error) {
+	std::string rest = url;
+	if (rest.compare(0, 7, "http://") == 0) {
+		upstream->tls = false;
+		rest.erase(0, 7);
+	} else if (rest.compare(0, 8, "https://") == 0) {
+		upstream->tls = true;
+		rest.erase(0, 8);
+	} else {
+		*error = "URL must start with http:// or https://";
+		return false;
+	}
+
+	size_t slash = rest.find('/');
+	std::string authority = rest.substr(0, slash);
+	upstream->path = slash == std::string::npos ? "/" : rest.substr(slash);
+	size_t colon = authority.rfind(':');
+	if (colon != std::string::npos) {
+		upstream->host = authority.substr(0, colon);
+		upstream->port = authority.substr(colon + 1);
+	} else {
+		upstream->host = authority;
+		upstream->port = upstream->tls ? "443" : "80";
+	}
+	if (upstream->host.empty() || upstream->port.empty()) {
+		*error = "URL has no host";
+		return false;
+	}
+
+	upstream->api_key = api_key ? api_key : "";
+	upstream->timeout = 20;
+	upstream->ssl_ctx = NULL;
+
+	if (upstream->tls) {
+		upstream->ssl_ctx = SSL_CTX_new(TLS_client_method());
+		if (!upstream->ssl_ctx || !SSL_CTX_set_default_verify_paths(upstream->ssl_ctx)) {
+			*error = "Couldn't set up TLS";
+			return false;
+		}
+		SSL_CTX_set_verify(upstream->ssl_ctx, SSL_VERIFY_PEER, NULL);
+	}
+	return true;
+}
+
+/**
+ * Connect to the upstream server. Returns the socket or -1.
+ */
+static int connect_upstream(const upstream_t *upstream, std::string *error) {
+	struct addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	struct addrinfo *addresses;
+	int status = getaddrinfo(upstream->host.c_str(), upstream->port.c_str(), &hints, &addresses);
+	if (status != 0) {
+		*error = std::string("DNS lookup failed: ") + gai_strerror(status);
+		return -1;
+	}
+
+	struct timeval timeout = {upstream->timeout, 0};
+	int fd = -1;
+	for (struct addrinfo *address = addresses; address; address = address->ai_next) {
+		fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+		if (fd < 0) {
+			continue;
+		}
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+		if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+			break;
+		}
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(addresses);
+
+	if (fd < 0) {
+		*error = std::string("Couldn't connect: ") + strerror(errno);
+	}
+	return fd;
+}
+
+/**
+ * State of a fetch, passed to the parsers' callbacks.
+ */
+typedef struct {
+	http_response_t response;
+	departures_parser_t parser;
+	departures_index_t *index;
+
+	bool body_started;
+	bool compressed;
+	bool decode_error;
+	bool parse_error;
+} fetch_t;
+
+// Large with the full 32kB window (see platformio.ini), so not on the stack
+static inflate_t inflate;
+
+static void parse_body(const char *data, size_t length, void *cb_data) {
+	fetch_t *fetch = (fetch_t *)cb_data;
+	fetch->index->feed_bytes += length;
+	if (!fetch->parse_error) {
+		fetch->parse_error = !departures_parser_feed(&fetch->parser, data, length);
+	}
+}
+
+/**
+ * Called with each piece of the response body: as process_response_body in
+ * the firmware.
+ */
+static void process_body(const char *data, size_t length, void *cb_data) {
+	fetch_t *fetch = (fetch_t *)cb_data;
+	if (fetch->response.status != 200 || fetch->decode_error) {
+		return;
+	}
+
+	if (!fetch->body_started) {
+		fetch->body_started = true;
+		switch (fetch->response.content_encoding) {
+			case HTTP_CONTENT_IDENTITY:
+				break;
+			case HTTP_CONTENT_GZIP:
+			case HTTP_CONTENT_DEFLATE:
+				fetch->compressed = true;
+				inflate_init(&inflate,
+				             fetch->response.content_encoding == HTTP_CONTENT_GZIP
+				             ? INFLATE_GZIP : INFLATE_DEFLATE,
+				             parse_body, fetch);
+				break;
+			default:
+				fetch->decode_error = true;
+				return;
+		}
+	}
+
+	if (fetch->compressed) {
+		fetch->decode_error = !inflate_feed(&inflate, data, length);
+	} else {
+		parse_body(data, length, fetch);
+	}
+}
+
+static unsigned long now_ms(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec * 1000ul + now.tv_nsec / 1000000;
+}
+
+bool upstream_fetch(upstream_t *upstream, departures_index_t *index,
+                    upstream_result_t *result, std::string *error) {
+	unsigned long start = now_ms();
+	result->status = -1;
+	result->wire_bytes = 0;
+	result->body_bytes = 0;
+	result->duration_ms = 0;
+
+	static fetch_t fetch;
+	departures_index_init(index);
+	fetch.index = index;
+	fetch.body_started = false;
+	fetch.compressed = false;
+	fetch.decode_error = false;
+	fetch.parse_error = false;
+	http_response_init(&fetch.response, process_body, &fetch);
+	departures_parser_init(&fetch.parser, departures_index_add, index);
+
+	int fd = connect_upstream(upstream, error);
+	if (fd < 0) {
+		return false;
+	}
+
+	SSL *ssl = NULL;
+	if (upstream->tls) {
+		ssl = SSL_new(upstream->ssl_ctx);
+		SSL_set_tlsext_host_name(ssl, upstream->host.c_str());
+		SSL_set1_host(ssl, upstream->host.c_str());
+		SSL_set_fd(ssl, fd);
+		if (SSL_connect(ssl) != 1) {
+			char reason[256];
+			ERR_error_string_n(ERR_get_error(), reason, sizeof(reason));
+			*error = std::string("TLS handshake failed: ") + reason;
+			SSL_free(ssl);
+			close(fd);
+			return false;
+		}
+	}
+
+	std::string host = upstream->host;
+	if (upstream->port != (upstream->tls ? "443" : "80")) {
+		host += ":" + upstream->port;
+	}
+	std::string request = "GET " + upstream->path + " HTTP/1.1\r\n"
+	                      "Host: " + host + "\r\n"
+	                      "User-Agent: TramBoxProxy\r\n"
+	                      "Accept-Encoding: gzip, deflate\r\n"
+	                      "Connection: close\r\n";
+	if (!upstream->api_key.empty()) {
+		request += "Ocp-Apim-Subscription-Key: " + upstream->api_key + "\r\n";
+	}
+	request += "\r\n";
+
+	bool ok = true;
+	size_t sent = 0;
+	while (ok && sent < request.size()) {
+		int n = ssl ? SSL_write(ssl, request.data() + sent, request.size() - sent)
+		            : send(fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+		if (n <= 0) {
+			*error = "Couldn't send request";
+			ok = false;
+		} else {
+			sent += n;
+		}
+	}
+
+	static char buf[RECEIVE_BUFFER_SIZE];
+	while (ok && !http_response_done(&fetch.response) && !http_response_error(&fetch.response)) {
+		int n = ssl ? SSL_read(ssl, buf, sizeof(buf)) : recv(fd, buf, sizeof(buf), 0);
+		if (n > 0) {
+			result->wire_bytes += n;
+			http_response_feed(&fetch.response, buf, n);
+		} else if (n == 0 || (ssl && SSL_get_error(ssl, n) == SSL_ERROR_ZERO_RETURN)) {
+			http_response_closed(&fetch.response);
+		} else {
+			*error = "Timed out or failed receiving response";
+			ok = false;
+		}
+	}
+
+	if (ssl) {
+		SSL_free(ssl);
+	}
+	close(fd);
+
+	result->status = fetch.response.status;
+	result->body_bytes = index->feed_bytes;
+	result->duration_ms = now_ms() - start;
+	if (!ok) {
+		return false;
+	}
+	if (http_response_error(&fetch.response)) {
+		*error = "Malformed or truncated response";
+		return false;
+	}
+	if (fetch.response.status != 200) {
+		*error = "Upstream responded with status " + std::to_string(fetch.response.status);
+		return false;
+	}
+	if (fetch.decode_error || (fetch.compressed && !inflate_done(&inflate))) {
+		*error = "Couldn't decompress response";
+		return false;
+	}
+	if (fetch.parse_error) {
+		*error = "Couldn't parse response";
+		return false;
+	}
+	return true;
+}
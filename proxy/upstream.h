@@ -0,0 +1,61 @@
+#ifndef UPSTREAM_H
+#define UPSTREAM_H
+
+#include <string>
+
+#include <openssl/ssl.h>
+
+#include "departures_index.h"
+
+/**
+ * Fetches the departures feed from the upstream OData endpoint over HTTP or
+ * HTTPS and indexes it, using the firmware's own response, decompression and
+ * feed parsers. Each fetch makes a new connection: polls are far enough apart
+ * that keeping one open isn't worthwhile.
+ *
+ * Initialise with upstream_init.
+ */
+typedef struct {
+	std::string host;
+	std::string port;
+	std::string path;
+	bool tls;
+
+	// Sent as Ocp-Apim-Subscription-Key, if not empty
+	std::string api_key;
+
+	// Timeout of each connect, send and receive (seconds)
+	int timeout;
+
+	SSL_CTX *ssl_ctx;
+} upstream_t;
+
+/**
+ * Measurements of a single fetch.
+ */
+typedef struct {
+	// HTTP status or -1 if no response was received
+	int status;
+
+	// Bytes received (including headers) and the size of the decoded body
+	unsigned long wire_bytes;
+	unsigned long body_bytes;
+
+	unsigned long duration_ms;
+} upstream_result_t;
+
+/**
+ * Prepare to fetch the feed at url ("http://host[:port]/path" or
+ * "https://..."). Returns false, setting error, if the URL is invalid.
+ */
+bool upstream_init(upstream_t *upstream, const char *url, const char *api_key,
+                   std::string *error);
+
+/**
+ * Fetch the feed and index it into index (which is initialised first). Returns
+ * false, setting error, if the fetch failed or the feed couldn't be decoded.
+ */
+bool upstream_fetch(upstream_t *upstream, departures_index_t *index,
+                    upstream_result_t *result, std::string *error);
+
+#endif
@@ -0,0 +1,292 @@
+#include <stddef.h>
+#include <string.h>
+
+#include "config_journal.h"
+#include "crc32.h"
+
+/**
+ * The header at the start of the sector.
+ */
+typedef struct {
+	uint32_t magic;
+	uint16_t schema_version;
+	uint16_t reserved;
+	uint32_t erase_count;
+} sector_header_t;
+
+/**
+ * The header preceding each record's value. The value is padded to a multiple
+ * of 4 bytes.
+ */
+typedef struct {
+	uint8_t id;
+	uint8_t reserved;
+	uint16_t length;
+	// CRC-32 of the id, length and value
+	uint32_t crc;
+} record_header_t;
+
+/**
+ * The id of erased flash, marking the end of the journal.
+ */
+static const uint8_t END_ID = 0xFF;
+
+/**
+ * A record header and value, aligned for flash access.
+ */
+typedef union {
+	struct {
+		record_header_t header;
+		uint8_t value[CONFIG_JOURNAL_MAX_FIELD_SIZE];
+	} record;
+	uint32_t words[(sizeof(record_header_t) + CONFIG_JOURNAL_MAX_FIELD_SIZE) / 4];
+} record_buffer_t;
+
+static size_t padded(size_t length) {
+	return (length + 3) & ~(size_t)3;
+}
+
+static uint32_t record_crc(const record_buffer_t *buf) {
+	const record_header_t *header = &buf->record.header;
+	uint8_t id_and_length[3] = {
+		header->id, (uint8_t)header->length, (uint8_t)(header->length >> 8),
+	};
+	uint32_t crc = crc32_update(0, id_and_length, sizeof(id_and_length));
+	return crc32_update(crc, buf->record.value, header->length);
+}
+
+static const config_journal_field_t *find_field(const config_journal_t *journal,
+                                                uint8_t id) {
+	for (size_t i = 0; i < journal->num_fields; i++) {
+		if (journal->fields[i].id == id) {
+			return &journal->fields[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Read a sector's header. Returns false if the sector doesn't hold a journal
+ * or on a flash error.
+ */
+static bool read_header(const config_journal_flash_t *flash, unsigned int sector,
+                        sector_header_t *header) {
+	return flash->read(sector, 0, (uint32_t *)header, sizeof(*header)) &&
+	       header->magic == CONFIG_JOURNAL_MAGIC;
+}
+
+/**
+ * Mark a sector as no longer holding a journal by clearing its magic number
+ * (which, unlike erasing, is a single small write). Returns false on a flash
+ * error.
+ */
+static bool retire(const config_journal_flash_t *flash, unsigned int sector) {
+	uint32_t cleared = 0;
+	return flash->write(sector, offsetof(sector_header_t, magic), &cleared, sizeof(cleared));
+}
+
+void config_journal_init(config_journal_t *journal,
+                         const config_journal_flash_t *flash,
+                         const config_journal_field_t *fields, size_t num_fields,
+                         uint16_t schema_version) {
+	journal->flash = flash;
+	journal->fields = fields;
+	journal->num_fields = num_fields;
+	journal->schema_version = schema_version;
+	journal->sector = 0;
+	journal->erase_count = 0;
+	journal->end = flash->size;
+	journal->needs_compaction = true;
+	journal->num_records = 0;
+}
+
+bool config_journal_load(config_journal_t *journal, void *config) {
+	const config_journal_flash_t *flash = journal->flash;
+	journal->num_records = 0;
+	journal->end = flash->size;
+	journal->needs_compaction = true;
+
+	// Both sectors hold a journal if a compaction was interrupted before the
+	// old one was retired: the newer has the higher erase count
+	sector_header_t header;
+	memset(&header, 0, sizeof(header));
+	bool found = false;
+	for (unsigned int sector = 0; sector < CONFIG_JOURNAL_NUM_SECTORS; sector++) {
+		sector_header_t candidate;
+		if (read_header(flash, sector, &candidate) &&
+		    (!found || (int32_t)(candidate.erase_count - header.erase_count) > 0)) {
+			header = candidate;
+			journal->sector = sector;
+			found = true;
+		}
+	}
+	if (!found) {
+		return false;
+	}
+	journal->erase_count = header.erase_count;
+
+	record_buffer_t buf;
+	uint32_t offset = sizeof(header);
+	while (offset + sizeof(record_header_t) <= flash->size) {
+		if (!flash->read(journal->sector, offset, buf.words, sizeof(record_header_t))) {
+			return false;
+		}
+		const record_header_t *record = &buf.record.header;
+		if (record->id == END_ID) {
+			// Found the end of the journal
+			break;
+		}
+
+		size_t length = padded(record->length);
+		if (record->length > CONFIG_JOURNAL_MAX_FIELD_SIZE ||
+		    offset + sizeof(record_header_t) + length > flash->size) {
+			// Garbage: ignore the rest of the sector (and compact before
+			// writing anything more)
+			return true;
+		}
+		if (!flash->read(journal->sector, offset + sizeof(record_header_t),
+		                 (uint32_t *)buf.record.value, length)) {
+			return false;
+		}
+
+		const config_journal_field_t *field = find_field(journal, record->id);
+		if (field && record_crc(&buf) == record->crc) {
+			uint8_t *value = (uint8_t *)config + field->offset;
+			size_t copy_length = record->length < field->size ? record->length : field->size;
+			memcpy(value, buf.record.value, copy_length);
+			memset(value + copy_length, 0, field->size - copy_length);
+			journal->num_records++;
+		}
+
+		offset += sizeof(record_header_t) + length;
+	}
+
+	journal->end = offset;
+	journal->needs_compaction = header.schema_version != journal->schema_version;
+	return true;
+}
+
+/**
+ * Write a record for a field at offset *end of a sector, advancing *end past
+ * it. Returns false if there is not enough space or on a flash error.
+ */
+static bool append(const config_journal_flash_t *flash, unsigned int sector, uint32_t *end,
+                   const config_journal_field_t *field, const void *config) {
+	size_t length = sizeof(record_header_t) + padded(field->size);
+	if (field->size > CONFIG_JOURNAL_MAX_FIELD_SIZE || *end + length > flash->size) {
+		return false;
+	}
+
+	record_buffer_t buf;
+	memset(&buf, 0, sizeof(buf));
+	buf.record.header.id = field->id;
+	buf.record.header.length = field->size;
+	memcpy(buf.record.value, (const uint8_t *)config + field->offset, field->size);
+	buf.record.header.crc = record_crc(&buf);
+
+	if (!flash->write(sector, *end, buf.words, length)) {
+		return false;
+	}
+	*end += length;
+	return true;
+}
+
+/**
+ * Check that a sector written by config_journal_format reads back with the
+ * given header and a valid record of every field of config, in order.
+ * Returns false on any difference or a flash error.
+ */
+static bool verify(const config_journal_t *journal, unsigned int sector,
+                   const sector_header_t *expected, const void *config) {
+	const config_journal_flash_t *flash = journal->flash;
+	sector_header_t header;
+	if (!flash->read(sector, 0, (uint32_t *)&header, sizeof(header)) ||
+	    memcmp(&header, expected, sizeof(header)) != 0) {
+		return false;
+	}
+
+	record_buffer_t buf;
+	uint32_t offset = sizeof(header);
+	for (size_t i = 0; i < journal->num_fields; i++) {
+		const config_journal_field_t *field = &journal->fields[i];
+		size_t length = sizeof(record_header_t) + padded(field->size);
+		if (!flash->read(sector, offset, buf.words, length)) {
+			return false;
+		}
+		const record_header_t *record = &buf.record.header;
+		if (record->id != field->id || record->length != field->size ||
+		    record->crc != record_crc(&buf) ||
+		    memcmp(buf.record.value, (const uint8_t *)config + field->offset, field->size) != 0) {
+			return false;
+		}
+		offset += length;
+	}
+	return true;
+}
+
+bool config_journal_format(config_journal_t *journal, const void *config) {
+	const config_journal_flash_t *flash = journal->flash;
+	unsigned int spare = (journal->sector + 1) % CONFIG_JOURNAL_NUM_SECTORS;
+	journal->needs_compaction = true;
+	if (!flash->erase(spare)) {
+		return false;
+	}
+	journal->erase_count++;
+
+	// Write the records before the header so an interrupted format never
+	// leaves a valid-looking journal with missing fields
+	uint32_t end = sizeof(sector_header_t);
+	for (size_t i = 0; i < journal->num_fields; i++) {
+		if (!append(flash, spare, &end, &journal->fields[i], config)) {
+			return false;
+		}
+	}
+
+	sector_header_t header;
+	header.magic = CONFIG_JOURNAL_MAGIC;
+	header.schema_version = journal->schema_version;
+	header.reserved = 0xFFFF;
+	header.erase_count = journal->erase_count;
+	if (!flash->write(spare, 0, (const uint32_t *)&header, sizeof(header))) {
+		return false;
+	}
+	if (!verify(journal, spare, &header, config)) {
+		// Don't let a bad copy, with its higher erase count, be loaded in
+		// preference to the old journal
+		retire(flash, spare);
+		return false;
+	}
+
+	// Only now is the old journal redundant. Should retiring it fail, the new
+	// journal is still loaded first as its erase count is higher.
+	sector_header_t old;
+	if (read_header(flash, journal->sector, &old)) {
+		retire(flash, journal->sector);
+	}
+
+	journal->sector = spare;
+	journal->end = end;
+	journal->needs_compaction = false;
+	return true;
+}
+
+bool config_journal_save(config_journal_t *journal, const void *config,
+                         const void *previous) {
+	if (journal->needs_compaction) {
+		return config_journal_format(journal, config);
+	}
+
+	for (size_t i = 0; i < journal->num_fields; i++) {
+		const config_journal_field_t *field = &journal->fields[i];
+		if (memcmp((const uint8_t *)config + field->offset,
+		           (const uint8_t *)previous + field->offset, field->size) == 0) {
+			continue;
+		}
+		if (!append(journal->flash, journal->sector, &journal->end, field, config)) {
+			// Out of space (or the write failed, leaving the end of the journal
+			// unknown): start afresh
+			return config_journal_format(journal, config);
+		}
+	}
+	return true;
+}
@@ -0,0 +1,125 @@
+#ifndef CONFIG_JOURNAL_H
+#define CONFIG_JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Identifies a sector containing a journal ("TBJ1" in little-endian).
+ */
+#define CONFIG_JOURNAL_MAGIC 0x314A4254ul
+
+/**
+ * The largest field which may be stored (bytes).
+ */
+#define CONFIG_JOURNAL_MAX_FIELD_SIZE 128
+
+/**
+ * Number of flash sectors used: the journal lives in one while the other is
+ * kept spare for compaction.
+ */
+#define CONFIG_JOURNAL_NUM_SECTORS 2
+
+/**
+ * A field of the configuration struct. Each field is stored as a separate
+ * record so only changed fields need be written.
+ *
+ * Field ids must never be reused for a different purpose. Fields may be added
+ * (taking their default value when loading an older journal) and may change
+ * size (being truncated or zero-padded when loaded).
+ */
+typedef struct {
+	// Unique identifier, 0-254
+	uint8_t id;
+
+	// Location within the configuration struct
+	uint16_t offset;
+	uint16_t size;
+} config_journal_field_t;
+
+/**
+ * The flash storage holding the journal: CONFIG_JOURNAL_NUM_SECTORS separately
+ * erasable sectors of size bytes each. Offsets, lengths and buffers passed to
+ * read and write are multiples of 4 bytes. Erased flash reads as 0xFF and
+ * writes may only clear bits.
+ */
+typedef struct {
+	bool (*read)(unsigned int sector, uint32_t offset, uint32_t *data, size_t length);
+	bool (*write)(unsigned int sector, uint32_t offset, const uint32_t *data, size_t length);
+	bool (*erase)(unsigned int sector);
+	size_t size;
+} config_journal_flash_t;
+
+/**
+ * An append-only journal of configuration field records in a flash sector.
+ *
+ * The sector starts with a header (magic number, schema version and erase
+ * count) followed by records, each a field id, length, CRC-32 and value. When
+ * loading, the last valid record for each field wins; records with a bad CRC
+ * (e.g. torn by a power cut) are ignored. Saving appends records for changed
+ * fields only. When the sector is full, every field is written afresh to the
+ * other sector ('compaction'), so erases are spread over many saves.
+ *
+ * Compaction never destroys the only copy of the configuration: the spare
+ * sector is erased and written (header last), then read back and checked
+ * before the old sector's header is cleared. Should power be cut in between,
+ * both sectors hold a journal and the one with the higher erase count is
+ * loaded.
+ *
+ * Initialise with config_journal_init.
+ */
+typedef struct {
+	const config_journal_flash_t *flash;
+	const config_journal_field_t *fields;
+	size_t num_fields;
+
+	// Version of the configuration schema. A journal written with an older
+	// schema is compacted on load.
+	uint16_t schema_version;
+
+	// The sector holding the journal
+	unsigned int sector;
+
+	// Number of times either sector has been erased (as recorded in the
+	// header of the journal)
+	uint32_t erase_count;
+
+	// Offset of the first free byte in the sector
+	uint32_t end;
+
+	// Must the journal be compacted before anything else is appended (e.g.
+	// because it contains garbage)?
+	bool needs_compaction;
+
+	// Number of valid records read by config_journal_load
+	unsigned int num_records;
+} config_journal_t;
+
+void config_journal_init(config_journal_t *journal,
+                         const config_journal_flash_t *flash,
+                         const config_journal_field_t *fields, size_t num_fields,
+                         uint16_t schema_version);
+
+/**
+ * Read the latest value of each field into config from the newest journal.
+ * Fields without a valid record are left untouched, so config should be filled
+ * with defaults first. Returns false if neither sector contains a journal.
+ */
+bool config_journal_load(config_journal_t *journal, void *config);
+
+/**
+ * Append records for every field which differs between config and previous
+ * (the configuration as last loaded or saved). Returns false on a flash error.
+ */
+bool config_journal_save(config_journal_t *journal, const void *config,
+                         const void *previous);
+
+/**
+ * Write a new journal containing every field of config to the spare sector
+ * and, once it has been read back successfully, retire the old journal.
+ * Returns false on a flash error, in which case the old journal is kept.
+ */
+bool config_journal_format(config_journal_t *journal, const void *config);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Update a CRC-32 (IEEE 802.3, as used by zlib) with more data. Start with a
+ * crc of 0.
+ */
+uint32_t crc32_update(uint32_t crc, const void *data, size_t length);
+
+#endif
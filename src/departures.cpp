@@ -0,0 +1,471 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "departures.h"
+
+/**
+ * Lexer states.
+ */
+enum {
+	// Between tokens
+	STATE_STRUCTURE,
+	// Within a string
+	STATE_STRING,
+	// Following a backslash within a string
+	STATE_STRING_ESCAPE,
+	// Reading the hex digits of a \uXXXX escape
+	STATE_STRING_UNICODE,
+	// Within a number, true, false or null
+	STATE_PRIMITIVE,
+	// Malformed input was encountered, all further input is ignored
+	STATE_ERROR,
+};
+
+/**
+ * The fields of a platform record which are captured.
+ */
+enum {
+	FIELD_NONE,
+	FIELD_STATION_LOCATION,
+	FIELD_DEST,
+	FIELD_WAIT,
+};
+
+/**
+ * The deepest nesting of objects and arrays supported (limited by the width of
+ * departures_parser_t.array_levels).
+ */
+static const unsigned char MAX_DEPTH = 31;
+
+void departures_parser_init(departures_parser_t *parser,
+                            departures_record_callback_t callback,
+                            void *callback_data) {
+	memset(parser, 0, sizeof(*parser));
+	parser->state = STATE_STRUCTURE;
+	parser->callback = callback;
+	parser->callback_data = callback_data;
+}
+
+/**
+ * Is the innermost container an array?
+ */
+static bool in_array(const departures_parser_t *parser) {
+	return (parser->array_levels >> parser->depth) & 1;
+}
+
+/**
+ * Is the parser currently reading a key or value at the top level of a record?
+ */
+static bool capturing(const departures_parser_t *parser) {
+	return parser->record_depth != 0 && parser->depth == parser->record_depth;
+}
+
+/**
+ * Append a byte to the key or value being captured (if any).
+ */
+static void append(departures_parser_t *parser, char c) {
+	if (!capturing(parser)) {
+		return;
+	}
+
+	if (parser->string_is_key) {
+		if (parser->key_length < sizeof(parser->key) - 1) {
+			parser->key[parser->key_length++] = c;
+			parser->key[parser->key_length] = '\0';
+		} else {
+			parser->key_overflow = true;
+		}
+	} else if (parser->field != FIELD_NONE) {
+		// Over-long values are silently truncated
+		if (parser->value_length < sizeof(parser->value) - 1) {
+			parser->value[parser->value_length++] = c;
+			parser->value[parser->value_length] = '\0';
+		}
+	}
+}
+
+/**
+ * Append a unicode code point (from a \uXXXX escape) encoded as UTF-8.
+ */
+static void append_unicode(departures_parser_t *parser, unsigned int code_point) {
+	if (code_point < 0x80) {
+		append(parser, code_point);
+	} else if (code_point < 0x800) {
+		append(parser, 0xC0 | (code_point >> 6));
+		append(parser, 0x80 | (code_point & 0x3F));
+	} else {
+		append(parser, 0xE0 | (code_point >> 12));
+		append(parser, 0x80 | ((code_point >> 6) & 0x3F));
+		append(parser, 0x80 | (code_point & 0x3F));
+	}
+}
+
+/**
+ * Reset the key or value buffer ready for a new string or primitive.
+ */
+static void begin_capture(departures_parser_t *parser, bool is_key) {
+	parser->string_is_key = is_key;
+	if (!capturing(parser)) {
+		return;
+	}
+
+	if (is_key) {
+		parser->key[0] = '\0';
+		parser->key_length = 0;
+		parser->key_overflow = false;
+		parser->field = FIELD_NONE;
+	} else {
+		parser->value[0] = '\0';
+		parser->value_length = 0;
+	}
+}
+
+/**
+ * Parse the decimal slot number N of a "DestN" or "WaitN" key. Returns -1 if
+ * the digits aren't a number or the slot isn't captured.
+ */
+static int get_slot(const char *digits, size_t length) {
+	if (length == 0 || length > 3) {
+		return -1;
+	}
+
+	int slot = 0;
+	for (size_t i = 0; i < length; i++) {
+		if (digits[i] < '0' || digits[i] > '9') {
+			return -1;
+		}
+		slot = slot * 10 + (digits[i] - '0');
+	}
+	return slot < DEPARTURES_MAX_DESTINATIONS ? slot : -1;
+}
+
+/**
+ * Called when a complete key has been read. Works out which field of interest
+ * (if any) it names, switching on its length and first byte so that other keys
+ * are rejected after a comparison or two.
+ */
+static void end_key(departures_parser_t *parser) {
+	parser->field = FIELD_NONE;
+	if (!capturing(parser) || parser->key_overflow) {
+		return;
+	}
+
+	const char *key = parser->key;
+	size_t length = parser->key_length;
+	if (length == 15) {
+		if (key[0] == 'S' && memcmp(key, "StationLocation", 15) == 0) {
+			parser->field = FIELD_STATION_LOCATION;
+		}
+		return;
+	}
+	if (length < 5) {
+		return;
+	}
+
+	unsigned char field;
+	const char *prefix;
+	switch (key[0]) {
+		case 'D':
+			field = FIELD_DEST;
+			prefix = "Dest";
+			break;
+		case 'W':
+			field = FIELD_WAIT;
+			prefix = "Wait";
+			break;
+		default:
+			return;
+	}
+	if (memcmp(key, prefix, 4) != 0) {
+		return;
+	}
+
+	int slot = get_slot(key + 4, length - 4);
+	if (slot >= 0) {
+		parser->field = field;
+		parser->field_slot = slot;
+	}
+}
+
+/**
+ * Called when a complete value has been read. Stores the value in the record if
+ * it is one of the fields of interest.
+ */
+static void end_value(departures_parser_t *parser) {
+	if (!capturing(parser)) {
+		return;
+	}
+
+	departures_record_t *record = &parser->record;
+	switch (parser->field) {
+		case FIELD_STATION_LOCATION:
+			memcpy(record->station_location, parser->value, parser->value_length + 1);
+			break;
+		case FIELD_DEST:
+			memcpy(record->destinations[parser->field_slot].name, parser->value,
+			       parser->value_length + 1);
+			break;
+		case FIELD_WAIT:
+			record->destinations[parser->field_slot].wait = atoi(parser->value);
+			break;
+	}
+	parser->field = FIELD_NONE;
+}
+
+/**
+ * Enter a new object or array.
+ */
+static bool push(departures_parser_t *parser, bool is_array) {
+	if (parser->depth >= MAX_DEPTH) {
+		return false;
+	}
+
+	// Objects which are members of arrays are platform records
+	bool is_record = !is_array && parser->record_depth == 0 &&
+	                 parser->depth > 0 && in_array(parser);
+
+	parser->depth++;
+	if (is_array) {
+		parser->array_levels |= 1ul << parser->depth;
+	} else {
+		parser->array_levels &= ~(1ul << parser->depth);
+	}
+	parser->expect_key = !is_array;
+
+	if (is_record) {
+		memset(&parser->record, 0, sizeof(parser->record));
+		parser->record_depth = parser->depth;
+	}
+
+	return true;
+}
+
+/**
+ * Leave the current object or array.
+ */
+static bool pop(departures_parser_t *parser, bool is_array) {
+	if (parser->depth == 0 || in_array(parser) != is_array) {
+		return false;
+	}
+
+	if (parser->depth == parser->record_depth) {
+		parser->record_depth = 0;
+		parser->num_records++;
+		if (parser->callback) {
+			parser->callback(&parser->record, parser->callback_data);
+		}
+	}
+
+	parser->depth--;
+	parser->expect_key = false;
+	return true;
+}
+
+/**
+ * Process a character while between tokens. Returns false on malformed input.
+ */
+static bool feed_structure(departures_parser_t *parser, char c) {
+	switch (c) {
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+			return true;
+
+		case '{':
+			return push(parser, false);
+		case '[':
+			return push(parser, true);
+		case '}':
+			return pop(parser, false);
+		case ']':
+			return pop(parser, true);
+
+		case ':':
+			parser->expect_key = false;
+			return true;
+
+		case ',':
+			parser->expect_key = !in_array(parser);
+			return true;
+
+		case '"':
+			begin_capture(parser, !in_array(parser) && parser->expect_key);
+			parser->state = STATE_STRING;
+			return true;
+
+		default:
+			begin_capture(parser, false);
+			append(parser, c);
+			parser->state = STATE_PRIMITIVE;
+			return true;
+	}
+}
+
+bool departures_parser_feed(departures_parser_t *parser,
+                            const char *data, size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		char c = data[i];
+		switch (parser->state) {
+			case STATE_STRUCTURE:
+				if (!feed_structure(parser, c)) {
+					parser->state = STATE_ERROR;
+				}
+				break;
+
+			case STATE_STRING:
+				if (c == '\\') {
+					parser->state = STATE_STRING_ESCAPE;
+				} else if (c == '"') {
+					if (parser->string_is_key) {
+						end_key(parser);
+					} else {
+						end_value(parser);
+					}
+					parser->state = STATE_STRUCTURE;
+				} else {
+					append(parser, c);
+				}
+				break;
+
+			case STATE_STRING_ESCAPE:
+				parser->state = STATE_STRING;
+				switch (c) {
+					case 'b': append(parser, '\b'); break;
+					case 'f': append(parser, '\f'); break;
+					case 'n': append(parser, '\n'); break;
+					case 'r': append(parser, '\r'); break;
+					case 't': append(parser, '\t'); break;
+					case 'u':
+						parser->unicode_value = 0;
+						parser->unicode_digits = 0;
+						parser->state = STATE_STRING_UNICODE;
+						break;
+					default: append(parser, c); break;
+				}
+				break;
+
+			case STATE_STRING_UNICODE:
+				parser->unicode_value <<= 4;
+				if (c >= '0' && c <= '9') {
+					parser->unicode_value |= c - '0';
+				} else if (c >= 'a' && c <= 'f') {
+					parser->unicode_value |= c - 'a' + 10;
+				} else if (c >= 'A' && c <= 'F') {
+					parser->unicode_value |= c - 'A' + 10;
+				} else {
+					parser->state = STATE_ERROR;
+					break;
+				}
+				if (++parser->unicode_digits == 4) {
+					append_unicode(parser, parser->unicode_value);
+					parser->state = STATE_STRING;
+				}
+				break;
+
+			case STATE_PRIMITIVE:
+				switch (c) {
+					case ',': case '}': case ']': case ':':
+					case ' ': case '\t': case '\r': case '\n':
+						end_value(parser);
+						parser->state = STATE_STRUCTURE;
+						if (!feed_structure(parser, c)) {
+							parser->state = STATE_ERROR;
+						}
+						break;
+
+					default:
+						append(parser, c);
+						break;
+				}
+				break;
+
+			case STATE_ERROR:
+				return false;
+		}
+	}
+
+	return parser->state != STATE_ERROR;
+}
+
+/**
+ * Appends to a fixed-size string buffer, recording whether it overflowed.
+ */
+typedef struct {
+	char *buf;
+	size_t size;
+	size_t length;
+	bool overflow;
+} path_builder_t;
+
+static void path_append(path_builder_t *path, const char *str, bool escape) {
+	static const char HEX_DIGITS[] = "0123456789ABCDEF";
+	for (const unsigned char *c = (const unsigned char *)str; *c; c++) {
+		bool unreserved = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') ||
+		                  (*c >= '0' && *c <= '9') ||
+		                  *c == '-' || *c == '.' || *c == '_' || *c == '~';
+		if (!escape || unreserved) {
+			if (path->length + 1 < path->size) {
+				path->buf[path->length++] = *c;
+			} else {
+				path->overflow = true;
+			}
+		} else {
+			if (path->length + 3 < path->size) {
+				path->buf[path->length++] = '%';
+				path->buf[path->length++] = HEX_DIGITS[*c >> 4];
+				path->buf[path->length++] = HEX_DIGITS[*c & 0xF];
+			} else {
+				path->overflow = true;
+			}
+		}
+	}
+	if (path->size) {
+		path->buf[path->length] = '\0';
+	}
+}
+
+bool departures_build_request_path(char *buf, size_t size, const char *base_path,
+                                   const char *const *stations, size_t num_stations) {
+	path_builder_t path = {buf, size, 0, false};
+	path_append(&path, base_path, false);
+
+	if (num_stations) {
+		// $filter=StationLocation eq 'A' or StationLocation eq 'B' ...
+		path_append(&path, "?$filter=", false);
+		for (size_t i = 0; i < num_stations; i++) {
+			if (i) {
+				path_append(&path, " or ", true);
+			}
+			path_append(&path, "StationLocation eq '", true);
+
+			// Single quotes within OData string literals are doubled
+			for (const char *c = stations[i]; *c; c++) {
+				char chr[2] = {*c, '\0'};
+				path_append(&path, chr, true);
+				if (*c == '\'') {
+					path_append(&path, chr, true);
+				}
+			}
+
+			path_append(&path, "'", true);
+		}
+
+		// $select=StationLocation,Dest0,...,Wait0,...
+		path_append(&path, "&$select=StationLocation", false);
+		for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+			char fields[16];
+			snprintf(fields, sizeof(fields), ",Dest%u,Wait%u", (unsigned)i, (unsigned)i);
+			path_append(&path, fields, false);
+		}
+	}
+
+	return !path.overflow;
+}
+
+bool departures_filter_rejected(int status) {
+	// 400 Bad Request, 414 URI Too Long (the filter makes long paths) and
+	// 501 Not Implemented
+	return status == 400 || status == 414 || status == 501;
+}
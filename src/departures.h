@@ -0,0 +1,134 @@
+#ifndef DEPARTURES_H
+#define DEPARTURES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Number of DestN/WaitN slots captured from each platform record (at most
+ * 255). May be overridden at build time.
+ */
+#ifndef DEPARTURES_MAX_DESTINATIONS
+#define DEPARTURES_MAX_DESTINATIONS 4
+#endif
+
+/**
+ * Size of the buffers (including the null terminator) used to hold station
+ * names. Longer names are truncated.
+ */
+#define DEPARTURES_MAX_NAME_LENGTH 48
+
+/**
+ * Size of the buffer (including the null terminator) used to hold object keys.
+ * Keys which don't fit are ignored.
+ */
+#define DEPARTURES_MAX_KEY_LENGTH 16
+
+/**
+ * The fields of interest from a single platform record in the departures feed.
+ */
+typedef struct {
+	char station_location[DEPARTURES_MAX_NAME_LENGTH];
+
+	struct {
+		// Empty string when no destination was given
+		char name[DEPARTURES_MAX_NAME_LENGTH];
+		int wait;
+	} destinations[DEPARTURES_MAX_DESTINATIONS];
+} departures_record_t;
+
+/**
+ * Called by the parser each time a complete platform record has been parsed.
+ */
+typedef void (*departures_record_callback_t)(const departures_record_t *record,
+                                             void *data);
+
+/**
+ * State of an incremental (push) parser for the departures JSON feed. The
+ * parser is fed arbitrarily sized chunks of the response body and calls a
+ * callback for each platform record (any object which is a member of an
+ * array) found. No heap allocations are made.
+ *
+ * Initialise with departures_parser_init.
+ */
+typedef struct {
+	// Lexer state (see departures.cpp)
+	unsigned char state;
+
+	// Accumulated value of a \uXXXX escape and the number of hex digits read
+	unsigned int unicode_value;
+	unsigned char unicode_digits;
+
+	// Container nesting depth and a bitmap indicating which nesting levels are
+	// arrays (bit N is set when level N is an array).
+	unsigned char depth;
+	unsigned long array_levels;
+
+	// Is the next string in the current object a key?
+	bool expect_key;
+
+	// Is the string currently being read a key?
+	bool string_is_key;
+
+	// Depth of the record being parsed or 0 when not within a record.
+	unsigned char record_depth;
+
+	// The most recent key read at the record's top level.
+	char key[DEPARTURES_MAX_KEY_LENGTH];
+	size_t key_length;
+	bool key_overflow;
+
+	// The field of interest named by the key (see departures.cpp) and, for
+	// DestN and WaitN, N. Values of other fields are not captured.
+	unsigned char field;
+	unsigned char field_slot;
+
+	// The value of interest currently being read at the record's top level.
+	char value[DEPARTURES_MAX_NAME_LENGTH];
+	size_t value_length;
+
+	// The record currently being parsed
+	departures_record_t record;
+
+	departures_record_callback_t callback;
+	void *callback_data;
+
+	// Number of records passed to the callback so far
+	size_t num_records;
+} departures_parser_t;
+
+/**
+ * Prepare a parser for a new response body.
+ */
+void departures_parser_init(departures_parser_t *parser,
+                            departures_record_callback_t callback,
+                            void *callback_data);
+
+/**
+ * Feed the next chunk of the response body into the parser. Records may be
+ * split across any number of chunks. Returns false if malformed JSON was
+ * encountered, after which the parser ignores further input.
+ */
+bool departures_parser_feed(departures_parser_t *parser,
+                            const char *data, size_t length);
+
+/**
+ * Build the path (including query string) of a request for the departures feed
+ * at base_path into buf. If num_stations is non-zero, an OData $filter
+ * restricting the response to platform records at the named stations and a
+ * $select of just the fields used by the parser are added. Returns false if the
+ * path does not fit in buf.
+ */
+bool departures_build_request_path(char *buf, size_t size, const char *base_path,
+                                   const char *const *stations, size_t num_stations);
+
+/**
+ * Does the HTTP status of a response to a filtered request (see
+ * departures_build_request_path) mean that the server doesn't support the
+ * filter, rather than that the request failed for some other, possibly
+ * transient, reason (such as 429 Too Many Requests or 503 Service
+ * Unavailable)?
+ */
+bool departures_filter_rejected(int status);
+
+#endif
@@ -0,0 +1,126 @@
+#include <string.h>
+
+#include "departures_binary.h"
+#include "metrolink_map.h"
+
+// Station indices must fit in a byte
+#if NUM_METROLINK_STATIONS > 256
+#error "Too many stations for the binary departures format"
+#endif
+
+/**
+ * Decoder states.
+ */
+enum {
+	STATE_HEADER,
+	// Reading each field of a record
+	STATE_STATION,
+	STATE_COUNT,
+	STATE_DESTINATION,
+	STATE_WAIT,
+	// All records have been read
+	STATE_DONE,
+	// Malformed input was encountered, all further input is ignored
+	STATE_ERROR,
+};
+
+void departures_binary_init(departures_binary_t *decoder,
+                            departures_binary_callback_t callback,
+                            void *callback_data) {
+	memset(decoder, 0, sizeof(*decoder));
+	decoder->state = STATE_HEADER;
+	decoder->callback = callback;
+	decoder->callback_data = callback_data;
+}
+
+/**
+ * Check the complete header and start reading records.
+ */
+static void process_header(departures_binary_t *decoder) {
+	const uint8_t *header = decoder->header;
+	uint32_t stations_crc = (uint32_t)header[3] | ((uint32_t)header[4] << 8) |
+	                        ((uint32_t)header[5] << 16) | ((uint32_t)header[6] << 24);
+	if (header[0] != 'T' || header[1] != 'D' || header[2] != DEPARTURES_BINARY_VERSION ||
+	    stations_crc != METROLINK_STATIONS_CRC) {
+		decoder->state = STATE_ERROR;
+		return;
+	}
+	decoder->expected_records = header[7] | (header[8] << 8);
+	decoder->state = decoder->expected_records ? STATE_STATION : STATE_DONE;
+}
+
+/**
+ * Pass the current record to the callback and move on to the next.
+ */
+static void end_record(departures_binary_t *decoder) {
+	decoder->callback(&decoder->record, decoder->callback_data);
+	decoder->num_records++;
+	decoder->state = decoder->num_records < decoder->expected_records ? STATE_STATION : STATE_DONE;
+}
+
+bool departures_binary_feed(departures_binary_t *decoder, const char *data, size_t length) {
+	for (size_t i = 0; i < length && decoder->state != STATE_ERROR; i++) {
+		uint8_t byte = (uint8_t)data[i];
+		switch (decoder->state) {
+			case STATE_HEADER:
+				decoder->header[decoder->header_length++] = byte;
+				if (decoder->header_length == DEPARTURES_BINARY_HEADER_SIZE) {
+					process_header(decoder);
+				}
+				break;
+
+			case STATE_STATION:
+				if (byte >= NUM_METROLINK_STATIONS) {
+					decoder->state = STATE_ERROR;
+					break;
+				}
+				decoder->record.station_index = byte;
+				decoder->record.num_destinations = 0;
+				decoder->state = STATE_COUNT;
+				break;
+
+			case STATE_COUNT:
+				decoder->remaining = byte;
+				if (decoder->remaining) {
+					decoder->state = STATE_DESTINATION;
+				} else {
+					end_record(decoder);
+				}
+				break;
+
+			case STATE_DESTINATION:
+				if (byte >= NUM_METROLINK_STATIONS) {
+					decoder->state = STATE_ERROR;
+					break;
+				}
+				decoder->destination = byte;
+				decoder->state = STATE_WAIT;
+				break;
+
+			case STATE_WAIT: {
+				departures_binary_record_t *record = &decoder->record;
+				if (record->num_destinations < DEPARTURES_MAX_DESTINATIONS) {
+					record->destinations[record->num_destinations].station_index = decoder->destination;
+					record->destinations[record->num_destinations].wait = byte;
+					record->num_destinations++;
+				}
+				if (--decoder->remaining) {
+					decoder->state = STATE_DESTINATION;
+				} else {
+					end_record(decoder);
+				}
+				break;
+			}
+
+			default:
+				// Data after the last record
+				decoder->state = STATE_ERROR;
+				break;
+		}
+	}
+	return decoder->state != STATE_ERROR;
+}
+
+bool departures_binary_done(const departures_binary_t *decoder) {
+	return decoder->state == STATE_DONE;
+}
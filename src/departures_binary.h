@@ -0,0 +1,103 @@
+#ifndef DEPARTURES_BINARY_H
+#define DEPARTURES_BINARY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "departures.h"
+
+/**
+ * A compact binary encoding of the departures feed, served by the proxy (see
+ * proxy/) to devices listing DEPARTURES_BINARY_CONTENT_TYPE in their Accept
+ * header. Stations are given by their indices in metrolink_map.txt, so
+ * decoding involves no string handling at all. Integers are little-endian.
+ *
+ *   Header (DEPARTURES_BINARY_HEADER_SIZE bytes):
+ *     magic        2 bytes  "TD"
+ *     version      1 byte   DEPARTURES_BINARY_VERSION
+ *     stations_crc 4 bytes  METROLINK_STATIONS_CRC of the numbering used
+ *     num_records  2 bytes
+ *   Then num_records platform records, each:
+ *     station      1 byte   station index
+ *     count        1 byte   number of departures
+ *     count times:
+ *       destination 1 byte  station index
+ *       wait        1 byte  minutes (capped at 255)
+ *
+ * Departures to destinations missing from metrolink_map.txt, and records at
+ * such stations, are left out.
+ */
+#define DEPARTURES_BINARY_CONTENT_TYPE "application/x-trambox-departures"
+#define DEPARTURES_BINARY_VERSION 1
+#define DEPARTURES_BINARY_HEADER_SIZE 9
+
+/**
+ * A platform record from the binary format.
+ */
+typedef struct {
+	int station_index;
+
+	size_t num_destinations;
+	struct {
+		int station_index;
+		int wait;
+	} destinations[DEPARTURES_MAX_DESTINATIONS];
+} departures_binary_record_t;
+
+/**
+ * Called by the decoder each time a complete platform record has been read.
+ */
+typedef void (*departures_binary_callback_t)(const departures_binary_record_t *record,
+                                             void *data);
+
+/**
+ * State of an incremental (push) decoder for the binary departures format. As
+ * with departures_parser_t, it is fed arbitrarily sized chunks of the response
+ * body and calls a callback for each record. Departures beyond the first
+ * DEPARTURES_MAX_DESTINATIONS of a record are skipped.
+ *
+ * Initialise with departures_binary_init.
+ */
+typedef struct {
+	// Decoder state (see departures_binary.cpp)
+	unsigned char state;
+
+	uint8_t header[DEPARTURES_BINARY_HEADER_SIZE];
+	size_t header_length;
+
+	// Records given by the header and the number read so far
+	size_t expected_records;
+	size_t num_records;
+
+	// Departures still to be read in the current record, and the current
+	// departure's destination
+	size_t remaining;
+	int destination;
+
+	departures_binary_record_t record;
+
+	departures_binary_callback_t callback;
+	void *callback_data;
+} departures_binary_t;
+
+/**
+ * Prepare a decoder for a new response body.
+ */
+void departures_binary_init(departures_binary_t *decoder,
+                            departures_binary_callback_t callback,
+                            void *callback_data);
+
+/**
+ * Feed the next chunk of the response body into the decoder. Returns false if
+ * the body is malformed, uses another version or station numbering, or
+ * continues past the last record, after which further input is ignored.
+ */
+bool departures_binary_feed(departures_binary_t *decoder, const char *data, size_t length);
+
+/**
+ * Have all the records given by the header been read?
+ */
+bool departures_binary_done(const departures_binary_t *decoder);
+
+#endif
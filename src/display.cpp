@@ -0,0 +1,197 @@
+#include "display.h"
+
+/**
+ * Number of steps in a full cycle of the wobble (each step 0.314 radians).
+ */
+static const uint8_t WOBBLE_STEPS = 20;
+
+/**
+ * DISPLAY_WOBBLE_MAGNITUDE * sin(step * 0.314), rounded.
+ */
+static const int16_t WOBBLE_OFFSETS[WOBBLE_STEPS] = {
+	0, 93, 176, 243, 285, 300, 285, 243, 177, 93,
+	0, -92, -176, -242, -285, -300, -286, -243, -177, -94,
+};
+
+/**
+ * The phase at which wobbling starts after a countdown runs out (the bottom
+ * of the swing).
+ */
+static const uint8_t WOBBLE_START_PHASE = 15;
+
+void display_init(display_t *display, const int pwm_values[DISPLAY_MAX_VALUE + 1]) {
+	display_set_calibration(display, pwm_values);
+	display->wobble_phase = 0;
+	display->reported_wait = 0;
+	display_show_error(display);
+}
+
+void display_set_calibration(display_t *display,
+                             const int pwm_values[DISPLAY_MAX_VALUE + 1]) {
+	// Fit a monotone cubic Hermite spline through the points. The tangent at
+	// each interior point is the harmonic mean of the adjacent secants (or
+	// zero at a local extremum) which guarantees no overshoot (Fritsch and
+	// Butland, 1984).
+	float tangents[DISPLAY_MAX_VALUE + 1];
+	for (int i = 0; i <= DISPLAY_MAX_VALUE; i++) {
+		float before = i > 0 ? pwm_values[i] - pwm_values[i - 1] : 0;
+		float after = i < DISPLAY_MAX_VALUE ? pwm_values[i + 1] - pwm_values[i] : 0;
+		if (i == 0) {
+			tangents[i] = after;
+		} else if (i == DISPLAY_MAX_VALUE) {
+			tangents[i] = before;
+		} else if (before * after > 0) {
+			tangents[i] = (2 * before * after) / (before + after);
+		} else {
+			tangents[i] = 0;
+		}
+	}
+
+	const int entries_per_minute = DISPLAY_UNITS_PER_MINUTE >> DISPLAY_CURVE_SHIFT;
+	for (int i = 0; i < DISPLAY_CURVE_LENGTH; i++) {
+		int minute = i / entries_per_minute;
+		if (minute == DISPLAY_MAX_VALUE) {
+			display->curve[i] = pwm_values[minute];
+			continue;
+		}
+
+		float t = (float)(i % entries_per_minute) / entries_per_minute;
+		float t2 = t * t;
+		float t3 = t2 * t;
+		float pwm = (2 * t3 - 3 * t2 + 1) * pwm_values[minute] +
+		            (t3 - 2 * t2 + t) * tangents[minute] +
+		            (-2 * t3 + 3 * t2) * pwm_values[minute + 1] +
+		            (t3 - t2) * tangents[minute + 1];
+		display->curve[i] = pwm > 0 ? (uint16_t)(pwm + 0.5f) : 0;
+	}
+}
+
+void display_show_error(display_t *display) {
+	display->value = DISPLAY_WOBBLE_MAGNITUDE;
+	display->wobble = true;
+	display->auto_decrement = false;
+}
+
+void display_show_value(display_t *display, int minutes) {
+	display->value = minutes * DISPLAY_UNITS_PER_MINUTE;
+	display->wobble = false;
+	display->auto_decrement = false;
+}
+
+void display_show_wait(display_t *display, int wait, unsigned long elapsed_ms) {
+	// Clamp to a reasonable size
+	unsigned long elapsed = elapsed_ms / DISPLAY_UPDATE_INTERVAL_MS;
+	if (elapsed > DISPLAY_UNITS_PER_MINUTE + DISPLAY_WOBBLE_MAGNITUDE) {
+		elapsed = DISPLAY_UNITS_PER_MINUTE + DISPLAY_WOBBLE_MAGNITUDE;
+	}
+
+	display->reported_wait = wait * DISPLAY_UNITS_PER_MINUTE;
+	display->value = display->reported_wait - (int32_t)elapsed;
+	display->wobble = false;
+	display->auto_decrement = true;
+}
+
+int display_update(display_t *display) {
+	// Auto-decrement the time displayed
+	if (display->auto_decrement) {
+		display->value--;
+
+		if (display->value < display->reported_wait -
+		                      (DISPLAY_UNITS_PER_MINUTE + DISPLAY_WOBBLE_MAGNITUDE)) {
+			// Maximum deviation from the reported time reached, start wobbling
+			display->auto_decrement = false;
+			display->wobble = true;
+
+			// Start the wobble from where we are and centered on the 'next'
+			// expected minute
+			display->value = display->reported_wait;
+			display->wobble_phase = WOBBLE_START_PHASE;
+		}
+	}
+
+	// Wobble the value if required
+	int32_t value = display->value;
+	if (display->wobble) {
+		value += WOBBLE_OFFSETS[display->wobble_phase];
+
+		// NB: After the first cycle the phase only covers the second half of
+		// the cycle, so the needle only wobbles below the value.
+		if (++display->wobble_phase >= WOBBLE_STEPS) {
+			display->wobble_phase -= WOBBLE_STEPS / 2;
+		}
+	} else {
+		display->wobble_phase = 0;
+	}
+
+	// Clamp the value to the displayable range
+	if (value < 0) {
+		value = 0;
+	} else if (value > DISPLAY_MAX_VALUE * DISPLAY_UNITS_PER_MINUTE) {
+		value = DISPLAY_MAX_VALUE * DISPLAY_UNITS_PER_MINUTE;
+	}
+
+	return display->curve[value >> DISPLAY_CURVE_SHIFT];
+}
+
+/**
+ * The wobble phase after advancing n steps from phase.
+ */
+static uint8_t advance_wobble_phase(uint8_t phase, uint32_t n) {
+	if (n < (uint32_t)(WOBBLE_STEPS - phase)) {
+		return phase + n;
+	}
+	// Wrapped into the second half of the cycle
+	const uint8_t half = WOBBLE_STEPS / 2;
+	return half + (uint8_t)((phase - half + n) % half);
+}
+
+void display_advance(display_t *display, uint32_t updates) {
+	if (updates == 0) {
+		return;
+	}
+
+	if (display->auto_decrement) {
+		// Updates until the value drops below the threshold and the wobble
+		// starts (the update which starts it also takes a wobble step)
+		int32_t threshold = display->reported_wait -
+		                    (DISPLAY_UNITS_PER_MINUTE + DISPLAY_WOBBLE_MAGNITUDE);
+		uint32_t until_wobble = display->value >= threshold
+		                        ? (uint32_t)(display->value - threshold) + 1 : 1;
+		if (updates < until_wobble) {
+			display->value -= (int32_t)updates;
+			display->wobble_phase = 0;
+			return;
+		}
+
+		display->auto_decrement = false;
+		display->wobble = true;
+		display->value = display->reported_wait;
+		display->wobble_phase = WOBBLE_START_PHASE;
+		updates -= until_wobble - 1;
+	}
+
+	if (display->wobble) {
+		display->wobble_phase = advance_wobble_phase(display->wobble_phase, updates);
+	} else {
+		display->wobble_phase = 0;
+	}
+}
+
+void display_save_state(const display_t *display, display_state_t *state) {
+	state->value = display->value;
+	state->reported_wait = display->reported_wait;
+	state->wobble = display->wobble;
+	state->wobble_phase = display->wobble_phase;
+	state->auto_decrement = display->auto_decrement;
+	state->reserved = 0;
+}
+
+void display_restore_state(display_t *display, const display_state_t *state,
+                           uint32_t elapsed_updates) {
+	display->value = state->value;
+	display->reported_wait = state->reported_wait;
+	display->wobble = state->wobble;
+	display->wobble_phase = state->wobble_phase % WOBBLE_STEPS;
+	display->auto_decrement = state->auto_decrement;
+	display_advance(display, elapsed_updates);
+}
@@ -0,0 +1,135 @@
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The largest number of minutes which can be displayed.
+ */
+#define DISPLAY_MAX_VALUE 12
+
+/**
+ * Interval between display updates (milliseconds).
+ */
+#define DISPLAY_UPDATE_INTERVAL_MS 100
+
+/**
+ * Displayed values are fixed-point numbers of minutes, in units of the amount
+ * the display counts down by each update.
+ */
+#define DISPLAY_UNITS_PER_MINUTE (60 * 1000 / DISPLAY_UPDATE_INTERVAL_MS)
+
+/**
+ * The maximum distance the needle may wobble from its nominal position (half
+ * a minute).
+ */
+#define DISPLAY_WOBBLE_MAGNITUDE (DISPLAY_UNITS_PER_MINUTE / 2)
+
+/**
+ * The calibration curve has an entry every 2^DISPLAY_CURVE_SHIFT units (i.e.
+ * 75 per minute). This must divide DISPLAY_UNITS_PER_MINUTE so that every
+ * minute mark has an entry.
+ */
+#define DISPLAY_CURVE_SHIFT 3
+#define DISPLAY_CURVE_LENGTH \
+	(((DISPLAY_MAX_VALUE * DISPLAY_UNITS_PER_MINUTE) >> DISPLAY_CURVE_SHIFT) + 1)
+
+/**
+ * State of the needle animation. Call display_update every
+ * DISPLAY_UPDATE_INTERVAL_MS to get the PWM value to output.
+ *
+ * display_update uses no floating point arithmetic (the ESP8266 has no FPU and
+ * it is called from a timer) and no interpolation: the PWM value for every
+ * position is looked up in a precomputed calibration curve.
+ *
+ * Initialise with display_init.
+ */
+typedef struct {
+	// The value to be shown on the display (DISPLAY_UNITS_PER_MINUTE units)
+	int32_t value;
+
+	// Should the needle wobble around the current value?
+	bool wobble;
+
+	// Index into the wobble sine table
+	uint8_t wobble_phase;
+
+	// Should the value be gradually reduced (by 1 minute per minute)? Once it
+	// falls more than 1+DISPLAY_WOBBLE_MAGNITUDE below reported_wait, the
+	// display starts wobbling around reported_wait instead.
+	bool auto_decrement;
+	int32_t reported_wait;
+
+	// The PWM value for every 2^DISPLAY_CURVE_SHIFT units
+	uint16_t curve[DISPLAY_CURVE_LENGTH];
+} display_t;
+
+/**
+ * The animation state of a display_t without its calibration curve (e.g. to
+ * keep in the RTC memory across a reset).
+ */
+typedef struct {
+	int32_t value;
+	int32_t reported_wait;
+	uint8_t wobble;
+	uint8_t wobble_phase;
+	uint8_t auto_decrement;
+	uint8_t reserved;
+} display_state_t;
+
+/**
+ * Prepare the display, initially showing an error. See
+ * display_set_calibration.
+ */
+void display_init(display_t *display, const int pwm_values[DISPLAY_MAX_VALUE + 1]);
+
+/**
+ * Set the PWM values which make the display show each whole number of minutes
+ * from 0 to DISPLAY_MAX_VALUE (inclusive). The calibration curve is rebuilt
+ * by fitting a smooth curve through these points which never overshoots them
+ * (so is monotone where they are).
+ */
+void display_set_calibration(display_t *display,
+                             const int pwm_values[DISPLAY_MAX_VALUE + 1]);
+
+/**
+ * Indicate a problem by bouncing the needle around between 0 and 1.
+ */
+void display_show_error(display_t *display);
+
+/**
+ * Hold the needle steady at a number of minutes (e.g. during calibration).
+ */
+void display_show_value(display_t *display, int minutes);
+
+/**
+ * Count down from the reported wait (in minutes), starting elapsed_ms into
+ * the countdown.
+ */
+void display_show_wait(display_t *display, int wait, unsigned long elapsed_ms);
+
+/**
+ * Advance the animation by one update and return the PWM value to output.
+ */
+int display_update(display_t *display);
+
+/**
+ * Advance the animation by a number of updates at once, exactly as if
+ * display_update had been called that many times.
+ */
+void display_advance(display_t *display, uint32_t updates);
+
+/**
+ * Copy the animation state of a display.
+ */
+void display_save_state(const display_t *display, display_state_t *state);
+
+/**
+ * Continue an animation saved by display_save_state, elapsed_updates after it
+ * was saved.
+ */
+void display_restore_state(display_t *display, const display_state_t *state,
+                           uint32_t elapsed_updates);
+
+#endif
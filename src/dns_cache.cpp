@@ -0,0 +1,34 @@
+#include "dns_cache.h"
+
+void dns_cache_init(dns_cache_t *cache) {
+	cache->valid = false;
+	cache->address = 0;
+	cache->store_time = 0;
+	cache->ttl = 0;
+}
+
+void dns_cache_store(dns_cache_t *cache, unsigned long now, uint32_t address,
+                     uint32_t ttl) {
+	if (ttl < DNS_CACHE_MIN_TTL) {
+		ttl = DNS_CACHE_MIN_TTL;
+	} else if (ttl > DNS_CACHE_MAX_TTL) {
+		ttl = DNS_CACHE_MAX_TTL;
+	}
+	cache->valid = true;
+	cache->address = address;
+	cache->store_time = now;
+	cache->ttl = ttl * 1000ul;
+}
+
+dns_cache_state_t dns_cache_get(const dns_cache_t *cache, unsigned long now,
+                                uint32_t *address) {
+	if (!cache->valid) {
+		return DNS_CACHE_EMPTY;
+	}
+	*address = cache->address;
+	return now - cache->store_time < cache->ttl ? DNS_CACHE_FRESH : DNS_CACHE_STALE;
+}
+
+bool dns_cache_refresh_due(const dns_cache_t *cache, unsigned long now) {
+	return cache->valid && now - cache->store_time >= cache->ttl / 4 * 3;
+}
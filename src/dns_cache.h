@@ -0,0 +1,68 @@
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Bounds applied to TTLs (seconds) given by the DNS server.
+ */
+#define DNS_CACHE_MIN_TTL 30
+#define DNS_CACHE_MAX_TTL 86400
+
+/**
+ * The state of a cached address.
+ */
+typedef enum {
+	// Nothing has been cached
+	DNS_CACHE_EMPTY,
+	// Within its TTL
+	DNS_CACHE_FRESH,
+	// Expired, but may still be used if it can't be looked up again
+	DNS_CACHE_STALE,
+} dns_cache_state_t;
+
+/**
+ * The address of a single host, kept for its TTL and afterwards as the
+ * last-known-good address. A refresh is due once three quarters of the TTL
+ * have elapsed, so a lookup made in the background normally replaces the
+ * address before it expires.
+ *
+ * Times are in milliseconds (as returned by millis()). Initialise with
+ * dns_cache_init.
+ */
+typedef struct {
+	bool valid;
+
+	// In network byte order (as used by lwIP and IPAddress)
+	uint32_t address;
+
+	// When the address was stored and for how long it is fresh
+	unsigned long store_time;
+	unsigned long ttl;
+} dns_cache_t;
+
+/**
+ * Start with an empty cache.
+ */
+void dns_cache_init(dns_cache_t *cache);
+
+/**
+ * Cache an address which was just looked up, with its TTL (seconds).
+ */
+void dns_cache_store(dns_cache_t *cache, unsigned long now, uint32_t address,
+                     uint32_t ttl);
+
+/**
+ * Get the cached address (if any) and whether it has expired.
+ */
+dns_cache_state_t dns_cache_get(const dns_cache_t *cache, unsigned long now,
+                                uint32_t *address);
+
+/**
+ * Should the address be looked up again? True once the address is near the end
+ * of its TTL (or has expired).
+ */
+bool dns_cache_refresh_due(const dns_cache_t *cache, unsigned long now);
+
+#endif
@@ -0,0 +1,143 @@
+#include <string.h>
+
+#include "dns_message.h"
+
+static const size_t HEADER_SIZE = 12;
+
+static const uint16_t FLAG_RESPONSE = 0x8000;
+static const uint16_t FLAG_RECURSION_DESIRED = 0x0100;
+static const uint16_t RCODE_MASK = 0x000F;
+
+static const uint16_t TYPE_A = 1;
+static const uint16_t CLASS_IN = 1;
+
+static uint16_t read_u16(const uint8_t *p) {
+	return ((uint16_t)p[0] << 8) | p[1];
+}
+
+static uint32_t read_u32(const uint8_t *p) {
+	return ((uint32_t)read_u16(p) << 16) | read_u16(p + 2);
+}
+
+static void write_u16(uint8_t *p, uint16_t value) {
+	p[0] = value >> 8;
+	p[1] = value & 0xFF;
+}
+
+size_t dns_message_build_query(uint8_t *buf, size_t size, uint16_t id, const char *name) {
+	// Header, name (a length byte per label plus the terminating zero), type
+	// and class
+	size_t name_length = strlen(name);
+	size_t length = HEADER_SIZE + name_length + 2 + 4;
+	if (name_length == 0 || name_length > 253 || length > size) {
+		return 0;
+	}
+
+	memset(buf, 0, HEADER_SIZE);
+	write_u16(buf, id);
+	write_u16(buf + 2, FLAG_RECURSION_DESIRED);
+	write_u16(buf + 4, 1);
+
+	uint8_t *p = buf + HEADER_SIZE;
+	while (true) {
+		const char *dot = strchr(name, '.');
+		size_t label_length = dot ? (size_t)(dot - name) : strlen(name);
+		if (label_length == 0 || label_length > 63) {
+			return 0;
+		}
+		*p++ = label_length;
+		memcpy(p, name, label_length);
+		p += label_length;
+		if (!dot) {
+			break;
+		}
+		name = dot + 1;
+	}
+	*p++ = 0;
+
+	write_u16(p, TYPE_A);
+	write_u16(p + 2, CLASS_IN);
+	return length;
+}
+
+/**
+ * Skip over a (possibly compressed) name starting at offset. Returns the offset
+ * following it or 0 if it runs off the end of the message.
+ */
+static size_t skip_name(const uint8_t *buf, size_t length, size_t offset) {
+	while (offset < length) {
+		uint8_t label_length = buf[offset];
+		if (label_length == 0) {
+			return offset + 1;
+		} else if ((label_length & 0xC0) == 0xC0) {
+			// A pointer elsewhere ends the name
+			return offset + 2 <= length ? offset + 2 : 0;
+		} else if (label_length & 0xC0) {
+			return 0;
+		}
+		offset += 1 + label_length;
+	}
+	return 0;
+}
+
+dns_message_result_t dns_message_parse_response(const uint8_t *buf, size_t length,
+                                                uint16_t id, uint32_t *address,
+                                                uint32_t *ttl) {
+	if (length < HEADER_SIZE) {
+		return DNS_MESSAGE_MALFORMED;
+	}
+
+	uint16_t flags = read_u16(buf + 2);
+	if (read_u16(buf) != id || !(flags & FLAG_RESPONSE)) {
+		return DNS_MESSAGE_MISMATCH;
+	}
+	if (flags & RCODE_MASK) {
+		return DNS_MESSAGE_NO_ADDRESS;
+	}
+
+	size_t num_questions = read_u16(buf + 4);
+	size_t num_answers = read_u16(buf + 6);
+
+	size_t offset = HEADER_SIZE;
+	for (size_t i = 0; i < num_questions; i++) {
+		offset = skip_name(buf, length, offset);
+		if (!offset || offset + 4 > length) {
+			return DNS_MESSAGE_MALFORMED;
+		}
+		offset += 4;
+	}
+
+	// The answer may lead to the address through CNAMEs, any of which may
+	// expire first
+	uint32_t min_ttl = UINT32_MAX;
+	for (size_t i = 0; i < num_answers; i++) {
+		offset = skip_name(buf, length, offset);
+		if (!offset || offset + 10 > length) {
+			return DNS_MESSAGE_MALFORMED;
+		}
+		uint16_t type = read_u16(buf + offset);
+		uint16_t class_ = read_u16(buf + offset + 2);
+		uint32_t record_ttl = read_u32(buf + offset + 4);
+		size_t data_length = read_u16(buf + offset + 8);
+		offset += 10;
+		if (offset + data_length > length) {
+			return DNS_MESSAGE_MALFORMED;
+		}
+
+		if (record_ttl > 0x7FFFFFFF) {
+			// TTLs are signed, negative ones mean "don't cache"
+			record_ttl = 0;
+		}
+		if (record_ttl < min_ttl) {
+			min_ttl = record_ttl;
+		}
+		if (type == TYPE_A && class_ == CLASS_IN && data_length == 4) {
+			memcpy(address, buf + offset, 4);
+			*ttl = min_ttl;
+			return DNS_MESSAGE_OK;
+		}
+		offset += data_length;
+	}
+
+	return DNS_MESSAGE_NO_ADDRESS;
+}
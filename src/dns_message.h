@@ -0,0 +1,48 @@
+#ifndef DNS_MESSAGE_H
+#define DNS_MESSAGE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Encoding of DNS queries for a host's IPv4 address (A record) and decoding of
+ * the responses (RFC 1035), including the TTL which lwIP's resolver doesn't
+ * expose.
+ */
+
+/**
+ * Largest DNS message sent or received over UDP.
+ */
+#define DNS_MESSAGE_MAX_SIZE 512
+
+/**
+ * The outcome of decoding a response.
+ */
+typedef enum {
+	// An address was found
+	DNS_MESSAGE_OK,
+	// Not a response to the query (wrong id or not a response): ignore it
+	DNS_MESSAGE_MISMATCH,
+	// The server reported an error or the name has no IPv4 address
+	DNS_MESSAGE_NO_ADDRESS,
+	// The response could not be decoded
+	DNS_MESSAGE_MALFORMED,
+} dns_message_result_t;
+
+/**
+ * Write a recursive query with the given id for the A record of name into buf.
+ * Returns the length of the query or 0 if it doesn't fit (or name is invalid).
+ */
+size_t dns_message_build_query(uint8_t *buf, size_t size, uint16_t id, const char *name);
+
+/**
+ * Decode a response to the query with the given id. On success, sets address
+ * (in network byte order, as used by lwIP and IPAddress) to the first IPv4
+ * address in the answer and ttl to the smallest TTL (seconds) of the records
+ * leading to it (e.g. through CNAMEs).
+ */
+dns_message_result_t dns_message_parse_response(const uint8_t *buf, size_t length,
+                                                uint16_t id, uint32_t *address,
+                                                uint32_t *ttl);
+
+#endif
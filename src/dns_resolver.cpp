@@ -0,0 +1,163 @@
+#include <string.h>
+
+#include <ESP8266WiFi.h>
+
+#include "dns_resolver.h"
+#include "dns_message.h"
+
+static const uint16_t DNS_PORT = 53;
+
+void dns_resolver_init(dns_resolver_t *resolver, const char *host) {
+	resolver->host = host;
+	dns_cache_init(&resolver->cache);
+	resolver->querying = false;
+	resolver->query_id = 0;
+	resolver->attempts = 0;
+	resolver->attempt_time = 0;
+	resolver->failed = false;
+	resolver->retry_time = 0;
+	resolver->waiting = false;
+	memset(&resolver->stats, 0, sizeof(resolver->stats));
+}
+
+/**
+ * End the query in progress.
+ */
+static void finish_query(dns_resolver_t *resolver, unsigned long now, bool ok) {
+	resolver->udp.stop();
+	resolver->querying = false;
+	resolver->failed = !ok;
+	if (!ok) {
+		resolver->stats.failures++;
+		resolver->retry_time = now + DNS_RESOLVER_RETRY_INTERVAL;
+	}
+}
+
+/**
+ * (Re)send the query in progress, from a new random port.
+ */
+static void send_query(dns_resolver_t *resolver, unsigned long now) {
+	resolver->attempts++;
+	resolver->attempt_time = now;
+
+	uint8_t query[DNS_MESSAGE_MAX_SIZE / 2];
+	size_t length = dns_message_build_query(query, sizeof(query),
+	                                        resolver->query_id, resolver->host);
+	if (!length) {
+		finish_query(resolver, now, false);
+		return;
+	}
+
+	resolver->udp.stop();
+	resolver->udp.begin(DNS_RESOLVER_MIN_LOCAL_PORT +
+	                    ESP.random() % DNS_RESOLVER_NUM_LOCAL_PORTS);
+	// A lost packet is handled like a lost response
+	if (resolver->udp.beginPacket(WiFi.dnsIP(), DNS_PORT)) {
+		resolver->udp.write(query, length);
+		resolver->udp.endPacket();
+	}
+}
+
+static void start_query(dns_resolver_t *resolver, unsigned long now) {
+	resolver->querying = true;
+	resolver->query_id = ESP.random();
+	resolver->attempts = 0;
+	resolver->stats.queries++;
+	send_query(resolver, now);
+}
+
+/**
+ * Process any responses to the query in progress and retransmit it (or give up)
+ * if none has arrived in time.
+ */
+static void receive(dns_resolver_t *resolver, unsigned long now) {
+	uint8_t buf[DNS_MESSAGE_MAX_SIZE];
+	while (resolver->udp.parsePacket()) {
+		if (resolver->udp.remoteIP() != WiFi.dnsIP() ||
+		    resolver->udp.remotePort() != DNS_PORT) {
+			continue;
+		}
+		int length = resolver->udp.read(buf, sizeof(buf));
+		if (length <= 0) {
+			continue;
+		}
+
+		uint32_t address;
+		uint32_t ttl;
+		switch (dns_message_parse_response(buf, length, resolver->query_id, &address, &ttl)) {
+			case DNS_MESSAGE_OK:
+				dns_cache_store(&resolver->cache, now, address, ttl);
+				finish_query(resolver, now, true);
+				return;
+			case DNS_MESSAGE_MISMATCH:
+				break;
+			case DNS_MESSAGE_NO_ADDRESS:
+			case DNS_MESSAGE_MALFORMED:
+				finish_query(resolver, now, false);
+				return;
+		}
+	}
+
+	if (now - resolver->attempt_time >= DNS_RESOLVER_QUERY_TIMEOUT) {
+		if (resolver->attempts < DNS_RESOLVER_ATTEMPTS) {
+			send_query(resolver, now);
+		} else {
+			finish_query(resolver, now, false);
+		}
+	}
+}
+
+/**
+ * May a new query be started now (i.e. not too soon after one failed)?
+ */
+static bool may_query(const dns_resolver_t *resolver, unsigned long now) {
+	return !resolver->failed || (long)(now - resolver->retry_time) >= 0;
+}
+
+void dns_resolver_poll(dns_resolver_t *resolver) {
+	unsigned long now = millis();
+	if (resolver->querying) {
+		receive(resolver, now);
+	} else if (dns_cache_refresh_due(&resolver->cache, now) && may_query(resolver, now) &&
+	           WiFi.status() == WL_CONNECTED) {
+		start_query(resolver, now);
+	}
+}
+
+dns_resolver_result_t dns_resolver_lookup(dns_resolver_t *resolver, IPAddress *address) {
+	dns_resolver_poll(resolver);
+
+	unsigned long now = millis();
+	uint32_t cached;
+	dns_cache_state_t state = dns_cache_get(&resolver->cache, now, &cached);
+	if (state == DNS_CACHE_FRESH) {
+		*address = IPAddress(cached);
+		if (resolver->waiting) {
+			resolver->waiting = false;
+			return DNS_RESOLVER_RESOLVED;
+		}
+		resolver->stats.cache_hits++;
+		return DNS_RESOLVER_CACHED;
+	}
+
+	// Expired or never looked up: wait for a query, unless one failed recently
+	if (!resolver->querying && (resolver->waiting || !may_query(resolver, now))) {
+		// The query waited for failed
+		resolver->waiting = false;
+		if (state == DNS_CACHE_STALE) {
+			*address = IPAddress(cached);
+			resolver->stats.stale_hits++;
+			return DNS_RESOLVER_STALE;
+		}
+		return DNS_RESOLVER_FAILED;
+	}
+	if (!resolver->querying) {
+		start_query(resolver, now);
+	}
+	resolver->waiting = true;
+	return DNS_RESOLVER_PENDING;
+}
+
+bool dns_resolver_busy(const dns_resolver_t *resolver) {
+	return resolver->querying;
+}
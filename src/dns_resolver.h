@@ -0,0 +1,110 @@
+#ifndef DNS_RESOLVER_H
+#define DNS_RESOLVER_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <WiFiUdp.h>
+
+#include "dns_cache.h"
+
+/**
+ * Time to wait for each response (ms), the number of attempts made before a
+ * lookup fails, and how long to wait after a failed lookup before the next
+ * background refresh.
+ */
+#define DNS_RESOLVER_QUERY_TIMEOUT 1000
+#define DNS_RESOLVER_ATTEMPTS 3
+#define DNS_RESOLVER_RETRY_INTERVAL 30000
+
+/**
+ * Range of the (random) local ports queries are sent from.
+ */
+#define DNS_RESOLVER_MIN_LOCAL_PORT 49152
+#define DNS_RESOLVER_NUM_LOCAL_PORTS 16384
+
+/**
+ * The outcome of dns_resolver_lookup.
+ */
+typedef enum {
+	// Still waiting for the DNS server
+	DNS_RESOLVER_PENDING,
+	// The cached address is within its TTL
+	DNS_RESOLVER_CACHED,
+	// The address was looked up for this lookup
+	DNS_RESOLVER_RESOLVED,
+	// The address couldn't be looked up so the last-known-good address (whose
+	// TTL has expired) was used
+	DNS_RESOLVER_STALE,
+	// The address couldn't be looked up and none is cached
+	DNS_RESOLVER_FAILED,
+} dns_resolver_result_t;
+
+typedef struct {
+	// Queries sent to the DNS server (not counting retransmissions) and how
+	// many failed
+	unsigned long queries;
+	unsigned long failures;
+
+	// Lookups answered from the cache, and with the last-known-good address
+	unsigned long cache_hits;
+	unsigned long stale_hits;
+} dns_resolver_stats_t;
+
+/**
+ * A non-blocking DNS resolver for a single host, which caches its address (see
+ * dns_cache.h). Unlike lwIP's resolver, the address is refreshed in the
+ * background before its TTL expires and the last-known-good address is used
+ * when the DNS server can't be reached.
+ *
+ * Call dns_resolver_poll regularly (e.g. from loop()). Initialise with
+ * dns_resolver_init.
+ */
+typedef struct {
+	const char *host;
+
+	dns_cache_t cache;
+
+	WiFiUDP udp;
+
+	// The query in progress (if any): its id, the number of times it has been
+	// sent and when it was last sent
+	bool querying;
+	uint16_t query_id;
+	unsigned int attempts;
+	unsigned long attempt_time;
+
+	// Did the last query fail, and when may the next background refresh be
+	// made?
+	bool failed;
+	unsigned long retry_time;
+
+	// Is a caller of dns_resolver_lookup waiting for the query in progress?
+	bool waiting;
+
+	dns_resolver_stats_t stats;
+} dns_resolver_t;
+
+/**
+ * Call once on startup to prepare to look up host.
+ */
+void dns_resolver_init(dns_resolver_t *resolver, const char *host);
+
+/**
+ * Process responses and retransmit or give up on queries in progress. Starts a
+ * background refresh when the cached address nears the end of its TTL (while
+ * WiFi is connected).
+ */
+void dns_resolver_poll(dns_resolver_t *resolver);
+
+/**
+ * Get the host's address, starting a query if the cache has expired. Call
+ * repeatedly until the result isn't DNS_RESOLVER_PENDING.
+ */
+dns_resolver_result_t dns_resolver_lookup(dns_resolver_t *resolver, IPAddress *address);
+
+/**
+ * Is a query in progress?
+ */
+bool dns_resolver_busy(const dns_resolver_t *resolver);
+
+#endif
@@ -0,0 +1,354 @@
+#include <string.h>
+#include <stdio.h>
+
+#include "http_fetch.h"
+
+void http_fetch_init(http_fetch_t *fetch, dns_resolver_t *resolver, uint16_t port,
+                     bool tls) {
+	fetch->state = HTTP_FETCH_IDLE;
+	fetch->host = resolver->host;
+	fetch->resolver = resolver;
+	fetch->dns_result = DNS_RESOLVER_PENDING;
+	fetch->port = port;
+	fetch->tls = tls;
+	fetch->client = tls ? &fetch->tls_client : &fetch->plain_client;
+	fetch->public_key_valid = false;
+	fetch->session_valid = false;
+	fetch->mfln_known = false;
+	fetch->mfln_supported = false;
+	fetch->tls_connected = false;
+	fetch->session_offered = false;
+	fetch->session_resumed = false;
+	fetch->tls_connect_time = 0;
+	fetch->request_length = 0;
+	fetch->request_sent = 0;
+	fetch->reused = false;
+	fetch->retried = false;
+	fetch->bytes_received = 0;
+	memset(fetch->phase_times, 0, sizeof(fetch->phase_times));
+	fetch->first_byte_time = 0;
+	fetch->error = NULL;
+	memset(&fetch->stats, 0, sizeof(fetch->stats));
+	fetch->phase_start_time = millis();
+	http_response_init(&fetch->response, NULL, NULL);
+}
+
+bool http_fetch_set_public_key(http_fetch_t *fetch, const char *pem) {
+	fetch->public_key_valid = fetch->public_key.parse(pem) &&
+	                          (fetch->public_key.isRSA() || fetch->public_key.isEC());
+	return fetch->public_key_valid;
+}
+
+static void set_state(http_fetch_t *fetch, http_fetch_state_t state) {
+	unsigned long now = millis();
+	fetch->phase_times[fetch->state] += now - fetch->phase_start_time;
+	fetch->state = state;
+	fetch->phase_start_time = now;
+}
+
+/**
+ * Close the connection and fail the request.
+ */
+static void fail(http_fetch_t *fetch, const char *error) {
+	fetch->client->stop();
+	fetch->error = error;
+	fetch->stats.requests++;
+	if (fetch->reused) {
+		fetch->stats.reused++;
+	}
+	set_state(fetch, HTTP_FETCH_FAILED);
+}
+
+/**
+ * Start opening a new connection, beginning with a DNS lookup (which is
+ * usually answered from the resolver's cache).
+ */
+static void start_connection(http_fetch_t *fetch) {
+	fetch->client->stop();
+	fetch->reused = false;
+	fetch->dns_result = DNS_RESOLVER_PENDING;
+	set_state(fetch, HTTP_FETCH_RESOLVING);
+}
+
+/**
+ * Configure the TLS client before connecting: pin the server's key, offer any
+ * saved session and (unless the server is known not to support it) shrink the
+ * receive buffer, asking the server to limit its records to fit.
+ * Returns false, failing the request, if no valid key has been set.
+ */
+static bool prepare_tls(http_fetch_t *fetch) {
+	if (!fetch->public_key_valid) {
+		fail(fetch, "no server public key set");
+		return false;
+	}
+
+	bool small_buffer = !fetch->mfln_known || fetch->mfln_supported;
+	fetch->tls_client.setBufferSizes(small_buffer ? HTTP_FETCH_TLS_RX_BUFFER_SIZE
+	                                              : HTTP_FETCH_TLS_MAX_RECORD_SIZE,
+	                                 HTTP_FETCH_TLS_TX_BUFFER_SIZE);
+
+	fetch->tls_client.setKnownKey(&fetch->public_key);
+	fetch->tls_client.setSession(&fetch->session);
+	fetch->session_offered = fetch->session_valid;
+	return true;
+}
+
+/**
+ * Called when the connection failed before any response was received. If the
+ * connection was reused it has most likely been closed by the server while
+ * idle, so the request is retried (once) on a new connection.
+ */
+static void retry_or_fail(http_fetch_t *fetch, const char *error) {
+	if (fetch->reused && !fetch->retried && fetch->bytes_received == 0) {
+		fetch->stats.dropped++;
+		fetch->retried = true;
+		fetch->request_sent = 0;
+		http_response_init(&fetch->response, fetch->response.callback,
+		                   fetch->response.callback_data);
+		start_connection(fetch);
+	} else {
+		fail(fetch, error);
+	}
+}
+
+bool http_fetch_start(http_fetch_t *fetch, const char *path, const char *headers,
+                      http_body_callback_t callback, void *callback_data) {
+	http_fetch_cancel(fetch);
+
+	fetch->start_time = millis();
+	fetch->retried = false;
+	fetch->bytes_received = 0;
+	memset(fetch->phase_times, 0, sizeof(fetch->phase_times));
+	fetch->first_byte_time = 0;
+	fetch->tls_connected = false;
+	fetch->session_offered = false;
+	fetch->session_resumed = false;
+	fetch->tls_connect_time = 0;
+	fetch->error = NULL;
+	http_response_init(&fetch->response, callback, callback_data);
+
+	int length = snprintf(fetch->request, sizeof(fetch->request),
+	                      "GET %s HTTP/1.1\r\n"
+	                      "Host: %s\r\n"
+	                      "Connection: keep-alive\r\n"
+	                      "%s"
+	                      "\r\n",
+	                      path, fetch->host, headers);
+	if (length < 0 || (size_t)length >= sizeof(fetch->request)) {
+		fetch->reused = false;
+		fail(fetch, "request too long");
+		return false;
+	}
+	fetch->request_length = length;
+	fetch->request_sent = 0;
+
+	if (fetch->client->connected()) {
+		fetch->reused = true;
+		set_state(fetch, HTTP_FETCH_SENDING);
+	} else {
+		start_connection(fetch);
+	}
+	return true;
+}
+
+/**
+ * Read and parse whatever data has arrived, for at most time_slice ms from
+ * slice_start.
+ */
+static void receive(http_fetch_t *fetch, unsigned long slice_start,
+                    unsigned long time_slice) {
+	char buf[HTTP_FETCH_READ_BUFFER_SIZE];
+	while (millis() - slice_start < time_slice) {
+		size_t available = fetch->client->available();
+		if (available == 0) {
+			unsigned long now = millis();
+			if (!fetch->client->connected()) {
+				http_response_closed(&fetch->response);
+				if (!http_response_done(&fetch->response)) {
+					retry_or_fail(fetch, "connection closed by server");
+					return;
+				}
+			} else if (fetch->state == HTTP_FETCH_HEADERS &&
+			           now - fetch->phase_start_time > HTTP_FETCH_RESPONSE_TIMEOUT) {
+				retry_or_fail(fetch, "timed out waiting for response");
+				return;
+			} else if (fetch->state == HTTP_FETCH_BODY &&
+			           now - fetch->last_data_time > HTTP_FETCH_IDLE_TIMEOUT) {
+				fail(fetch, "timed out reading response");
+				return;
+			} else {
+				return;
+			}
+		} else {
+			int length = fetch->client->read((uint8_t *)buf, min(available, sizeof(buf)));
+			if (length <= 0) {
+				return;
+			}
+			if (fetch->bytes_received == 0) {
+				fetch->first_byte_time = millis() - fetch->phase_start_time;
+			}
+			fetch->bytes_received += length;
+			fetch->last_data_time = millis();
+			http_response_feed(&fetch->response, buf, length);
+		}
+
+		if (http_response_error(&fetch->response)) {
+			fail(fetch, "malformed response");
+			return;
+		} else if (http_response_done(&fetch->response)) {
+			// Only keep the connection if it can accept another request
+			if (!fetch->response.keep_alive) {
+				fetch->client->stop();
+			}
+			fetch->stats.requests++;
+			if (fetch->reused) {
+				fetch->stats.reused++;
+			}
+			set_state(fetch, HTTP_FETCH_DONE);
+			return;
+		} else if (fetch->state == HTTP_FETCH_HEADERS &&
+		           http_response_headers_done(&fetch->response)) {
+			set_state(fetch, HTTP_FETCH_BODY);
+		}
+	}
+}
+
+http_fetch_state_t http_fetch_poll(http_fetch_t *fetch, unsigned long time_slice) {
+	unsigned long slice_start = millis();
+
+	if (http_fetch_busy(fetch) &&
+	    slice_start - fetch->start_time > HTTP_FETCH_TOTAL_TIMEOUT) {
+		fail(fetch, "request timed out");
+	}
+
+	switch (fetch->state) {
+		case HTTP_FETCH_RESOLVING: {
+			dns_resolver_result_t result = dns_resolver_lookup(fetch->resolver, &fetch->address);
+			if (result == DNS_RESOLVER_PENDING) {
+				if (slice_start - fetch->phase_start_time > HTTP_FETCH_RESOLVE_TIMEOUT) {
+					fail(fetch, "DNS lookup timed out");
+				}
+				break;
+			} else if (result == DNS_RESOLVER_FAILED) {
+				fail(fetch, "DNS lookup failed");
+				break;
+			}
+			fetch->dns_result = result;
+			set_state(fetch, HTTP_FETCH_CONNECTING);
+		}
+			// Fall through
+
+		case HTTP_FETCH_CONNECTING: {
+			if (fetch->tls && !prepare_tls(fetch)) {
+				break;
+			}
+
+			// NB: Blocks for up to HTTP_FETCH_CONNECT_TIMEOUT (or
+			// HTTP_FETCH_TLS_CONNECT_TIMEOUT)
+			unsigned long connect_start = millis();
+			bool connected;
+			// The session offered, which the handshake replaces unless the server
+			// resumes it
+			BearSSL::Session offered_session = fetch->session;
+			if (fetch->tls) {
+				fetch->tls_client.setTimeout(HTTP_FETCH_TLS_CONNECT_TIMEOUT);
+				connected = fetch->tls_client.connect(fetch->address, fetch->port, fetch->host);
+			} else {
+				fetch->client->setTimeout(HTTP_FETCH_CONNECT_TIMEOUT);
+				connected = fetch->client->connect(fetch->address, fetch->port);
+			}
+			if (!connected) {
+				if (fetch->tls && fetch->tls_client.getLastSSLError()) {
+					// Don't offer the session again
+					fetch->session_valid = false;
+					if (!fetch->mfln_known) {
+						// The server may have ignored the max fragment length and
+						// sent a record too large for the buffer: try again (at the
+						// next poll) with a full-size buffer
+						fetch->mfln_known = true;
+						fetch->mfln_supported = false;
+						break;
+					}
+					fail(fetch, "TLS handshake failed");
+				} else {
+					fail(fetch, "connection failed");
+				}
+				break;
+			}
+			if (fetch->tls) {
+				fetch->tls_connect_time = millis() - connect_start;
+				fetch->session_resumed = fetch->session_offered &&
+				                         memcmp(&offered_session, &fetch->session,
+				                                sizeof(offered_session)) == 0;
+				fetch->session_valid = true;
+				if (!fetch->mfln_known) {
+					fetch->mfln_known = true;
+					fetch->mfln_supported = fetch->tls_client.getMFLNStatus();
+					if (!fetch->mfln_supported) {
+						// Records larger than the buffer may follow: reconnect
+						// (at the next poll, resuming this session) with a
+						// full-size buffer
+						fetch->tls_client.stop();
+						break;
+					}
+				}
+				fetch->tls_connected = true;
+			}
+			fetch->client->setNoDelay(true);
+			fetch->stats.connects++;
+			fetch->stats.total_connect_time += millis() - fetch->phase_start_time;
+			set_state(fetch, HTTP_FETCH_SENDING);
+		}
+			// Fall through
+
+		case HTTP_FETCH_SENDING: {
+			if (!fetch->client->connected()) {
+				retry_or_fail(fetch, "connection closed by server");
+				break;
+			}
+
+			// Only write as much as fits in the send buffer so we never wait
+			size_t length = fetch->request_length - fetch->request_sent;
+			length = min(length, fetch->client->availableForWrite());
+			if (length) {
+				fetch->request_sent += fetch->client->write(
+					(const uint8_t *)fetch->request + fetch->request_sent, length);
+			}
+
+			if (fetch->request_sent < fetch->request_length) {
+				if (millis() - fetch->phase_start_time > HTTP_FETCH_SEND_TIMEOUT) {
+					fail(fetch, "timed out sending request");
+				}
+				break;
+			}
+			set_state(fetch, HTTP_FETCH_HEADERS);
+			fetch->last_data_time = fetch->phase_start_time;
+		}
+			// Fall through
+
+		case HTTP_FETCH_HEADERS:
+		case HTTP_FETCH_BODY:
+			receive(fetch, slice_start, time_slice);
+			break;
+
+		case HTTP_FETCH_IDLE:
+		case HTTP_FETCH_DONE:
+		case HTTP_FETCH_FAILED:
+			break;
+	}
+
+	return fetch->state;
+}
+
+void http_fetch_cancel(http_fetch_t *fetch) {
+	if (http_fetch_busy(fetch)) {
+		fetch->client->stop();
+	}
+	set_state(fetch, HTTP_FETCH_IDLE);
+}
+
+bool http_fetch_busy(const http_fetch_t *fetch) {
+	return fetch->state != HTTP_FETCH_IDLE &&
+	       fetch->state != HTTP_FETCH_DONE &&
+	       fetch->state != HTTP_FETCH_FAILED;
+}
@@ -0,0 +1,231 @@
+#ifndef HTTP_FETCH_H
+#define HTTP_FETCH_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecureBearSSL.h>
+
+#include "http_response.h"
+#include "dns_resolver.h"
+
+/**
+ * Maximum length of a request (request line plus headers).
+ */
+#define HTTP_FETCH_MAX_REQUEST_LENGTH 800
+
+/**
+ * Size of the buffer used to read from the connection.
+ */
+#define HTTP_FETCH_READ_BUFFER_SIZE 256
+
+/**
+ * Sizes of the TLS receive and transmit buffers. The receive buffer can only be
+ * shrunk from HTTP_FETCH_TLS_MAX_RECORD_SIZE if the server supports the max
+ * fragment length extension. The first connection asks for it, and later ones
+ * use the full size if the server doesn't agree.
+ */
+#define HTTP_FETCH_TLS_RX_BUFFER_SIZE 1024
+#define HTTP_FETCH_TLS_TX_BUFFER_SIZE 512
+#define HTTP_FETCH_TLS_MAX_RECORD_SIZE 16384
+
+/**
+ * Per-phase deadlines (in milliseconds).
+ *
+ * WiFiClient::connect() blocks until it succeeds or HTTP_FETCH_CONNECT_TIMEOUT
+ * (HTTP_FETCH_TLS_CONNECT_TIMEOUT for TLS connections, which includes the
+ * handshake) elapses, so this also bounds the longest single call to
+ * http_fetch_poll.
+ */
+#define HTTP_FETCH_RESOLVE_TIMEOUT 5000
+#define HTTP_FETCH_CONNECT_TIMEOUT 2000
+#define HTTP_FETCH_TLS_CONNECT_TIMEOUT 10000
+#define HTTP_FETCH_SEND_TIMEOUT 5000
+#define HTTP_FETCH_RESPONSE_TIMEOUT 5000
+#define HTTP_FETCH_IDLE_TIMEOUT 5000
+#define HTTP_FETCH_TOTAL_TIMEOUT 30000
+
+/**
+ * A BearSSL client which connects to an address that has already been looked
+ * up while still sending the host name (SNI). WiFiClientSecure only sends it
+ * when looking up the name itself (with a blocking lookup).
+ */
+class HttpFetchTlsClient : public BearSSL::WiFiClientSecureCtx {
+	public:
+		using BearSSL::WiFiClientSecureCtx::connect;
+
+		int connect(IPAddress address, uint16_t port, const char *host) {
+			return WiFiClient::connect(address, port) && _connectSSL(host);
+		}
+};
+
+/**
+ * The phases of a request.
+ */
+typedef enum {
+	// No request in progress
+	HTTP_FETCH_IDLE,
+	// Looking up the server's address
+	HTTP_FETCH_RESOLVING,
+	// Opening a connection
+	HTTP_FETCH_CONNECTING,
+	// Writing the request
+	HTTP_FETCH_SENDING,
+	// Waiting for the status line and headers
+	HTTP_FETCH_HEADERS,
+	// Receiving the body
+	HTTP_FETCH_BODY,
+	// Complete response received (see response.status)
+	HTTP_FETCH_DONE,
+	// The request failed (see error)
+	HTTP_FETCH_FAILED,
+} http_fetch_state_t;
+
+/**
+ * Connection reuse statistics.
+ */
+typedef struct {
+	// Number of requests completed or failed and how many of these reused an
+	// already open connection
+	unsigned long requests;
+	unsigned long reused;
+
+	// Number of reused connections found to have been closed by the server
+	unsigned long dropped;
+
+	// Number of new connections made and the total time spent connecting (ms)
+	unsigned long connects;
+	unsigned long total_connect_time;
+} http_fetch_stats_t;
+
+/**
+ * A resumable HTTP/1.1 (or HTTPS) GET request to a single server. The
+ * connection is kept open between requests and re-opened transparently if the
+ * server drops it.
+ *
+ * HTTPS connections only accept a server with the public key set by
+ * http_fetch_set_public_key. The TLS session is saved and offered for
+ * resumption when reconnecting, skipping the expensive key exchange.
+ *
+ * Start a request with http_fetch_start then call http_fetch_poll repeatedly
+ * (e.g. from loop()) until it returns HTTP_FETCH_DONE or HTTP_FETCH_FAILED.
+ * Each call does a bounded amount of work, never waiting for the network.
+ *
+ * Initialise with http_fetch_init.
+ */
+typedef struct {
+	http_fetch_state_t state;
+
+	const char *host;
+	uint16_t port;
+	bool tls;
+
+	// Looks up (and caches) the server's address
+	dns_resolver_t *resolver;
+
+	// The connection (plain_client or tls_client)
+	WiFiClient *client;
+	WiFiClient plain_client;
+	HttpFetchTlsClient tls_client;
+
+	// The pinned public key of the server (and is it valid?)
+	BearSSL::PublicKey public_key;
+	bool public_key_valid;
+
+	// The session of the last TLS connection (if session_valid) offered for
+	// resumption by the next
+	BearSSL::Session session;
+	bool session_valid;
+
+	// Is it known whether the server supports the max fragment length
+	// extension (with HTTP_FETCH_TLS_RX_BUFFER_SIZE), and does it?
+	bool mfln_known;
+	bool mfln_supported;
+
+	// The server's address, set by a successful lookup, and how it was found
+	IPAddress address;
+	dns_resolver_result_t dns_result;
+
+	// The request being sent and number of bytes sent so far
+	char request[HTTP_FETCH_MAX_REQUEST_LENGTH];
+	size_t request_length;
+	size_t request_sent;
+
+	http_response_t response;
+
+	// Was an already open connection used for this request?
+	bool reused;
+
+	// Has the request been retried after finding the reused connection closed?
+	bool retried;
+
+	// Times (millis()) at which the request and current phase started and at
+	// which data was last received
+	unsigned long start_time;
+	unsigned long phase_start_time;
+	unsigned long last_data_time;
+
+	// Number of bytes (headers and body) received
+	unsigned long bytes_received;
+
+	// Time spent in each phase of the request (ms, indexed by state) and from
+	// sending the request to receiving the first byte of the response
+	unsigned long phase_times[HTTP_FETCH_FAILED + 1];
+	unsigned long first_byte_time;
+
+	// Was a new TLS connection made for this request, did it offer a saved
+	// session for resumption, did the server resume it (rather than make a
+	// full handshake) and how long did connecting (including the handshake)
+	// take (ms)?
+	bool tls_connected;
+	bool session_offered;
+	bool session_resumed;
+	unsigned long tls_connect_time;
+
+	// Description of the reason for failure (when state is HTTP_FETCH_FAILED)
+	const char *error;
+
+	http_fetch_stats_t stats;
+} http_fetch_t;
+
+/**
+ * Call once on startup to prepare to make requests to the server whose address
+ * is found by resolver, using HTTPS if tls is true.
+ */
+void http_fetch_init(http_fetch_t *fetch, dns_resolver_t *resolver, uint16_t port,
+                     bool tls);
+
+/**
+ * Set the public key (PEM encoded) which the server must present on HTTPS
+ * connections. Requests fail until a valid key is set. Returns false if the key
+ * can't be parsed.
+ */
+bool http_fetch_set_public_key(http_fetch_t *fetch, const char *pem);
+
+/**
+ * Begin a GET request for path, cancelling any request already in progress.
+ * The extra headers supplied (each terminated by "\r\n") are added to the
+ * request. The response body is passed to callback as it arrives. Returns
+ * false (and enters the HTTP_FETCH_FAILED state) if the request is too long.
+ */
+bool http_fetch_start(http_fetch_t *fetch, const char *path, const char *headers,
+                      http_body_callback_t callback, void *callback_data);
+
+/**
+ * Advance the request, spending no more than roughly time_slice milliseconds
+ * processing data which has already arrived. Returns the new state.
+ */
+http_fetch_state_t http_fetch_poll(http_fetch_t *fetch, unsigned long time_slice);
+
+/**
+ * Abandon any request in progress (closing the connection) and return to the
+ * HTTP_FETCH_IDLE state.
+ */
+void http_fetch_cancel(http_fetch_t *fetch);
+
+/**
+ * Is a request in progress?
+ */
+bool http_fetch_busy(const http_fetch_t *fetch);
+
+#endif
@@ -0,0 +1,303 @@
+#include <string.h>
+#include <stdlib.h>
+
+#include "http_response.h"
+
+/**
+ * Parser states.
+ */
+enum {
+	// Reading the status line
+	STATE_STATUS_LINE,
+	// Reading header lines
+	STATE_HEADER_LINE,
+	// Reading a body delimited by Content-Length
+	STATE_BODY_CONTENT_LENGTH,
+	// Reading a body delimited by the connection closing
+	STATE_BODY_UNTIL_CLOSE,
+	// Reading a chunk size line
+	STATE_CHUNK_SIZE,
+	// Reading chunk data
+	STATE_CHUNK_DATA,
+	// Reading the (empty) line following chunk data
+	STATE_CHUNK_DATA_END,
+	// Reading trailer lines after the last chunk
+	STATE_TRAILER,
+	// The response is complete
+	STATE_DONE,
+	// The response was malformed or cut short
+	STATE_ERROR,
+};
+
+void http_response_init(http_response_t *response,
+                        http_body_callback_t callback, void *callback_data) {
+	memset(response, 0, sizeof(*response));
+	response->state = STATE_STATUS_LINE;
+	response->status = -1;
+	response->callback = callback;
+	response->callback_data = callback_data;
+}
+
+/**
+ * Case-insensitive ASCII prefix comparison.
+ */
+static bool starts_with_ignore_case(const char *str, const char *prefix) {
+	for (; *prefix; str++, prefix++) {
+		char a = (*str >= 'A' && *str <= 'Z') ? *str - 'A' + 'a' : *str;
+		if (a != *prefix) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Case-insensitive ASCII substring search.
+ */
+static bool contains_ignore_case(const char *str, const char *needle) {
+	for (; *str; str++) {
+		if (starts_with_ignore_case(str, needle)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Return a pointer to the value of a header line ("Name: value") if it has the
+ * given (lower case) name, or NULL otherwise.
+ */
+static const char *header_value(const char *line, const char *name) {
+	if (!starts_with_ignore_case(line, name)) {
+		return NULL;
+	}
+	line += strlen(name);
+	if (*line != ':') {
+		return NULL;
+	}
+	line++;
+	while (*line == ' ' || *line == '\t') {
+		line++;
+	}
+	return line;
+}
+
+static void process_status_line(http_response_t *response) {
+	// e.g. "HTTP/1.1 200 OK"
+	if (!starts_with_ignore_case(response->line, "http/1.")) {
+		response->state = STATE_ERROR;
+		return;
+	}
+	response->keep_alive = response->line[7] != '0';
+
+	const char *code = strchr(response->line, ' ');
+	response->status = code ? atoi(code + 1) : 0;
+	if (response->status < 100) {
+		response->state = STATE_ERROR;
+		return;
+	}
+
+	response->framing = HTTP_BODY_UNTIL_CLOSE;
+	response->state = STATE_HEADER_LINE;
+}
+
+/**
+ * Called on the empty line ending the headers.
+ */
+static void end_headers(http_response_t *response) {
+	if (response->status >= 100 && response->status < 200 && response->status != 101) {
+		// An interim response (e.g. 100 Continue or 103 Early Hints): forget
+		// its headers and read the final response which follows
+		response->status = -1;
+		response->framing = HTTP_BODY_UNTIL_CLOSE;
+		response->content_encoding = HTTP_CONTENT_IDENTITY;
+		response->content_type[0] = '\0';
+		response->content_length = 0;
+		response->state = STATE_STATUS_LINE;
+	} else if (response->status == 204 || response->status == 304) {
+		// Never have a body
+		response->state = STATE_DONE;
+	} else if (response->framing == HTTP_BODY_CHUNKED) {
+		response->state = STATE_CHUNK_SIZE;
+	} else if (response->framing == HTTP_BODY_CONTENT_LENGTH) {
+		response->remaining = response->content_length;
+		response->state = response->remaining ? STATE_BODY_CONTENT_LENGTH : STATE_DONE;
+	} else {
+		response->keep_alive = false;
+		response->state = STATE_BODY_UNTIL_CLOSE;
+	}
+}
+
+static void process_header_line(http_response_t *response) {
+	const char *line = response->line;
+	const char *value;
+
+	if (!*line) {
+		end_headers(response);
+	} else if ((value = header_value(line, "content-length"))) {
+		if (response->framing != HTTP_BODY_CHUNKED) {
+			response->framing = HTTP_BODY_CONTENT_LENGTH;
+		}
+		response->content_length = strtoul(value, NULL, 10);
+	} else if ((value = header_value(line, "transfer-encoding"))) {
+		// Chunked takes precedence over any Content-Length
+		if (contains_ignore_case(value, "chunked")) {
+			response->framing = HTTP_BODY_CHUNKED;
+		}
+	} else if ((value = header_value(line, "content-encoding"))) {
+		if (strchr(value, ',')) {
+			response->content_encoding = HTTP_CONTENT_UNSUPPORTED;
+		} else if (starts_with_ignore_case(value, "gzip") ||
+		           starts_with_ignore_case(value, "x-gzip")) {
+			response->content_encoding = HTTP_CONTENT_GZIP;
+		} else if (starts_with_ignore_case(value, "deflate")) {
+			response->content_encoding = HTTP_CONTENT_DEFLATE;
+		} else if (!starts_with_ignore_case(value, "identity")) {
+			response->content_encoding = HTTP_CONTENT_UNSUPPORTED;
+		}
+	} else if ((value = header_value(line, "content-type"))) {
+		// e.g. "application/json; charset=utf-8"
+		size_t length = 0;
+		while (*value && *value != ';' && *value != ' ' && *value != '\t' &&
+		       length + 1 < sizeof(response->content_type)) {
+			char c = *value++;
+			response->content_type[length++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+		}
+		response->content_type[length] = '\0';
+	} else if ((value = header_value(line, "connection"))) {
+		if (contains_ignore_case(value, "close")) {
+			response->keep_alive = false;
+		} else if (contains_ignore_case(value, "keep-alive")) {
+			response->keep_alive = true;
+		}
+	}
+}
+
+static void process_chunk_size_line(http_response_t *response) {
+	char *end;
+	unsigned long size = strtoul(response->line, &end, 16);
+	if (end == response->line || (*end && *end != ';' && *end != ' ')) {
+		response->state = STATE_ERROR;
+	} else if (size == 0) {
+		response->state = STATE_TRAILER;
+	} else {
+		response->remaining = size;
+		response->state = STATE_CHUNK_DATA;
+	}
+}
+
+/**
+ * Called when a complete line has been read into response->line.
+ */
+static void process_line(http_response_t *response) {
+	switch (response->state) {
+		case STATE_STATUS_LINE:
+			process_status_line(response);
+			break;
+
+		case STATE_HEADER_LINE:
+			process_header_line(response);
+			break;
+
+		case STATE_CHUNK_SIZE:
+			process_chunk_size_line(response);
+			break;
+
+		case STATE_CHUNK_DATA_END:
+			response->state = response->line[0] ? STATE_ERROR : STATE_CHUNK_SIZE;
+			break;
+
+		case STATE_TRAILER:
+			if (!response->line[0]) {
+				response->state = STATE_DONE;
+			}
+			break;
+	}
+}
+
+/**
+ * Pass body data to the callback.
+ */
+static void emit_body(http_response_t *response, const char *data, size_t length) {
+	response->body_length += length;
+	if (response->callback) {
+		response->callback(data, length, response->callback_data);
+	}
+}
+
+size_t http_response_feed(http_response_t *response, const char *data, size_t length) {
+	size_t i = 0;
+	while (i < length) {
+		switch (response->state) {
+			case STATE_STATUS_LINE:
+			case STATE_HEADER_LINE:
+			case STATE_CHUNK_SIZE:
+			case STATE_CHUNK_DATA_END:
+			case STATE_TRAILER: {
+				char c = data[i++];
+				if (c == '\n') {
+					// Strip trailing CR
+					if (response->line_length && response->line[response->line_length - 1] == '\r') {
+						response->line_length--;
+					}
+					response->line[response->line_length] = '\0';
+					response->line_length = 0;
+					process_line(response);
+				} else if (response->line_length < sizeof(response->line) - 1) {
+					response->line[response->line_length++] = c;
+				}
+				break;
+			}
+
+			case STATE_BODY_CONTENT_LENGTH:
+			case STATE_CHUNK_DATA: {
+				size_t n = length - i;
+				if (n > response->remaining) {
+					n = response->remaining;
+				}
+				emit_body(response, data + i, n);
+				i += n;
+				response->remaining -= n;
+				if (response->remaining == 0) {
+					response->state = (response->state == STATE_CHUNK_DATA)
+						? STATE_CHUNK_DATA_END
+						: STATE_DONE;
+				}
+				break;
+			}
+
+			case STATE_BODY_UNTIL_CLOSE:
+				emit_body(response, data + i, length - i);
+				i = length;
+				break;
+
+			case STATE_DONE:
+			case STATE_ERROR:
+				return i;
+		}
+	}
+	return i;
+}
+
+void http_response_closed(http_response_t *response) {
+	if (response->state == STATE_BODY_UNTIL_CLOSE) {
+		response->state = STATE_DONE;
+	} else if (response->state != STATE_DONE) {
+		response->state = STATE_ERROR;
+	}
+	response->keep_alive = false;
+}
+
+bool http_response_headers_done(const http_response_t *response) {
+	return response->state != STATE_STATUS_LINE &&
+	       response->state != STATE_HEADER_LINE &&
+	       response->state != STATE_ERROR;
+}
+
+bool http_response_done(const http_response_t *response) {
+	return response->state == STATE_DONE;
+}
+
+bool http_response_error(const http_response_t *response) {
+	return response->state == STATE_ERROR;
+}
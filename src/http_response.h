@@ -0,0 +1,130 @@
+#ifndef HTTP_RESPONSE_H
+#define HTTP_RESPONSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * Size of the buffer (including the null terminator) used to hold the status
+ * line and each header line. Longer lines are truncated.
+ */
+#define HTTP_RESPONSE_MAX_LINE_LENGTH 96
+
+/**
+ * Size of the buffer (including the null terminator) used to hold the media
+ * type from the Content-Type header. Longer types are truncated.
+ */
+#define HTTP_RESPONSE_MAX_CONTENT_TYPE_LENGTH 40
+
+/**
+ * How the end of the response body is determined.
+ */
+typedef enum {
+	// Body ends when the server closes the connection
+	HTTP_BODY_UNTIL_CLOSE,
+	// Body length given by the Content-Length header
+	HTTP_BODY_CONTENT_LENGTH,
+	// Transfer-Encoding: chunked
+	HTTP_BODY_CHUNKED,
+} http_body_framing_t;
+
+/**
+ * The Content-Encoding applied to the response body. The parser passes the body
+ * on still encoded.
+ */
+typedef enum {
+	HTTP_CONTENT_IDENTITY,
+	// gzip or x-gzip
+	HTTP_CONTENT_GZIP,
+	HTTP_CONTENT_DEFLATE,
+	// Any other encoding (or more than one)
+	HTTP_CONTENT_UNSUPPORTED,
+} http_content_encoding_t;
+
+/**
+ * Called by the parser with each piece of the (de-chunked) response body.
+ */
+typedef void (*http_body_callback_t)(const char *data, size_t length, void *cb_data);
+
+/**
+ * State of an incremental (push) parser for an HTTP/1.1 response. The parser is
+ * fed the raw bytes received from the server in arbitrarily sized chunks and
+ * passes the body (with any chunked transfer encoding removed) to a callback.
+ * No heap allocations are made.
+ *
+ * Initialise with http_response_init.
+ */
+typedef struct {
+	// Parser state (see http_response.cpp)
+	unsigned char state;
+
+	// The line currently being read (status line, header or chunk size)
+	char line[HTTP_RESPONSE_MAX_LINE_LENGTH];
+	size_t line_length;
+
+	// The HTTP status code or -1 if the status line has not been read yet.
+	// Interim (1xx) responses other than 101 are skipped, so this is the
+	// status of the final response.
+	int status;
+
+	// May the connection be reused for another request once this response is
+	// complete?
+	bool keep_alive;
+
+	http_body_framing_t framing;
+	http_content_encoding_t content_encoding;
+
+	// Media type given by the Content-Type header, in lower case and without
+	// any parameters, or empty if there was none
+	char content_type[HTTP_RESPONSE_MAX_CONTENT_TYPE_LENGTH];
+
+	// Value of the Content-Length header, if present
+	unsigned long content_length;
+
+	// Bytes remaining in the body (HTTP_BODY_CONTENT_LENGTH) or current chunk
+	// (HTTP_BODY_CHUNKED)
+	unsigned long remaining;
+
+	// Total body bytes passed to the callback
+	unsigned long body_length;
+
+	http_body_callback_t callback;
+	void *callback_data;
+} http_response_t;
+
+/**
+ * Prepare a parser for a new response.
+ */
+void http_response_init(http_response_t *response,
+                        http_body_callback_t callback, void *callback_data);
+
+/**
+ * Feed the next bytes received from the server into the parser. Returns the
+ * number of bytes consumed: less than length if the response ended part way
+ * through the data (any remaining bytes belong to the next response). Check
+ * http_response_error afterwards.
+ */
+size_t http_response_feed(http_response_t *response, const char *data, size_t length);
+
+/**
+ * Indicate that the server closed the connection. This completes responses
+ * whose body is delimited by the connection closing.
+ */
+void http_response_closed(http_response_t *response);
+
+/**
+ * Have all headers been received?
+ */
+bool http_response_headers_done(const http_response_t *response);
+
+/**
+ * Has the complete response been received?
+ */
+bool http_response_done(const http_response_t *response);
+
+/**
+ * Was the response malformed (or cut short by the connection closing)?
+ */
+bool http_response_error(const http_response_t *response);
+
+#endif
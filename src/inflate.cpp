@@ -0,0 +1,673 @@
+#include <string.h>
+
+#include <pgmspace.h>
+
+#include "inflate.h"
+#include "crc32.h"
+
+/**
+ * Decoder states.
+ */
+enum {
+	// The fixed part of a gzip header
+	STATE_GZIP_HEADER,
+	// The length of the gzip header's extra field
+	STATE_GZIP_EXTRA_LENGTH,
+	// Skipping the gzip header's extra field or header CRC
+	STATE_GZIP_SKIP,
+	// Skipping the gzip header's (null terminated) file name or comment
+	STATE_GZIP_NAME,
+	STATE_GZIP_COMMENT,
+	// A zlib header, or the start of raw deflate data
+	STATE_ZLIB_HEADER,
+	// The three bit header of a block
+	STATE_BLOCK_HEADER,
+	// The length of a stored block and its complement
+	STATE_STORED_LENGTH,
+	STATE_STORED_LENGTH_COMPLEMENT,
+	// The contents of a stored block
+	STATE_STORED_DATA,
+	// The number of each type of code in a dynamic block
+	STATE_DYNAMIC_COUNTS,
+	// The lengths of the code length code
+	STATE_CODE_LENGTH_CODES,
+	// The (coded) lengths of the literal/length and distance codes
+	STATE_CODE_LENGTHS,
+	// The extra bits of a repeated code length
+	STATE_CODE_LENGTH_REPEAT,
+	// A literal/length symbol
+	STATE_SYMBOL,
+	// The extra bits of a length
+	STATE_LENGTH_EXTRA,
+	// A distance symbol and its extra bits
+	STATE_DISTANCE,
+	STATE_DISTANCE_EXTRA,
+	// Copying a back reference
+	STATE_COPY,
+	// The gzip or zlib trailer
+	STATE_TRAILER_CHECK,
+	STATE_TRAILER_SIZE,
+	// The end of the stream was reached, further input is ignored
+	STATE_DONE,
+	// Malformed input was encountered, further input is ignored
+	STATE_ERROR,
+};
+
+// gzip header flags
+static const unsigned char GZIP_FLAG_HEADER_CRC = 0x02;
+static const unsigned char GZIP_FLAG_EXTRA = 0x04;
+static const unsigned char GZIP_FLAG_NAME = 0x08;
+static const unsigned char GZIP_FLAG_COMMENT = 0x10;
+
+// Set in flags when a zlib header was found
+static const unsigned char ZLIB_WRAPPED = 0x01;
+
+static const uint16_t END_OF_BLOCK = 256;
+
+static const uint16_t LENGTH_BASES[29] PROGMEM = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258,
+};
+static const uint8_t LENGTH_EXTRA_BITS[29] PROGMEM = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0,
+};
+static const uint16_t DISTANCE_BASES[30] PROGMEM = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577,
+};
+static const uint8_t DISTANCE_EXTRA_BITS[30] PROGMEM = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13,
+};
+
+// The order in which the code length code's lengths are given
+static const uint8_t CODE_LENGTH_ORDER[19] PROGMEM = {
+	16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15,
+};
+
+void inflate_init(inflate_t *inflate, inflate_format_t format,
+                  inflate_output_callback_t callback, void *callback_data) {
+	memset(inflate, 0, sizeof(*inflate));
+	inflate->state = format == INFLATE_GZIP ? STATE_GZIP_HEADER : STATE_ZLIB_HEADER;
+	inflate->format = format;
+	inflate->callback = callback;
+	inflate->callback_data = callback_data;
+}
+
+static uint32_t adler32_update(uint32_t adler, const uint8_t *data, size_t length) {
+	// Largest number of bytes which can be summed before reducing
+	static const size_t MAX_RUN = 5552;
+	uint32_t a = adler & 0xFFFF;
+	uint32_t b = adler >> 16;
+	while (length) {
+		size_t run = length < MAX_RUN ? length : MAX_RUN;
+		length -= run;
+		while (run--) {
+			a += *data++;
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	return (b << 16) | a;
+}
+
+/**
+ * Pass any output not yet seen to the callback.
+ */
+static void flush(inflate_t *inflate) {
+	size_t length = inflate->window_pos - inflate->flush_pos;
+	if (!length) {
+		return;
+	}
+
+	const uint8_t *data = inflate->window + inflate->flush_pos;
+	if (inflate->format == INFLATE_GZIP) {
+		inflate->check = crc32_update(inflate->check, data, length);
+	} else if (inflate->flags & ZLIB_WRAPPED) {
+		inflate->check = adler32_update(inflate->check, data, length);
+	}
+	inflate->flush_pos = inflate->window_pos;
+	if (inflate->callback) {
+		inflate->callback((const char *)data, length, inflate->callback_data);
+	}
+}
+
+/**
+ * Append a byte to the output.
+ */
+static void put(inflate_t *inflate, uint8_t byte) {
+	inflate->window[inflate->window_pos++] = byte;
+	inflate->total_out++;
+	if (inflate->window_pos == INFLATE_WINDOW_SIZE) {
+		flush(inflate);
+		inflate->window_pos = 0;
+		inflate->flush_pos = 0;
+	}
+}
+
+/**
+ * Make at least n (at most 24) bits available in the bit buffer. Returns false
+ * if the input ran out first.
+ */
+static bool need(inflate_t *inflate, unsigned int n) {
+	while (inflate->bit_count < n) {
+		if (inflate->input == inflate->input_end) {
+			return false;
+		}
+		inflate->bit_buffer |= (uint32_t)*inflate->input++ << inflate->bit_count;
+		inflate->bit_count += 8;
+	}
+	return true;
+}
+
+/**
+ * The next n bits (which must be available).
+ */
+static unsigned int peek(const inflate_t *inflate, unsigned int n) {
+	return inflate->bit_buffer & ((1u << n) - 1);
+}
+
+static void consume(inflate_t *inflate, unsigned int n) {
+	inflate->bit_buffer >>= n;
+	inflate->bit_count -= n;
+}
+
+/**
+ * Discard bits up to the next byte boundary.
+ */
+static void align(inflate_t *inflate) {
+	consume(inflate, inflate->bit_count % 8);
+}
+
+/**
+ * Build a canonical Huffman code from the code length of each symbol. Returns
+ * false if the lengths are over-subscribed (incomplete codes are allowed).
+ */
+static bool build_code(uint16_t *counts, uint16_t *symbols,
+                       const uint8_t *lengths, size_t num_symbols) {
+	memset(counts, 0, 16 * sizeof(counts[0]));
+	for (size_t i = 0; i < num_symbols; i++) {
+		counts[lengths[i]]++;
+	}
+	counts[0] = 0;
+
+	int left = 1;
+	uint16_t offsets[16];
+	offsets[1] = 0;
+	for (size_t length = 1; length < 16; length++) {
+		left = (left << 1) - counts[length];
+		if (left < 0) {
+			return false;
+		}
+		if (length < 15) {
+			offsets[length + 1] = offsets[length] + counts[length];
+		}
+	}
+
+	for (size_t i = 0; i < num_symbols; i++) {
+		if (lengths[i]) {
+			symbols[offsets[lengths[i]]++] = i;
+		}
+	}
+	return true;
+}
+
+static const int DECODE_NEED_INPUT = -1;
+static const int DECODE_INVALID = -2;
+
+/**
+ * Decode a symbol, a bit at a time. Returns DECODE_NEED_INPUT (consuming
+ * nothing) if the input runs out part way through a code.
+ */
+static int decode(inflate_t *inflate, const uint16_t *counts, const uint16_t *symbols) {
+	int code = 0;
+	int first = 0;
+	int index = 0;
+	for (unsigned int length = 1; length < 16; length++) {
+		if (!need(inflate, length)) {
+			return DECODE_NEED_INPUT;
+		}
+		code |= (inflate->bit_buffer >> (length - 1)) & 1;
+		int count = counts[length];
+		if (code - first < count) {
+			consume(inflate, length);
+			return symbols[index + code - first];
+		}
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+	return DECODE_INVALID;
+}
+
+static void build_fixed_codes(inflate_t *inflate) {
+	uint8_t *lengths = inflate->lengths;
+	memset(lengths, 8, 144);
+	memset(lengths + 144, 9, 256 - 144);
+	memset(lengths + 256, 7, 280 - 256);
+	memset(lengths + 280, 8, 288 - 280);
+	build_code(inflate->literal_counts, inflate->literal_symbols, lengths, 288);
+	memset(lengths, 5, 30);
+	build_code(inflate->distance_counts, inflate->distance_symbols, lengths, 30);
+}
+
+/**
+ * Move on from the gzip header field just read to the next one present.
+ */
+static void next_gzip_header_field(inflate_t *inflate) {
+	inflate->header_bytes = 0;
+	if (inflate->flags & GZIP_FLAG_EXTRA) {
+		inflate->flags &= ~GZIP_FLAG_EXTRA;
+		inflate->remaining = 0;
+		inflate->state = STATE_GZIP_EXTRA_LENGTH;
+	} else if (inflate->flags & GZIP_FLAG_NAME) {
+		inflate->flags &= ~GZIP_FLAG_NAME;
+		inflate->state = STATE_GZIP_NAME;
+	} else if (inflate->flags & GZIP_FLAG_COMMENT) {
+		inflate->flags &= ~GZIP_FLAG_COMMENT;
+		inflate->state = STATE_GZIP_COMMENT;
+	} else if (inflate->flags & GZIP_FLAG_HEADER_CRC) {
+		inflate->flags &= ~GZIP_FLAG_HEADER_CRC;
+		inflate->remaining = 2;
+		inflate->state = STATE_GZIP_SKIP;
+	} else {
+		inflate->state = STATE_BLOCK_HEADER;
+	}
+}
+
+/**
+ * Called at the end of each block.
+ */
+static void end_block(inflate_t *inflate) {
+	if (!inflate->final_block) {
+		inflate->state = STATE_BLOCK_HEADER;
+		return;
+	}
+
+	align(inflate);
+	inflate->header_bytes = 0;
+	inflate->symbol = 0;
+	bool wrapped = inflate->format == INFLATE_GZIP || (inflate->flags & ZLIB_WRAPPED);
+	inflate->state = wrapped ? STATE_TRAILER_CHECK : STATE_DONE;
+}
+
+/**
+ * Read a little (gzip) or big (zlib) endian 32-bit trailer field a byte at a
+ * time into inflate->symbol. Returns true once all four bytes have been read.
+ */
+static bool read_trailer_field(inflate_t *inflate) {
+	while (inflate->header_bytes < 4) {
+		if (!need(inflate, 8)) {
+			return false;
+		}
+		uint32_t byte = peek(inflate, 8);
+		consume(inflate, 8);
+		if (inflate->format == INFLATE_GZIP) {
+			inflate->symbol |= byte << (8 * inflate->header_bytes);
+		} else {
+			inflate->symbol = (inflate->symbol << 8) | byte;
+		}
+		inflate->header_bytes++;
+	}
+	return true;
+}
+
+/**
+ * Decode as much of the input as possible. Returns false on malformed input.
+ */
+static bool run(inflate_t *inflate) {
+	while (true) {
+		switch (inflate->state) {
+			case STATE_GZIP_HEADER:
+				while (inflate->header_bytes < 10) {
+					if (!need(inflate, 8)) {
+						return true;
+					}
+					unsigned int byte = peek(inflate, 8);
+					consume(inflate, 8);
+					// Magic number and compression method (deflate)
+					if ((inflate->header_bytes == 0 && byte != 0x1F) ||
+					    (inflate->header_bytes == 1 && byte != 0x8B) ||
+					    (inflate->header_bytes == 2 && byte != 8)) {
+						return false;
+					} else if (inflate->header_bytes == 3) {
+						inflate->flags = byte;
+					}
+					inflate->header_bytes++;
+				}
+				next_gzip_header_field(inflate);
+				break;
+
+			case STATE_GZIP_EXTRA_LENGTH:
+				if (!need(inflate, 16)) {
+					return true;
+				}
+				inflate->remaining = peek(inflate, 16);
+				consume(inflate, 16);
+				inflate->state = STATE_GZIP_SKIP;
+				break;
+
+			case STATE_GZIP_SKIP:
+				while (inflate->remaining) {
+					if (!need(inflate, 8)) {
+						return true;
+					}
+					consume(inflate, 8);
+					inflate->remaining--;
+				}
+				next_gzip_header_field(inflate);
+				break;
+
+			case STATE_GZIP_NAME:
+			case STATE_GZIP_COMMENT:
+				while (true) {
+					if (!need(inflate, 8)) {
+						return true;
+					}
+					unsigned int byte = peek(inflate, 8);
+					consume(inflate, 8);
+					if (!byte) {
+						break;
+					}
+				}
+				next_gzip_header_field(inflate);
+				break;
+
+			case STATE_ZLIB_HEADER: {
+				if (!need(inflate, 16)) {
+					return true;
+				}
+				unsigned int cmf = peek(inflate, 8);
+				unsigned int flg = peek(inflate, 16) >> 8;
+				// Deflate, a valid check and no preset dictionary: otherwise
+				// assume raw deflate data
+				if ((cmf & 0x0F) == 8 && ((cmf << 8) | flg) % 31 == 0 && !(flg & 0x20)) {
+					consume(inflate, 16);
+					inflate->flags = ZLIB_WRAPPED;
+					inflate->check = 1;
+				}
+				inflate->state = STATE_BLOCK_HEADER;
+				break;
+			}
+
+			case STATE_BLOCK_HEADER: {
+				if (!need(inflate, 3)) {
+					return true;
+				}
+				unsigned int header = peek(inflate, 3);
+				consume(inflate, 3);
+				inflate->final_block = header & 1;
+				switch (header >> 1) {
+					case 0:
+						align(inflate);
+						inflate->state = STATE_STORED_LENGTH;
+						break;
+					case 1:
+						build_fixed_codes(inflate);
+						inflate->state = STATE_SYMBOL;
+						break;
+					case 2:
+						inflate->state = STATE_DYNAMIC_COUNTS;
+						break;
+					default:
+						return false;
+				}
+				break;
+			}
+
+			case STATE_STORED_LENGTH:
+				if (!need(inflate, 16)) {
+					return true;
+				}
+				inflate->remaining = peek(inflate, 16);
+				consume(inflate, 16);
+				inflate->state = STATE_STORED_LENGTH_COMPLEMENT;
+				break;
+
+			case STATE_STORED_LENGTH_COMPLEMENT:
+				if (!need(inflate, 16)) {
+					return true;
+				}
+				if (peek(inflate, 16) != (~inflate->remaining & 0xFFFF)) {
+					return false;
+				}
+				consume(inflate, 16);
+				inflate->state = STATE_STORED_DATA;
+				break;
+
+			case STATE_STORED_DATA:
+				while (inflate->remaining) {
+					if (inflate->bit_count) {
+						put(inflate, peek(inflate, 8));
+						consume(inflate, 8);
+					} else if (inflate->input != inflate->input_end) {
+						put(inflate, *inflate->input++);
+					} else {
+						return true;
+					}
+					inflate->remaining--;
+				}
+				end_block(inflate);
+				break;
+
+			case STATE_DYNAMIC_COUNTS:
+				if (!need(inflate, 14)) {
+					return true;
+				}
+				inflate->num_literal_codes = peek(inflate, 5) + 257;
+				inflate->num_distance_codes = (peek(inflate, 10) >> 5) + 1;
+				inflate->num_code_length_codes = (peek(inflate, 14) >> 10) + 4;
+				consume(inflate, 14);
+				if (inflate->num_literal_codes > 286 || inflate->num_distance_codes > 30) {
+					return false;
+				}
+				memset(inflate->lengths, 0, 19);
+				inflate->num_lengths = 0;
+				inflate->state = STATE_CODE_LENGTH_CODES;
+				break;
+
+			case STATE_CODE_LENGTH_CODES:
+				while (inflate->num_lengths < inflate->num_code_length_codes) {
+					if (!need(inflate, 3)) {
+						return true;
+					}
+					uint8_t symbol = pgm_read_byte(&CODE_LENGTH_ORDER[inflate->num_lengths]);
+					inflate->lengths[symbol] = peek(inflate, 3);
+					consume(inflate, 3);
+					inflate->num_lengths++;
+				}
+				if (!build_code(inflate->distance_counts, inflate->distance_symbols,
+				                inflate->lengths, 19)) {
+					return false;
+				}
+				inflate->num_lengths = 0;
+				inflate->state = STATE_CODE_LENGTHS;
+				break;
+
+			case STATE_CODE_LENGTHS: {
+				unsigned int total = inflate->num_literal_codes + inflate->num_distance_codes;
+				while (inflate->num_lengths < total) {
+					int symbol = decode(inflate, inflate->distance_counts,
+					                    inflate->distance_symbols);
+					if (symbol == DECODE_NEED_INPUT) {
+						return true;
+					} else if (symbol == DECODE_INVALID) {
+						return false;
+					} else if (symbol >= 16) {
+						inflate->symbol = symbol;
+						inflate->state = STATE_CODE_LENGTH_REPEAT;
+						break;
+					}
+					inflate->lengths[inflate->num_lengths++] = symbol;
+				}
+				if (inflate->state == STATE_CODE_LENGTH_REPEAT) {
+					break;
+				}
+
+				const uint8_t *lengths = inflate->lengths;
+				if (!lengths[END_OF_BLOCK] ||
+				    !build_code(inflate->literal_counts, inflate->literal_symbols,
+				                lengths, inflate->num_literal_codes) ||
+				    !build_code(inflate->distance_counts, inflate->distance_symbols,
+				                lengths + inflate->num_literal_codes,
+				                inflate->num_distance_codes)) {
+					return false;
+				}
+				inflate->state = STATE_SYMBOL;
+				break;
+			}
+
+			case STATE_CODE_LENGTH_REPEAT: {
+				// 16: repeat the previous length 3-6 times, 17: 3-10 zeros,
+				// 18: 11-138 zeros
+				unsigned int extra_bits = inflate->symbol == 16 ? 2 : inflate->symbol == 17 ? 3 : 7;
+				if (!need(inflate, extra_bits)) {
+					return true;
+				}
+				unsigned int count = peek(inflate, extra_bits) + (inflate->symbol == 18 ? 11 : 3);
+				consume(inflate, extra_bits);
+
+				uint8_t length = 0;
+				if (inflate->symbol == 16) {
+					if (inflate->num_lengths == 0) {
+						return false;
+					}
+					length = inflate->lengths[inflate->num_lengths - 1];
+				}
+				if (inflate->num_lengths + count >
+				    inflate->num_literal_codes + inflate->num_distance_codes) {
+					return false;
+				}
+				memset(inflate->lengths + inflate->num_lengths, length, count);
+				inflate->num_lengths += count;
+				inflate->state = STATE_CODE_LENGTHS;
+				break;
+			}
+
+			case STATE_SYMBOL: {
+				int symbol;
+				while (true) {
+					symbol = decode(inflate, inflate->literal_counts, inflate->literal_symbols);
+					if (symbol < 0 || symbol >= END_OF_BLOCK) {
+						break;
+					}
+					put(inflate, symbol);
+				}
+				if (symbol == DECODE_NEED_INPUT) {
+					return true;
+				} else if (symbol == DECODE_INVALID || symbol - 257 >= 29) {
+					return false;
+				} else if (symbol == END_OF_BLOCK) {
+					end_block(inflate);
+				} else {
+					inflate->symbol = symbol - 257;
+					inflate->state = STATE_LENGTH_EXTRA;
+				}
+				break;
+			}
+
+			case STATE_LENGTH_EXTRA: {
+				unsigned int extra_bits = pgm_read_byte(&LENGTH_EXTRA_BITS[inflate->symbol]);
+				if (!need(inflate, extra_bits)) {
+					return true;
+				}
+				inflate->remaining = pgm_read_word(&LENGTH_BASES[inflate->symbol]) +
+				                     peek(inflate, extra_bits);
+				consume(inflate, extra_bits);
+				inflate->state = STATE_DISTANCE;
+				break;
+			}
+
+			case STATE_DISTANCE: {
+				int symbol = decode(inflate, inflate->distance_counts, inflate->distance_symbols);
+				if (symbol == DECODE_NEED_INPUT) {
+					return true;
+				} else if (symbol == DECODE_INVALID || symbol >= 30) {
+					return false;
+				}
+				inflate->symbol = symbol;
+				inflate->state = STATE_DISTANCE_EXTRA;
+				break;
+			}
+
+			case STATE_DISTANCE_EXTRA: {
+				unsigned int extra_bits = pgm_read_byte(&DISTANCE_EXTRA_BITS[inflate->symbol]);
+				if (!need(inflate, extra_bits)) {
+					return true;
+				}
+				unsigned int distance = pgm_read_word(&DISTANCE_BASES[inflate->symbol]) +
+				                        peek(inflate, extra_bits);
+				consume(inflate, extra_bits);
+				if (distance > inflate->max_distance) {
+					inflate->max_distance = distance;
+				}
+				if (distance > INFLATE_WINDOW_SIZE || distance > inflate->total_out) {
+					return false;
+				}
+				inflate->distance = distance;
+				inflate->state = STATE_COPY;
+				break;
+			}
+
+			case STATE_COPY:
+				while (inflate->remaining) {
+					size_t from = (inflate->window_pos - inflate->distance) & (INFLATE_WINDOW_SIZE - 1);
+					put(inflate, inflate->window[from]);
+					inflate->remaining--;
+				}
+				inflate->state = STATE_SYMBOL;
+				break;
+
+			case STATE_TRAILER_CHECK:
+				if (!read_trailer_field(inflate)) {
+					return true;
+				}
+				flush(inflate);
+				if (inflate->symbol != inflate->check) {
+					return false;
+				}
+				inflate->header_bytes = 0;
+				inflate->symbol = 0;
+				inflate->state = inflate->format == INFLATE_GZIP ? STATE_TRAILER_SIZE : STATE_DONE;
+				break;
+
+			case STATE_TRAILER_SIZE:
+				if (!read_trailer_field(inflate)) {
+					return true;
+				}
+				if (inflate->symbol != (uint32_t)inflate->total_out) {
+					return false;
+				}
+				inflate->state = STATE_DONE;
+				break;
+
+			case STATE_DONE:
+				return true;
+
+			case STATE_ERROR:
+			default:
+				return false;
+		}
+	}
+}
+
+bool inflate_feed(inflate_t *inflate, const char *data, size_t length) {
+	if (inflate->state == STATE_ERROR) {
+		return false;
+	}
+
+	inflate->input = (const uint8_t *)data;
+	inflate->input_end = inflate->input + length;
+	inflate->total_in += length;
+	if (!run(inflate)) {
+		inflate->state = STATE_ERROR;
+	}
+	flush(inflate);
+	return inflate->state != STATE_ERROR;
+}
+
+bool inflate_done(const inflate_t *inflate) {
+	return inflate->state == STATE_DONE;
+}
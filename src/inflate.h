@@ -0,0 +1,128 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Size of the window of decompressed output kept for back references, as a
+ * power of two (at most 15). Streams referring further back than this are
+ * rejected, so a compressor using the full 32kB window may produce streams
+ * which can't be decompressed (though short-range repetition, such as the
+ * departures feed's repeated key names, rarely needs it). May be overridden at
+ * build time.
+ */
+#ifndef INFLATE_WINDOW_BITS
+#define INFLATE_WINDOW_BITS 12
+#endif
+
+#define INFLATE_WINDOW_SIZE (1u << INFLATE_WINDOW_BITS)
+
+/**
+ * The wrappers around the compressed data.
+ */
+typedef enum {
+	// gzip (RFC 1952), as sent with "Content-Encoding: gzip"
+	INFLATE_GZIP,
+	// zlib (RFC 1950), as sent with "Content-Encoding: deflate", or raw deflate
+	// data (RFC 1951) as sent instead by some servers
+	INFLATE_DEFLATE,
+} inflate_format_t;
+
+/**
+ * Called with each piece of decompressed output.
+ */
+typedef void (*inflate_output_callback_t)(const char *data, size_t length, void *cb_data);
+
+/**
+ * State of an incremental (push) decompressor for deflate data. It is fed
+ * arbitrarily sized chunks of compressed data and passes the decompressed data
+ * to a callback, straight from its window. No heap allocations are made.
+ *
+ * Initialise with inflate_init.
+ */
+typedef struct {
+	// Decoder state (see inflate.cpp)
+	unsigned char state;
+	inflate_format_t format;
+
+	// The compressed data being fed
+	const uint8_t *input;
+	const uint8_t *input_end;
+
+	// Bits read from the input but not yet consumed (least significant first)
+	uint32_t bit_buffer;
+	unsigned char bit_count;
+
+	// The gzip header flags, or bytes of the header or trailer read
+	unsigned char flags;
+	unsigned int header_bytes;
+
+	// Is this the last block?
+	bool final_block;
+
+	// Bytes left in a stored block, to skip in the gzip header or to copy for
+	// a back reference, and its distance
+	unsigned int remaining;
+	unsigned int distance;
+
+	// The length/distance or code length symbol whose extra bits are awaited
+	unsigned int symbol;
+
+	// Code lengths of a dynamic block
+	unsigned int num_literal_codes;
+	unsigned int num_distance_codes;
+	unsigned int num_code_length_codes;
+	unsigned int num_lengths;
+	uint8_t lengths[288 + 32];
+
+	// Canonical Huffman codes: the number of codes of each length and the
+	// symbols in code order. The distance code also holds the code length code
+	// while reading a dynamic block's header.
+	uint16_t literal_counts[16];
+	uint16_t literal_symbols[288];
+	uint16_t distance_counts[16];
+	uint16_t distance_symbols[32];
+
+	// The most recent output, written at window_pos. Output from flush_pos to
+	// window_pos hasn't been passed to the callback yet.
+	uint8_t window[INFLATE_WINDOW_SIZE];
+	size_t window_pos;
+	size_t flush_pos;
+
+	// Check value of the output (CRC-32 for gzip, Adler-32 for zlib)
+	uint32_t check;
+
+	// Compressed bytes fed and decompressed bytes output so far
+	unsigned long total_in;
+	unsigned long total_out;
+
+	// The furthest back reference seen (including one rejected for reaching
+	// beyond the window)
+	unsigned int max_distance;
+
+	inflate_output_callback_t callback;
+	void *callback_data;
+} inflate_t;
+
+/**
+ * Prepare to decompress a new stream.
+ */
+void inflate_init(inflate_t *inflate, inflate_format_t format,
+                  inflate_output_callback_t callback, void *callback_data);
+
+/**
+ * Feed the next chunk of compressed data. All output which can be produced is
+ * passed to the callback before returning. Returns false if the data is
+ * malformed, fails its check or refers back further than the window, after
+ * which further input is ignored.
+ */
+bool inflate_feed(inflate_t *inflate, const char *data, size_t length);
+
+/**
+ * Has the end of the stream (and any check value) been read?
+ */
+bool inflate_done(const inflate_t *inflate);
+
+#endif
@@ -1,13 +1,29 @@
 #include <Arduino.h>
 #include <ESP8266WiFi.h>
-#include <EEPROM.h>
 #include <WiFiClient.h>
 #include <Ticker.h>
-#include <math.h>
 
-#include <jsmn.h>
+extern "C" {
+#include <user_interface.h>
+#include <lwip/dhcp.h>
+#include <lwip/netif.h>
+}
 
 #include "metrolink.h"
+#include "metrolink_map.h"
+#include "departures.h"
+#include "departures_binary.h"
+#include "inflate.h"
+#include "http_fetch.h"
+#include "dns_resolver.h"
+#include "scheduler.h"
+#include "display.h"
+#include "config_journal.h"
+#include "crc32.h"
+#include "power.h"
+#include "perf.h"
+#include "metrics.h"
+#include "metrics_server.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Configuration
@@ -16,22 +32,117 @@
 // The pin number of the display
 const int DISPLAY_PIN = D1;
 
-// The largest number which can be displayed by the output display.
-const int DISPLAY_MAX_VALUE = 12;
+// Version of the configuration schema stored in the journal. Increment when
+// fields are added or change size (see config_journal.h) so that old journals
+// are rewritten in the new form.
+const uint16_t CONFIG_SCHEMA_VERSION = 5;
 
-// The maximum distance the needle may wobble from its nominal position
-const float DISPLAY_WOBBLE_MAGNITUDE = 0.5;
+// The configuration journal occupies the flash sector reserved for the
+// (emulated) EEPROM and, as its spare for compaction, the sector below it at
+// the top of the filesystem area (unused by this firmware, see the ldscript in
+// platformio.ini).
+const size_t CONFIG_SECTOR_SIZE = 4096;
 
-// Number of seconds between display updates
-const float DISPLAY_UPDATE_INTERVAL = 0.1;
+// Address at which the flash is memory mapped
+const uint32_t FLASH_MAPPED_ADDRESS = 0x40200000;
 
-// A magic string written to the start of the EEPROM to validate that the data
-// in EEPROM was actually written by this program.
-const char *EEPROM_MAGIC_STRING = "IOT0";
+// Configurations written by earlier firmware (which stored the configuration
+// struct verbatim) start with one of these magic strings and are imported on
+// load. "IOT0" configurations only have a single journey.
+const char *EEPROM_MAGIC_STRING = "IOT1";
+const char *EEPROM_LEGACY_MAGIC_STRING = "IOT0";
 const size_t EEPROM_MAGIC_STRING_LENGTH = 4;
 
-const char *TFGM_HTTP_HOST = "metrolink.jhnet.co.uk";
+// The maximum number of journeys which may be configured
+const size_t MAX_JOURNEYS = 4;
+
+// The journey whose next departure is shown on the display
+const size_t DISPLAY_JOURNEY = 0;
+
+// The API server, reached over HTTPS (with its public key pinned to the one
+// set with the 'h' menu key). May be overridden at build time (e.g. to point at
+// a local tools/feed_server.py) by defining TRAMBOX_API_HOST and
+// TRAMBOX_API_PORT, and TRAMBOX_API_PLAIN_HTTP to use plain HTTP.
+#ifdef TRAMBOX_API_HOST
+const char *TFGM_API_HOST = TRAMBOX_API_HOST;
+#else
+const char *TFGM_API_HOST = "api.tfgm.com";
+#endif
+// The API server's public key (PEM) until one is set with the 'h' menu key. May
+// be defined at build time, with TRAMBOX_API_PUBLIC_KEY, so that new and
+// upgraded devices can fetch times without being set up over serial.
+#ifdef TRAMBOX_API_PUBLIC_KEY
+const char TFGM_API_PUBLIC_KEY[] = TRAMBOX_API_PUBLIC_KEY;
+#else
+const char TFGM_API_PUBLIC_KEY[] = "";
+#endif
+#ifdef TRAMBOX_API_PLAIN_HTTP
+const bool TFGM_API_TLS = false;
+#else
+const bool TFGM_API_TLS = true;
+#endif
+#ifdef TRAMBOX_API_PORT
+const uint16_t TFGM_API_PORT = TRAMBOX_API_PORT;
+#else
+const uint16_t TFGM_API_PORT = TFGM_API_TLS ? 443 : 80;
+#endif
 const char *TFGM_API_PATH = "/odata/Metrolinks";
+// Compressed responses are only asked for when built with
+// TRAMBOX_API_COMPRESSION, for servers known to compress within the inflate
+// window (INFLATE_WINDOW_BITS, see inflate.h), such as tools/feed_server.py
+// with --compress-window-bits 12. The real API compresses with a larger window,
+// so every response would have to be fetched again uncompressed.
+#ifdef TRAMBOX_API_COMPRESSION
+const bool TFGM_API_COMPRESSION = true;
+#else
+const bool TFGM_API_COMPRESSION = false;
+#endif
+
+// Number of milliseconds to wait for a fast reconnect (using the cached access
+// point and IP configuration) before falling back on a full connect (scanning
+// for the access point and using DHCP)
+const unsigned long WIFI_FAST_CONNECT_TIMEOUT = 5 * 1000;
+
+// Offset of the rtc_data_t in the RTC user memory (in 4 byte blocks)
+const uint32_t RTC_DATA_OFFSET = 0;
+
+// In low power mode, the radio is switched off between polls at least this
+// many milliseconds apart...
+const unsigned long RADIO_SLEEP_MIN_INTERVAL = 10 * 1000;
+
+// ...and switched back on this many milliseconds before the next poll, so
+// that WiFi has reconnected in time
+const unsigned long RADIO_WAKE_LEAD_TIME = 2 * 1000;
+
+// Number of milliseconds a poll waits for a WiFi connection in progress
+// before giving up
+const unsigned long WIFI_CONNECT_GRACE_TIME = 10 * 1000;
+
+// In low power mode, loop() idles for this many milliseconds at a time while
+// no poll is in progress
+const unsigned long LOOP_IDLE_DELAY = 10;
+
+// The display state kept in the RTC memory is only restored after a reset if
+// it was saved less than this many milliseconds earlier
+const unsigned long DISPLAY_RESTORE_MAX_AGE = 10 * 60 * 1000;
+
+// Size of the buffer used to build the request path (including any filter)
+const size_t HTTP_PATH_BUFFER_SIZE = 512;
+
+// Size of the buffer used to build the extra request headers
+const size_t HTTP_HEADERS_BUFFER_SIZE = 224;
+
+// The port on which metrics are served (at /metrics, in the Prometheus text
+// format)
+const uint16_t METRICS_HTTP_PORT = 80;
+
+// Maximum number of milliseconds spent processing the response in each
+// iteration of loop()
+const unsigned long LOOP_TIME_SLICE = 20;
+
+// Successful unfiltered polls after which filtered requests are tried again
+// (see api_filter_enabled)
+const unsigned int API_FILTER_RETRY_POLLS = 20;
 
 ////////////////////////////////////////////////////////////////////////////////
 // State
@@ -39,28 +150,120 @@ const char *TFGM_API_PATH = "/odata/Metrolinks";
 
 Ticker timer;
 
-// The value to be shown on the display
-float display_value = DISPLAY_WOBBLE_MAGNITUDE;
+// The needle animation (see display.h)
+display_t display;
 
-// Should the needle wobble around the current value?
-bool display_wobble = true;
+// Performance measurements (see perf.h), dumped with the 's' menu key. Times
+// are in milliseconds unless stated otherwise.
+struct {
+	// Duration of update_display (CPU cycles) and how far the interval
+	// between calls deviates from DISPLAY_UPDATE_INTERVAL_MS (microseconds)
+	perf_histogram_t display_cycles;
+	perf_histogram_t display_jitter;
+	uint32_t last_display_update_time;
+	
+	// The phases of each departures request: DNS lookup and connecting (for
+	// new connections only), from sending the request to the first byte of
+	// the response, receiving the body and parsing it (microseconds, unlike
+	// the others)
+	perf_histogram_t dns;
+	perf_histogram_t connect;
+	perf_histogram_t first_byte;
+	perf_histogram_t body;
+	perf_histogram_t parse;
+	
+	// DNS lookup plus connecting for new connections whose address was
+	// cached, and which had to look it up (or fell back on the last-known-good
+	// address after failing to)
+	perf_histogram_t connect_dns_cached;
+	perf_histogram_t connect_dns_lookup;
+	
+	// Size of each response and the number of platform records in it
+	perf_histogram_t bytes_received;
+	perf_histogram_t records;
+	
+	// Size of each compressed response's body once decompressed, and the time
+	// spent decompressing it excluding parsing (microseconds)
+	perf_histogram_t bytes_decoded;
+	perf_histogram_t inflate;
+	
+	// Heap before and after each request: free bytes, the largest free block
+	// and fragmentation (percent)
+	perf_histogram_t free_heap_before;
+	perf_histogram_t free_heap_after;
+	perf_histogram_t max_block_before;
+	perf_histogram_t max_block_after;
+	perf_histogram_t fragmentation_before;
+	perf_histogram_t fragmentation_after;
+	
+	// Time to connect (including the TLS handshake) for new HTTPS connections
+	// which made a full handshake and which the server confirmed resumed a
+	// saved session
+	perf_histogram_t tls_full_connect;
+	perf_histogram_t tls_resumed_connect;
+	
+	// Duration of each poll which fetched the departures
+	perf_histogram_t poll;
+	
+	// Number of requests which failed or got an error status
+	unsigned long failed_requests;
+} perf;
 
-// Should the display_value be gradually reduced (by 1 minute per minute)? If
-// the displayed value reaches more than 1+DISPLAY_WOBBLE_MAGNITUDE,
-// display_wobble will be enabled and display_auto_decrement disabled.
-bool display_auto_decrement = false;
+// Names of the histograms in perf, ending with their units, in the order they
+// are dumped
+const struct {
+	const char *name;
+	perf_histogram_t *histogram;
+} PERF_HISTOGRAMS[] = {
+	{"display_update_cycles", &perf.display_cycles},
+	{"display_jitter_us", &perf.display_jitter},
+	{"dns_ms", &perf.dns},
+	{"connect_ms", &perf.connect},
+	{"connect_dns_cached_ms", &perf.connect_dns_cached},
+	{"connect_dns_lookup_ms", &perf.connect_dns_lookup},
+	{"tls_full_connect_ms", &perf.tls_full_connect},
+	{"tls_resumed_connect_ms", &perf.tls_resumed_connect},
+	{"first_byte_ms", &perf.first_byte},
+	{"body_ms", &perf.body},
+	{"parse_us", &perf.parse},
+	{"bytes_received", &perf.bytes_received},
+	{"records", &perf.records},
+	{"bytes_decoded", &perf.bytes_decoded},
+	{"inflate_us", &perf.inflate},
+	{"free_heap_before_bytes", &perf.free_heap_before},
+	{"free_heap_after_bytes", &perf.free_heap_after},
+	{"max_block_before_bytes", &perf.max_block_before},
+	{"max_block_after_bytes", &perf.max_block_after},
+	{"fragmentation_before_percent", &perf.fragmentation_before},
+	{"fragmentation_after_percent", &perf.fragmentation_after},
+	{"poll_ms", &perf.poll},
+};
 
-// The latest time reported by the Metrolink API
+// The latest time reported by the Metrolink API for the displayed journey
 int last_metrolink_wait = -1;
 
+// The latest time reported by the Metrolink API for each journey
+int last_metrolink_waits[MAX_JOURNEYS];
+
 // Time at which the last_metrolink_wait value was changed
 unsigned long last_metrolink_change_time = 0;
 
+// Details of the last successful WiFi connection, used to reconnect without
+// scanning for the access point or waiting for DHCP.
+typedef struct {
+	uint8_t bssid[6];
+	// Zero if nothing is cached
+	uint8_t channel;
+	uint8_t reserved;
+	uint32_t ip;
+	uint32_t gateway;
+	uint32_t subnet;
+	uint32_t dns;
+	// Length of the DHCP lease on ip (seconds), zero if unknown
+	uint32_t lease_time;
+} wifi_cache_t;
 
 typedef struct {
-	// Magic string, should be equal to EEPROM_MAGIC_STRING
-	char magic_string[EEPROM_MAGIC_STRING_LENGTH];
-	
 	// The PWM value to set which makes the display show a given number of minutes.
 	// Values are provided from 0 to DISPLAY_MAX_VALUE (inclusive).
 	int display_pwm_values[DISPLAY_MAX_VALUE + 1];
@@ -72,65 +275,468 @@ typedef struct {
 	// TFGM API key
 	char tfgm_api_key[64];
 	
-	// Start/end station name
-	char station_start[32];
-	char station_end[32];
+	// Start/end station names of each journey. Unused journeys have an empty
+	// start station name.
+	struct {
+		char station_start[32];
+		char station_end[32];
+	} journeys[MAX_JOURNEYS];
+	
+	// The last WiFi connection (so the cache survives power cuts)
+	wifi_cache_t wifi_cache;
+	
+	// Switch the radio off between polls?
+	bool low_power_mode;
+	
+	// PEM encoded public key of the API server, which HTTPS connections are
+	// pinned to
+	char tfgm_public_key[512];
 } eeprom_config_t;
 
 eeprom_config_t config;
 
+// The configuration as last loaded or stored (to find which fields changed)
+eeprom_config_t saved_config;
+
+// The records of the configuration journal. Never reuse an id.
+const config_journal_field_t CONFIG_FIELDS[] = {
+	{1, offsetof(eeprom_config_t, display_pwm_values), sizeof(config.display_pwm_values)},
+	{2, offsetof(eeprom_config_t, wifi_ssid), sizeof(config.wifi_ssid)},
+	{3, offsetof(eeprom_config_t, wifi_password), sizeof(config.wifi_password)},
+	{4, offsetof(eeprom_config_t, tfgm_api_key), sizeof(config.tfgm_api_key)},
+	{5, offsetof(eeprom_config_t, journeys[0]), sizeof(config.journeys[0])},
+	{6, offsetof(eeprom_config_t, journeys[1]), sizeof(config.journeys[1])},
+	{7, offsetof(eeprom_config_t, journeys[2]), sizeof(config.journeys[2])},
+	{8, offsetof(eeprom_config_t, journeys[3]), sizeof(config.journeys[3])},
+	{9, offsetof(eeprom_config_t, wifi_cache), sizeof(config.wifi_cache)},
+	{10, offsetof(eeprom_config_t, low_power_mode), sizeof(config.low_power_mode)},
+	// The public key is split into fields of CONFIG_JOURNAL_MAX_FIELD_SIZE
+	{11, offsetof(eeprom_config_t, tfgm_public_key[0]), 128},
+	{12, offsetof(eeprom_config_t, tfgm_public_key[128]), 128},
+	{13, offsetof(eeprom_config_t, tfgm_public_key[256]), 128},
+	{14, offsetof(eeprom_config_t, tfgm_public_key[384]), 128},
+};
+
+config_journal_t config_journal;
+
+// The layout of configurations written by earlier firmware
+typedef struct {
+	char magic_string[EEPROM_MAGIC_STRING_LENGTH];
+	int display_pwm_values[13];
+	char wifi_ssid[32];
+	char wifi_password[64];
+	char tfgm_api_key[64];
+	// Only the first journey is valid in "IOT0" configurations
+	struct {
+		char station_start[32];
+		char station_end[32];
+	} journeys[4];
+} legacy_config_t;
+
+// The journeys described by config.journeys
+metrolink_journey_t journeys[MAX_JOURNEYS];
+
+// Should requests ask the server to filter departures by station? Disabled if
+// the server rejects the filter or leaves out a requested station, until the
+// journeys change or api_filter_retry_polls more polls have succeeded.
+bool api_filter_enabled = true;
+unsigned int api_filter_retry_polls = 0;
+
+// Should requests accept compressed responses (see TFGM_API_COMPRESSION)?
+// Disabled until restarted if a response can't be decompressed (e.g. because it
+// refers back further than the inflate window).
+bool api_compression_enabled = TFGM_API_COMPRESSION;
+
+// Should requests ask for the binary departures format (see
+// departures_binary.h)? Servers without it respond with JSON. Disabled until
+// restarted if a binary response can't be decoded (e.g. because the server
+// numbers the stations differently).
+bool api_binary_enabled = true;
+
+// Looks up the API server's address, caching it for its TTL
+dns_resolver_t api_resolver;
+
+// The request to the API server (the connection is kept open between polls)
+http_fetch_t api_fetch;
+
+// Serves the metrics
+WiFiServer metrics_listener(METRICS_HTTP_PORT);
+metrics_server_t metrics_server;
+
+// State kept in the RTC memory, which survives resets (but not power cuts)
+typedef struct {
+	// CRC-32 of the rest of the struct
+	uint32_t crc;
+	
+	wifi_cache_t wifi_cache;
+	// The RTC clock when the cached lease was obtained (see wifi_lease_valid)
+	uint32_t wifi_lease_rtc_time;
+	// Has a fast reconnect using the configuration's wifi_cache failed since
+	// it was written?
+	bool wifi_config_cache_failed;
+	
+	// The display animation and displayed wait when display_rtc_time was
+	// read from the RTC clock (which keeps running through resets)
+	bool display_state_valid;
+	display_state_t display_state;
+	int32_t last_metrolink_wait;
+	// Milliseconds since last_metrolink_wait changed
+	uint32_t last_metrolink_age;
+	uint32_t display_rtc_time;
+} rtc_data_t;
+
+rtc_data_t rtc_data;
+
+/**
+ * The phases of connecting to WiFi.
+ */
+typedef enum {
+	// No credentials configured
+	WIFI_IDLE,
+	// Connecting to the cached access point with the cached IP configuration
+	// (or DHCP, if its lease may have expired)
+	WIFI_FAST_CONNECTING,
+	// Connecting to any access point with the SSID using DHCP
+	WIFI_FULL_CONNECTING,
+	WIFI_CONNECTED,
+} wifi_state_t;
+
+wifi_state_t wifi_state = WIFI_IDLE;
+
+// Time (millis()) at which the current connection attempt started
+unsigned long wifi_connect_start_time = 0;
+
+// Is the connection using the cached IP configuration rather than DHCP?
+bool wifi_using_cached_ip = false;
+
+// Set by the WiFi event handlers (which run outside loop())
+volatile bool wifi_got_ip = false;
+volatile bool wifi_disconnected = false;
+WiFiEventHandler wifi_got_ip_handler;
+WiFiEventHandler wifi_disconnected_handler;
+
+// Times (millis()) at which WiFi first connected and a valid wait was first
+// displayed after boot (zero until they happen)
+unsigned long boot_wifi_connected_time = 0;
+unsigned long boot_first_display_time = 0;
+
+// Is the radio switched off until the next poll (in low power mode)?
+bool radio_asleep = false;
+
+// Time spent with the radio on and the CPU working
+power_budget_t power_budget;
+
+// Total CPU time spent updating the display (microseconds). loop() leaves this
+// out of its own time since update_display has already counted it.
+volatile uint32_t display_cpu_time = 0;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Implementation
 ////////////////////////////////////////////////////////////////////////////////
 
+// Defined by the linker script: the start of the sector reserved for EEPROM
+extern "C" uint32_t _EEPROM_start;
+
 /**
- * Read the configuration from eeprom into config struct, returns false if no
- * valid configuration was found in EEPROM, true otherwise.
+ * The flash address of a configuration journal sector: 0 is the EEPROM sector
+ * (where earlier firmware kept the configuration) and 1 the sector below it.
  */
-bool eeprom_load() {
-	for (size_t i = 0 ; i < sizeof(eeprom_config_t); i++) {
-		((char *)&config)[i] = EEPROM.read(i);
+uint32_t config_sector_address(unsigned int sector) {
+	return (uint32_t)(uintptr_t)&_EEPROM_start - FLASH_MAPPED_ADDRESS - sector * CONFIG_SECTOR_SIZE;
+}
+
+bool config_flash_read(unsigned int sector, uint32_t offset, uint32_t *data, size_t length) {
+	return ESP.flashRead(config_sector_address(sector) + offset, data, length);
+}
+
+bool config_flash_write(unsigned int sector, uint32_t offset, const uint32_t *data, size_t length) {
+	return ESP.flashWrite(config_sector_address(sector) + offset, (uint32_t *)data, length);
+}
+
+bool config_flash_erase(unsigned int sector) {
+	return ESP.flashEraseSector(config_sector_address(sector) / CONFIG_SECTOR_SIZE);
+}
+
+const config_journal_flash_t config_flash = {
+	config_flash_read, config_flash_write, config_flash_erase, CONFIG_SECTOR_SIZE,
+};
+
+/**
+ * Fill the config struct with a blank initial configuration.
+ */
+void set_default_config() {
+	for (size_t i = 0; i < DISPLAY_MAX_VALUE + 1; i++) {
+		config.display_pwm_values[i] = 0;
+	}
+	
+	strcpy(config.wifi_ssid, "");
+	strcpy(config.wifi_password, "");
+	
+	strcpy(config.tfgm_api_key, "");
+	
+	for (size_t i = 0; i < MAX_JOURNEYS; i++) {
+		strcpy(config.journeys[i].station_start, "");
+		strcpy(config.journeys[i].station_end, "");
 	}
 	
-	if (strcmp(config.magic_string, EEPROM_MAGIC_STRING) == 0) {
-		// Valid data read!
-		return true;
+	memset(&config.wifi_cache, 0, sizeof(config.wifi_cache));
+	
+	config.low_power_mode = false;
+	
+	snprintf(config.tfgm_public_key, sizeof(config.tfgm_public_key), "%s", TFGM_API_PUBLIC_KEY);
+}
+
+/**
+ * Import a configuration written by earlier firmware, if there is one. Returns
+ * true if one was found.
+ */
+bool import_legacy_config() {
+	legacy_config_t legacy;
+	if (!config_flash_read(0, 0, (uint32_t *)&legacy, sizeof(legacy))) {
+		return false;
+	}
+	
+	size_t num_journeys;
+	if (memcmp(legacy.magic_string, EEPROM_MAGIC_STRING, EEPROM_MAGIC_STRING_LENGTH) == 0) {
+		num_journeys = 4;
+	} else if (memcmp(legacy.magic_string, EEPROM_LEGACY_MAGIC_STRING, EEPROM_MAGIC_STRING_LENGTH) == 0) {
+		num_journeys = 1;
 	} else {
-		// Invalid data, fill the config with a blank initial configuration
-		memcpy(config.magic_string, EEPROM_MAGIC_STRING, EEPROM_MAGIC_STRING_LENGTH);
-		
-		for (size_t i = 0; i < DISPLAY_MAX_VALUE + 1; i++) {
-			config.display_pwm_values[i] = 0;
-		}
-		
-		strcpy(config.wifi_ssid, "");
-		strcpy(config.wifi_password, "");
-		
-		strcpy(config.tfgm_api_key, "");
-		
-		strcpy(config.station_start, "");
-		strcpy(config.station_end, "");
-		
 		return false;
 	}
+	
+	memcpy(config.display_pwm_values, legacy.display_pwm_values, sizeof(config.display_pwm_values));
+	memcpy(config.wifi_ssid, legacy.wifi_ssid, sizeof(config.wifi_ssid));
+	memcpy(config.wifi_password, legacy.wifi_password, sizeof(config.wifi_password));
+	memcpy(config.tfgm_api_key, legacy.tfgm_api_key, sizeof(config.tfgm_api_key));
+	for (size_t i = 0; i < num_journeys && i < MAX_JOURNEYS; i++) {
+		memcpy(&config.journeys[i], &legacy.journeys[i], sizeof(config.journeys[i]));
+	}
+	
+	// Legacy strings were not guaranteed to be terminated
+	config.wifi_ssid[sizeof(config.wifi_ssid) - 1] = '\0';
+	config.wifi_password[sizeof(config.wifi_password) - 1] = '\0';
+	config.tfgm_api_key[sizeof(config.tfgm_api_key) - 1] = '\0';
+	for (size_t i = 0; i < MAX_JOURNEYS; i++) {
+		config.journeys[i].station_start[sizeof(config.journeys[i].station_start) - 1] = '\0';
+		config.journeys[i].station_end[sizeof(config.journeys[i].station_end) - 1] = '\0';
+	}
+	
+	return true;
+}
+
+/**
+ * Read the configuration from flash into config struct, returns false if no
+ * valid configuration was found, true otherwise.
+ */
+bool eeprom_load() {
+	unsigned long start_time = micros();
+	
+	set_default_config();
+	config_journal_init(&config_journal, &config_flash,
+	                    CONFIG_FIELDS, sizeof(CONFIG_FIELDS) / sizeof(CONFIG_FIELDS[0]),
+	                    CONFIG_SCHEMA_VERSION);
+	
+	bool valid = config_journal_load(&config_journal, &config);
+	if (!valid && import_legacy_config()) {
+		Serial.println("Importing configuration from earlier firmware.");
+		valid = true;
+	}
+	
+	// Write imported configurations or journals with an older schema afresh
+	if (valid && config_journal.needs_compaction) {
+		if (!config_journal_format(&config_journal, &config)) {
+			Serial.println("ERROR: Failed to write configuration!");
+		}
+	}
+	memcpy(&saved_config, &config, sizeof(config));
+	
+	unsigned long end_time = micros();
+	Serial.print("Configuration ");
+	Serial.print(valid ? "loaded" : "not found");
+	Serial.print(" in ");
+	Serial.print(end_time - start_time);
+	Serial.print(" us (");
+	Serial.print(end_time / 1000);
+	Serial.print(" ms after boot; ");
+	Serial.print(config_journal.num_records);
+	Serial.print(" records, ");
+	Serial.print(config_journal.end);
+	Serial.print("/");
+	Serial.print(CONFIG_SECTOR_SIZE);
+	Serial.print(" bytes of journal in sector ");
+	Serial.print(config_journal.sector);
+	Serial.print(" used, sectors erased ");
+	Serial.print(config_journal.erase_count);
+	Serial.println(" times)");
+	
+	return valid;
+}
+
+/**
+ * Set up the journeys array from the configured station names.
+ */
+void set_journeys() {
+	api_filter_enabled = true;
+	for (size_t i = 0; i < MAX_JOURNEYS; i++) {
+		metrolink_set_journey(&journeys[i],
+		                      config.journeys[i].station_start,
+		                      config.journeys[i].station_end);
+	}
 }
 
 /**
- * Store the current configuration into EEPROM.
+ * Store the current configuration into flash. Only the fields changed since
+ * the last load or store are written.
  */
 void eeprom_store() {
-	for (size_t i = 0 ; i < sizeof(eeprom_config_t); i++) {
-		EEPROM.write(i, ((char *)&config)[i]);
+	if (config_journal_save(&config_journal, &config, &saved_config)) {
+		memcpy(&saved_config, &config, sizeof(config));
+	} else {
+		Serial.println("ERROR: Failed to save configuration!");
+	}
+}
+
+/**
+ * Read the state kept in the RTC memory, clearing it if it isn't valid (e.g.
+ * after a power cut).
+ */
+void rtc_load() {
+	if (!ESP.rtcUserMemoryRead(RTC_DATA_OFFSET, (uint32_t *)&rtc_data, sizeof(rtc_data)) ||
+	    rtc_data.crc != crc32_update(0, (uint8_t *)&rtc_data + 4, sizeof(rtc_data) - 4)) {
+		memset(&rtc_data, 0, sizeof(rtc_data));
 	}
-	EEPROM.commit();
+	
+	// Resets by the reset pin restart the RTC clock, so the age of the cached
+	// lease is unknown
+	if (ESP.getResetInfoPtr()->reason == REASON_EXT_SYS_RST) {
+		rtc_data.wifi_cache.lease_time = 0;
+	}
+}
+
+/**
+ * Write rtc_data to the RTC memory.
+ */
+void rtc_store() {
+	rtc_data.crc = crc32_update(0, (uint8_t *)&rtc_data + 4, sizeof(rtc_data) - 4);
+	ESP.rtcUserMemoryWrite(RTC_DATA_OFFSET, (uint32_t *)&rtc_data, sizeof(rtc_data));
 }
 
 /**
- * (Re-)Connect to wifi.
+ * Milliseconds since the RTC clock read rtc_time (system_get_rtc_time()).
+ */
+unsigned long rtc_age(uint32_t rtc_time) {
+	// The calibration gives microseconds per RTC clock tick (fixed-point, 12
+	// fractional bits)
+	uint32_t ticks = system_get_rtc_time() - rtc_time;
+	uint64_t age_us = ((uint64_t)ticks * system_rtc_clock_cali_proc()) >> 12;
+	return (unsigned long)(age_us / 1000);
+}
+
+/**
+ * Forget the cached WiFi connection because the credentials changed. The
+ * configuration must be stored afterwards.
+ */
+void clear_wifi_cache() {
+	memset(&config.wifi_cache, 0, sizeof(config.wifi_cache));
+	memset(&rtc_data.wifi_cache, 0, sizeof(rtc_data.wifi_cache));
+	rtc_data.wifi_config_cache_failed = false;
+	rtc_store();
+}
+
+/**
+ * Stop using the cached WiFi connection because a fast reconnect with it
+ * failed. The configuration's copy is left for update_wifi_cache to replace
+ * (only if the next connection differs) so that flash isn't written.
+ */
+void forget_wifi_cache() {
+	memset(&rtc_data.wifi_cache, 0, sizeof(rtc_data.wifi_cache));
+	rtc_data.wifi_config_cache_failed = true;
+	rtc_store();
+}
+
+/**
+ * The length of the lease (seconds) obtained by DHCP for the current
+ * connection, zero if unknown.
+ */
+uint32_t wifi_dhcp_lease_time() {
+	struct dhcp *dhcp = netif_default ? netif_dhcp_data(netif_default) : NULL;
+	return dhcp ? dhcp->offered_t0_lease : 0;
+}
+
+/**
+ * May a cached WiFi connection's IP configuration still be used without DHCP?
+ * Only the RTC memory's copy knows when the lease was obtained. The address is
+ * used for half the lease, until a DHCP client would have renewed it, as
+ * connecting with it doesn't renew the lease.
+ */
+bool wifi_lease_valid(const wifi_cache_t *cache) {
+	return cache == &rtc_data.wifi_cache && cache->lease_time &&
+	       rtc_age(rtc_data.wifi_lease_rtc_time) / 1000 < cache->lease_time / 2;
+}
+
+/**
+ * Cache the details of the current WiFi connection. The configuration is only
+ * written if they changed.
+ */
+void update_wifi_cache() {
+	wifi_cache_t cache;
+	memset(&cache, 0, sizeof(cache));
+	memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+	cache.channel = WiFi.channel();
+	cache.ip = WiFi.localIP();
+	cache.gateway = WiFi.gatewayIP();
+	cache.subnet = WiFi.subnetMask();
+	cache.dns = WiFi.dnsIP();
+	
+	// Reusing the cached IP configuration doesn't extend the lease
+	if (wifi_using_cached_ip) {
+		cache.lease_time = rtc_data.wifi_cache.lease_time;
+	} else {
+		cache.lease_time = wifi_dhcp_lease_time();
+		rtc_data.wifi_lease_rtc_time = system_get_rtc_time();
+	}
+	rtc_data.wifi_cache = cache;
+	rtc_data.wifi_config_cache_failed = false;
+	rtc_store();
+	
+	if (memcmp(&cache, &config.wifi_cache, sizeof(cache)) != 0) {
+		config.wifi_cache = cache;
+		eeprom_store();
+	}
+}
+
+/**
+ * Start connecting to the configured access point with DHCP.
+ */
+void wifi_full_connect() {
+	WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+	WiFi.begin(config.wifi_ssid, config.wifi_password);
+	wifi_using_cached_ip = false;
+	wifi_state = WIFI_FULL_CONNECTING;
+}
+
+/**
+ * (Re-)Connect to wifi. Returns immediately: wifi_poll completes the
+ * connection.
+ *
+ * If a previous connection is cached (in the RTC memory or, after a power cut,
+ * the configuration) the same access point and channel are tried first,
+ * skipping the scan. Its IP configuration is reused too, skipping DHCP, while
+ * the lease is known to be valid (see wifi_lease_valid).
  */
 void wifi_connect() {
+	if (radio_asleep) {
+		WiFi.forceSleepWake();
+		radio_asleep = false;
+		power_budget_set_radio(&power_budget, millis(), true);
+	}
+	
 	WiFi.disconnect(false);
+	wifi_state = WIFI_IDLE;
+	wifi_got_ip = false;
+	wifi_disconnected = false;
 	
 	if (strlen(config.wifi_ssid) == 0) {
 		Serial.println("Can't connect to WiFi: No WiFi credentials configured.");
@@ -139,25 +745,27 @@ void wifi_connect() {
 	Serial.println();
 	Serial.print("Connecting to WiFi ");
 	Serial.println(config.wifi_ssid);
-
-	WiFi.begin(config.wifi_ssid, config.wifi_password);
-
-	for (int i = 0; i < 60; i++) {
-		if (WiFi.status() != WL_CONNECTED) {
-			delay(1000);
-			Serial.print(".");
+	
+	// The credentials are in our own configuration: don't let the SDK write
+	// them to flash on every connect
+	WiFi.persistent(false);
+	WiFi.mode(WIFI_STA);
+	wifi_connect_start_time = millis();
+	
+	const wifi_cache_t *cache = rtc_data.wifi_cache.channel || rtc_data.wifi_config_cache_failed
+	                            ? &rtc_data.wifi_cache : &config.wifi_cache;
+	if (cache->channel) {
+		wifi_using_cached_ip = wifi_lease_valid(cache);
+		if (wifi_using_cached_ip) {
+			WiFi.config(IPAddress(cache->ip), IPAddress(cache->gateway),
+			            IPAddress(cache->subnet), IPAddress(cache->dns));
 		} else {
-			break;
+			WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
 		}
-	}
-	Serial.println("");
-	
-	if (WiFi.status() == WL_CONNECTED) {
-		Serial.println("WiFi connected");
-		Serial.print("IP address: ");
-		Serial.println(WiFi.localIP());
+		WiFi.begin(config.wifi_ssid, config.wifi_password, cache->channel, cache->bssid);
+		wifi_state = WIFI_FAST_CONNECTING;
 	} else {
-		Serial.println("WiFi connection timed out (will keep trying in the background)");
+		wifi_full_connect();
 	}
 }
 
@@ -165,247 +773,567 @@ void wifi_connect() {
  * Called regullarly by the timer to update the displayed value.
  */
 void update_display() {
-	static float wobble_phase = 0.0;
-	
-	// Auto-decrement the time displayed
-	if (display_auto_decrement) {
-		display_value -= DISPLAY_UPDATE_INTERVAL / 60.0;
-		
-		if (display_value < last_metrolink_wait - (1 + DISPLAY_WOBBLE_MAGNITUDE)) {
-			// Maximum deviation from the reported time reached, start wobbling
-			display_auto_decrement = false;
-			display_wobble = true;
-			
-			// Start the wobble from where we are and centered on the 'next' expected
-			// minute
-			display_value = last_metrolink_wait;
-			wobble_phase = 3.14 * 1.5;
-		}
+	uint32_t now = micros();
+	if (perf.display_cycles.count) {
+		int32_t deviation = (int32_t)(now - perf.last_display_update_time) -
+		                    DISPLAY_UPDATE_INTERVAL_MS * 1000;
+		perf_histogram_add(&perf.display_jitter, deviation < 0 ? -deviation : deviation);
 	}
+	perf.last_display_update_time = now;
 	
-	// Wobble the value if required
-	float value = display_value;
-	if (display_wobble) {
-		value += sin(wobble_phase) * DISPLAY_WOBBLE_MAGNITUDE;
-		
-		wobble_phase += 3.14 * DISPLAY_UPDATE_INTERVAL;
-		while (wobble_phase > (3.14*2)) {
-			wobble_phase -= 3.14;
-		}
-	} else {
-		wobble_phase = 0.0;
-	}
+	uint32_t start = ESP.getCycleCount();
+	int pwm = display_update(&display);
+	uint32_t cycles = ESP.getCycleCount() - start;
 	
-	// Clamp the value to the displayable range
-	if (value < 0.0) {
-		value = 0.0;
-	} else if (value > DISPLAY_MAX_VALUE) {
-		value = DISPLAY_MAX_VALUE;
-	}
+	analogWrite(DISPLAY_PIN, pwm);
 	
-	// Interpolate PWM values
-	int value_low = floorf(value);
-	int value_high = ceilf(value);
+	perf_histogram_add(&perf.display_cycles, cycles);
+	uint32_t us = cycles / ESP.getCpuFreqMHz();
+	display_cpu_time += us;
+	power_budget_add_cpu_time(&power_budget, us);
+}
+
+/**
+ * Save the display animation to the RTC memory. The animation is
+ * deterministic, so this is only needed when it changes course.
+ */
+void save_display_state() {
+	display_save_state(&display, &rtc_data.display_state);
+	rtc_data.display_state_valid = true;
+	rtc_data.last_metrolink_wait = last_metrolink_wait;
+	rtc_data.last_metrolink_age = millis() - last_metrolink_change_time;
+	rtc_data.display_rtc_time = system_get_rtc_time();
+	rtc_store();
+}
+
+/**
+ * Carry on with the display animation saved before a reset, if it is recent.
+ */
+void restore_display_state() {
+	// Resets by the reset pin (and power cuts) restart the RTC clock
+	if (!rtc_data.display_state_valid || ESP.getResetInfoPtr()->reason == REASON_EXT_SYS_RST) {
+		return;
+	}
 	
-	int pwm_low = config.display_pwm_values[value_low];
-	int pwm_high = config.display_pwm_values[value_high];
-	int pwm_range = pwm_high - pwm_low;
+	unsigned long age = rtc_age(rtc_data.display_rtc_time);
+	if (age > DISPLAY_RESTORE_MAX_AGE) {
+		return;
+	}
 	
-	int pwm = pwm_low + (pwm_range * (value - value_low));
+	display_restore_state(&display, &rtc_data.display_state, age / DISPLAY_UPDATE_INTERVAL_MS);
+	last_metrolink_wait = rtc_data.last_metrolink_wait;
+	last_metrolink_waits[DISPLAY_JOURNEY] = last_metrolink_wait;
+	last_metrolink_change_time = millis() - (rtc_data.last_metrolink_age + age);
 	
-	analogWrite(DISPLAY_PIN, pwm);
+	Serial.print("Display state restored (saved ");
+	Serial.print(age);
+	Serial.println(" ms ago)");
 }
 
 
 /**
- * Parse a JSON object defining the display of a tram information screen.
- * Returns the lowest number of minutes until the next tram departure or -1 if
- * no value was found.
+ * The outcome of parsing a departures response.
  */
-int parse_value(String &object) {
-	// Determine number of JSON tokens in object
-	jsmn_parser parser;
-	jsmn_init(&parser);
-	int numTokens = jsmn_parse(&parser, object.c_str(), object.length(), NULL, 0);
-	if (numTokens < 1) {
-		// Bad JSON!
-		Serial.println("WARNING: Failed to parse response JSON.");
-		return -1;
-	}
+typedef struct {
+	// Minimum wait for each journey or -1 if no departure was found
+	int waits[MAX_JOURNEYS];
 	
-	jsmn_init(&parser);
-	jsmntok_t *tokens = new jsmntok_t[numTokens];
-	numTokens = jsmn_parse(&parser, object.c_str(), object.length(), tokens, numTokens);
-	if (numTokens < 1) {
-		// Bad JSON!
-		Serial.println("WARNING: Failed to parse response JSON.");
-		delete[] tokens;
-		return -1;
+	// Was at least one platform record found for each journey's start station?
+	bool start_seen[MAX_JOURNEYS];
+} departures_result_t;
+
+void clear_result(departures_result_t *result) {
+	for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+		result->waits[j] = -1;
+		result->start_seen[j] = false;
 	}
+}
+
+/**
+ * Called by the departures parser for each platform record in the feed. Updates
+ * the departures_result_t pointed to by data with the lowest number of minutes
+ * until a departure from each journey's start station which stops at its
+ * destination.
+ */
+void process_record(const departures_record_t *record, void *data) {
+	departures_result_t *result = (departures_result_t *)data;
 	
-	if (tokens[0].type != JSMN_OBJECT) {
-		Serial.println("WARNING: JSON response did not contain expected object.");
-		delete[] tokens;
-		return -1;
+	int station_index = metrolink_get_station_index(record->station_location);
+	if (station_index < 0) {
+		return;
 	}
 	
-	
-	// Extract the StationLocation, DestN and WaitN fields from the JSON
-	String station_location;
-	const size_t destinations_per_object = 4;
-	struct {
-		String name;
-		int wait;
-	} destinations[destinations_per_object];
-	
-	for (size_t i = 1; i < (tokens[0].size*2)+1; i += 2) {
-		if (tokens[i].type != JSMN_STRING ||
-		    (tokens[i+1].type != JSMN_STRING &&
-		     tokens[i+1].type != JSMN_PRIMITIVE)) {
-			// Expected all key-value pairs!
-			Serial.println("WARNING: Unexpected value in JSON object.");
-			break;
+	for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+		if (journeys[j].start_index != station_index) {
+			continue;
 		}
+		result->start_seen[j] = true;
 		
-		String key = object.substring(tokens[i].start, tokens[i].end);
-		String value= object.substring(tokens[i+1].start, tokens[i+1].end);
-		if (key == "StationLocation") {
-			station_location = value;
-		} else if (key == "Dest0") {
-			destinations[0].name = value;
-		} else if (key == "Dest1") {
-			destinations[1].name = value;
-		} else if (key == "Dest2") {
-			destinations[2].name = value;
-		} else if (key == "Dest3") {
-			destinations[3].name = value;
-		} else if (key == "Wait0") {
-			destinations[0].wait = atoi(value.c_str());
-		} else if (key == "Wait1") {
-			destinations[1].wait = atoi(value.c_str());
-		} else if (key == "Wait2") {
-			destinations[2].wait = atoi(value.c_str());
-		} else if (key == "Wait3") {
-			destinations[3].wait = atoi(value.c_str());
+		int *min_wait = &result->waits[j];
+		for (size_t i = 0; i < DEPARTURES_MAX_DESTINATIONS; i++) {
+			if (record->destinations[i].name[0] &&
+			    (record->destinations[i].wait < *min_wait || *min_wait == -1) &&
+			    metrolink_is_destination_valid(&journeys[j], record->destinations[i].name)) {
+				*min_wait = record->destinations[i].wait;
+			}
 		}
 	}
+}
+
+/**
+ * Called by the binary departures decoder for each platform record: as
+ * process_record, but with stations already given by index.
+ */
+void process_binary_record(const departures_binary_record_t *record, void *data) {
+	departures_result_t *result = (departures_result_t *)data;
 	
-	int min_wait = -1;
-	if (metrolink_station_names_equal(station_location.c_str(), config.station_start)) {
-		for (size_t i = 0; i < destinations_per_object; i++) {
-			if (destinations[i].name.length() &&
-			    (destinations[i].wait < min_wait || min_wait == -1) &&
-			    metrolink_is_destination_valid(destinations[i].name.c_str())) {
-				min_wait = destinations[i].wait;
+	for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+		if (journeys[j].start_index != record->station_index) {
+			continue;
+		}
+		result->start_seen[j] = true;
+		
+		int *min_wait = &result->waits[j];
+		for (size_t i = 0; i < record->num_destinations; i++) {
+			if ((record->destinations[i].wait < *min_wait || *min_wait == -1) &&
+			    metrolink_is_destination_index_valid(&journeys[j],
+			                                         record->destinations[i].station_index)) {
+				*min_wait = record->destinations[i].wait;
 			}
 		}
 	}
-	
-	delete[] tokens;
-	return min_wait;
 }
 
 /**
- * Indicate a problem by bouncing the needle around between 0 and 1.
+ * State of a single departures request.
+ */
+typedef struct {
+	departures_result_t result;
+	departures_parser_t parser;
+	
+	// Is the body in the binary format (decoded by binary_decoder rather than
+	// parser)?
+	bool binary;
+	departures_binary_t binary_decoder;
+	
+	// Did the departures parser (or binary decoder) reject the response body?
+	bool parse_error;
+	
+	// Has the start of the body been seen (and the decompressor set up if the
+	// body is compressed)?
+	bool body_started;
+	
+	// Is the body compressed, and did it fail to decompress (or use an
+	// unsupported encoding)?
+	bool compressed;
+	bool decode_error;
+#ifdef TRAMBOX_API_COMPRESSION
+	inflate_t inflate;
+#endif
+	
+	// Lowest free heap seen while parsing the response
+	uint32_t min_free_heap;
+	
+	// Time spent parsing and decompressing the response (microseconds)
+	uint32_t parse_time;
+	uint32_t inflate_time;
+} departures_fetch_t;
+
+departures_fetch_t departures_fetch;
+
+/**
+ * The phases of a poll of the API.
+ */
+typedef enum {
+	// Waiting until next_poll_time
+	POLL_IDLE,
+	// Fetching departures for the journeys' start stations only
+	POLL_FILTERED,
+	// Fetching all departures
+	POLL_UNFILTERED,
+} poll_state_t;
+
+poll_state_t poll_state = POLL_IDLE;
+
+// Time (millis()) at which the next poll should start
+unsigned long next_poll_time = 0;
+
+// Time (millis()) at which the current poll started
+unsigned long poll_start_time = 0;
+
+// Chooses the time of the next poll
+scheduler_t poll_scheduler;
+
+/**
+ * Indicate a problem by bouncing the needle around between 0 and 1 or, if no
+ * times can be fetched until the API server's public key is set, by holding it
+ * at DISPLAY_MAX_VALUE.
  */
 void show_error_display() {
-	display_value = DISPLAY_WOBBLE_MAGNITUDE;
-	display_wobble = true;
-	display_auto_decrement = false;
+	if (TFGM_API_TLS && !api_fetch.public_key_valid) {
+		display_show_value(&display, DISPLAY_MAX_VALUE);
+	} else {
+		display_show_error(&display);
+	}
 }
 
 /**
- * Attempt to fetch the number of minutes until the next departure or -1 if no
- * departure time is known.
+ * Build the path to request from the API into buf. If filter is true, the
+ * request asks the server to return only records for the journeys' start
+ * stations. Returns false if the path didn't fit.
  */
-int get_next_departure_wait() {
-	if (WiFi.status() != WL_CONNECTED) {
-		Serial.println("WiFi not connected, not fetching times...");
-		show_error_display();
-		return -1;
+bool build_request_path(char *buf, size_t size, bool filter) {
+	// The station names, copied out of flash
+	char names[MAX_JOURNEYS][METROLINK_NAME_BUFFER_SIZE];
+	int indices[MAX_JOURNEYS];
+	const char *stations[MAX_JOURNEYS];
+	size_t num_stations = 0;
+	
+	for (size_t j = 0; filter && j < MAX_JOURNEYS; j++) {
+		int index = journeys[j].start_index;
+		if (index < 0) {
+			continue;
+		}
+		
+		bool duplicate = false;
+		for (size_t i = 0; i < num_stations; i++) {
+			duplicate |= indices[i] == index;
+		}
+		if (!duplicate) {
+			metrolink_get_station_name(index, names[num_stations], sizeof(names[0]));
+			indices[num_stations] = index;
+			stations[num_stations] = names[num_stations];
+			num_stations++;
+		}
 	}
 	
-	Serial.println("Fetching tram times...");
+	return departures_build_request_path(buf, size, TFGM_API_PATH,
+	                                     stations, num_stations);
+}
+
+/**
+ * Called with each piece of the (decompressed) response body to pass it to the
+ * departures parser or binary decoder.
+ */
+void parse_response_body(const char *data, size_t length, void *cb_data) {
+	departures_fetch_t *fetch = (departures_fetch_t *)cb_data;
+	if (!fetch->parse_error) {
+		uint32_t start = micros();
+		fetch->parse_error = fetch->binary
+		                     ? !departures_binary_feed(&fetch->binary_decoder, data, length)
+		                     : !departures_parser_feed(&fetch->parser, data, length);
+		fetch->parse_time += micros() - start;
+	}
+}
+
+/**
+ * Number of platform records in the response so far.
+ */
+size_t fetch_num_records(const departures_fetch_t *fetch) {
+	return fetch->binary ? fetch->binary_decoder.num_records : fetch->parser.num_records;
+}
+
+/**
+ * Called with each piece of the response body. Bodies of successful responses
+ * are decompressed, if necessary, and parsed.
+ */
+void process_response_body(const char *data, size_t length, void *cb_data) {
+	departures_fetch_t *fetch = (departures_fetch_t *)cb_data;
+	if (api_fetch.response.status != 200 || fetch->decode_error) {
+		return;
+	}
 	
-	WiFiClient client;
-	if (!client.connect(TFGM_HTTP_HOST, 80)) {
-		Serial.println("ERROR: HTTP connection failed!");
-		return -1;
+	if (!fetch->body_started) {
+		fetch->body_started = true;
+		fetch->binary = strcmp(api_fetch.response.content_type,
+		                       DEPARTURES_BINARY_CONTENT_TYPE) == 0;
+		switch (api_fetch.response.content_encoding) {
+			case HTTP_CONTENT_IDENTITY:
+				break;
+#ifdef TRAMBOX_API_COMPRESSION
+			case HTTP_CONTENT_GZIP:
+			case HTTP_CONTENT_DEFLATE:
+				fetch->compressed = true;
+				inflate_init(&fetch->inflate,
+				             api_fetch.response.content_encoding == HTTP_CONTENT_GZIP
+				             ? INFLATE_GZIP : INFLATE_DEFLATE,
+				             parse_response_body, fetch);
+				break;
+#endif
+			default:
+				fetch->decode_error = true;
+				return;
+		}
 	}
 	
-	// Send headers
-	client.print("GET ");
-	client.print(TFGM_API_PATH);
-	client.print(" HTTP/1.1\r\n");
+	if (fetch->compressed) {
+#ifdef TRAMBOX_API_COMPRESSION
+		// The parser is called from within inflate_feed: don't count its time
+		uint32_t start = micros();
+		uint32_t parse_time = fetch->parse_time;
+		fetch->decode_error = !inflate_feed(&fetch->inflate, data, length);
+		fetch->inflate_time += (micros() - start) - (fetch->parse_time - parse_time);
+#endif
+	} else {
+		parse_response_body(data, length, fetch);
+	}
 	
-	client.print("Host: ");
-	client.print(TFGM_HTTP_HOST);
-	client.print("\r\n");
+	uint32_t free_heap = ESP.getFreeHeap();
+	if (free_heap < fetch->min_free_heap) {
+		fetch->min_free_heap = free_heap;
+	}
+}
+
+/**
+ * Begin a request for the departures, filtered by the journeys' start stations
+ * if filter is true (and the filter fits in the request). Returns true if the
+ * request is filtered.
+ */
+bool start_departures_fetch(bool filter) {
+	char path[HTTP_PATH_BUFFER_SIZE];
+	filter = filter && build_request_path(path, sizeof(path), true);
+	if (!filter) {
+		build_request_path(path, sizeof(path), false);
+	}
 	
-	client.print("Connection: close\r\n");
+	char headers[HTTP_HEADERS_BUFFER_SIZE];
+	snprintf(headers, sizeof(headers),
+	         "User-Agent: InternetOfTrams\r\n"
+	         "Ocp-Apim-Subscription-Key: %s\r\n"
+	         "%s"
+	         "%s",
+	         config.tfgm_api_key,
+	         api_compression_enabled ? "Accept-Encoding: gzip, deflate\r\n" : "",
+	         api_binary_enabled
+	         ? "Accept: " DEPARTURES_BINARY_CONTENT_TYPE ", application/json;q=0.5\r\n" : "");
 	
-	client.print("User-Agent: InternetOfTrams\r\n");
+	clear_result(&departures_fetch.result);
+	departures_parser_init(&departures_fetch.parser, process_record, &departures_fetch.result);
+	departures_binary_init(&departures_fetch.binary_decoder, process_binary_record,
+	                       &departures_fetch.result);
+	departures_fetch.binary = false;
+	departures_fetch.parse_error = false;
+	departures_fetch.body_started = false;
+	departures_fetch.compressed = false;
+	departures_fetch.decode_error = false;
+	departures_fetch.min_free_heap = ESP.getFreeHeap();
+	departures_fetch.parse_time = 0;
+	departures_fetch.inflate_time = 0;
+	
+	perf_histogram_add(&perf.free_heap_before, departures_fetch.min_free_heap);
+	perf_histogram_add(&perf.max_block_before, ESP.getMaxFreeBlockSize());
+	perf_histogram_add(&perf.fragmentation_before, ESP.getHeapFragmentation());
+	
+	http_fetch_start(&api_fetch, path, headers, process_response_body, &departures_fetch);
+	return filter;
+}
+
+/**
+ * Add the measurements of a finished departures request to perf.
+ */
+void record_fetch_perf() {
+	const unsigned long *phase_times = api_fetch.phase_times;
+	if (!api_fetch.reused) {
+		perf_histogram_add(&perf.dns, phase_times[HTTP_FETCH_RESOLVING]);
+		perf_histogram_add(&perf.connect, phase_times[HTTP_FETCH_CONNECTING]);
+		if (api_fetch.dns_result != DNS_RESOLVER_PENDING) {
+			perf_histogram_add(api_fetch.dns_result == DNS_RESOLVER_CACHED
+			                   ? &perf.connect_dns_cached
+			                   : &perf.connect_dns_lookup,
+			                   phase_times[HTTP_FETCH_RESOLVING] +
+			                   phase_times[HTTP_FETCH_CONNECTING]);
+		}
+	}
+	if (api_fetch.tls_connected) {
+		perf_histogram_add(api_fetch.session_resumed ? &perf.tls_resumed_connect
+		                                             : &perf.tls_full_connect,
+		                   api_fetch.tls_connect_time);
+	}
+	if (api_fetch.bytes_received) {
+		perf_histogram_add(&perf.first_byte, api_fetch.first_byte_time);
+	}
 	
-	client.print("Ocp-Apim-Subscription-Key: ");
-	client.print(config.tfgm_api_key);
-	client.print("\r\n");
+	if (api_fetch.state == HTTP_FETCH_DONE && api_fetch.response.status == 200) {
+		perf_histogram_add(&perf.body, phase_times[HTTP_FETCH_BODY]);
+		perf_histogram_add(&perf.parse, departures_fetch.parse_time);
+		perf_histogram_add(&perf.bytes_received, api_fetch.bytes_received);
+		perf_histogram_add(&perf.records, fetch_num_records(&departures_fetch));
+#ifdef TRAMBOX_API_COMPRESSION
+		if (departures_fetch.compressed && !departures_fetch.decode_error) {
+			perf_histogram_add(&perf.bytes_decoded, departures_fetch.inflate.total_out);
+			perf_histogram_add(&perf.inflate, departures_fetch.inflate_time);
+		}
+#endif
+	} else {
+		perf.failed_requests++;
+	}
 	
-	client.print("\r\n");
+	perf_histogram_add(&perf.free_heap_after, ESP.getFreeHeap());
+	perf_histogram_add(&perf.max_block_after, ESP.getMaxFreeBlockSize());
+	perf_histogram_add(&perf.fragmentation_after, ESP.getHeapFragmentation());
+}
+
+/**
+ * Report the outcome of a finished departures request. Returns the HTTP status
+ * code of the response or -1 if the request failed.
+ */
+int finish_departures_fetch() {
+	record_fetch_perf();
 	
-	// Read past response headers
-	while (client.connected() && client.readStringUntil('\n') != "\r")
-		;
+	if (api_fetch.state == HTTP_FETCH_FAILED) {
+		Serial.print("ERROR: HTTP request failed: ");
+		Serial.println(api_fetch.error);
+		return -1;
+	}
 	
-	// Read up to start of data (the response is an object containing an array of
-	// data values)
-	client.readStringUntil('[');
+	int status = api_fetch.response.status;
+	if (status != 200) {
+		Serial.print("ERROR: HTTP request failed with status ");
+		Serial.println(status);
+		return status;
+	}
 	
-	// Read data entries one at a time.
-	int min_wait = -1;
-	while (client.connected()) {
-		String object = client.readStringUntil('}') + "}";
-		
-		int this_wait = parse_value(object);
-		if (this_wait >= 0 &&
-		    (this_wait < min_wait || min_wait == -1)) {
-			min_wait = this_wait;
+#ifdef TRAMBOX_API_COMPRESSION
+	if (departures_fetch.compressed && !departures_fetch.decode_error &&
+	    !inflate_done(&departures_fetch.inflate)) {
+		// The body ended before the end of the compressed stream
+		departures_fetch.decode_error = true;
+	}
+#endif
+	if (departures_fetch.decode_error) {
+		Serial.print("WARNING: Failed to decode response body");
+#ifdef TRAMBOX_API_COMPRESSION
+		if (departures_fetch.compressed) {
+			Serial.print(" after ");
+			Serial.print(departures_fetch.inflate.total_out);
+			Serial.print(" bytes (furthest back reference ");
+			Serial.print(departures_fetch.inflate.max_distance);
+			Serial.print(" bytes, window ");
+			Serial.print(INFLATE_WINDOW_SIZE);
+			Serial.print(" bytes)");
 		}
-		
-		// Skip past adjoining comma between objects
-		client.readStringUntil(',');
+#endif
+		Serial.println(".");
+	} else if (departures_fetch.binary && !departures_fetch.parse_error &&
+	           !departures_binary_done(&departures_fetch.binary_decoder)) {
+		// The body ended before the last record
+		departures_fetch.parse_error = true;
+	}
+	if (departures_fetch.parse_error && !departures_fetch.decode_error) {
+		Serial.println(departures_fetch.binary
+		               ? "WARNING: Failed to decode binary response."
+		               : "WARNING: Failed to parse response JSON.");
 	}
 	
-	// Done!
-	client.stop();
-	if (min_wait >= 0) {
-		Serial.print("Wait time is ");
-		Serial.print(min_wait);
-		Serial.println(" min");
-	} else {
-		Serial.println("No next tram time found...");
+	unsigned long duration = millis() - api_fetch.start_time;
+	Serial.print("Read ");
+	Serial.print(api_fetch.bytes_received);
+	Serial.print(" bytes");
+#ifdef TRAMBOX_API_COMPRESSION
+	if (departures_fetch.compressed) {
+		Serial.print(", ");
+		Serial.print(departures_fetch.inflate.total_out);
+		Serial.print(" bytes decompressed in ");
+		Serial.print(departures_fetch.inflate_time);
+		Serial.print(" us");
+	}
+#endif
+	Serial.print(" (");
+	Serial.print(fetch_num_records(&departures_fetch));
+	Serial.print(departures_fetch.binary ? " binary records) in " : " records) in ");
+	Serial.print(duration);
+	Serial.print(" ms (");
+	Serial.print(duration ? (api_fetch.bytes_received * 1000) / duration : 0);
+	Serial.print(" bytes/s), minimum free heap ");
+	Serial.print(departures_fetch.min_free_heap);
+	Serial.println(" bytes");
+	
+	const http_fetch_stats_t *stats = &api_fetch.stats;
+	Serial.print("HTTP connection ");
+	Serial.print(api_fetch.reused ? "reused" : "opened");
+	Serial.print(": ");
+	Serial.print(stats->reused);
+	Serial.print("/");
+	Serial.print(stats->requests);
+	Serial.print(" requests reused a connection, ");
+	Serial.print(stats->dropped);
+	Serial.print(" dropped, mean connect time ");
+	Serial.print(stats->connects ? stats->total_connect_time / stats->connects : 0);
+	Serial.println(" ms");
+	if (api_fetch.tls_connected) {
+		Serial.print("TLS handshake: ");
+		Serial.print(api_fetch.session_resumed ? "session resumed"
+		             : api_fetch.session_offered ? "full (saved session not resumed)" : "full");
+		Serial.print(", connected in ");
+		Serial.print(api_fetch.tls_connect_time);
+		Serial.println(" ms");
+	}
+	
+	return status;
+}
+
+/**
+ * Print the number of minutes until the next departure for every journey.
+ */
+void print_departure_waits(const int waits[MAX_JOURNEYS]) {
+	metrolink_cache_stats_t cache_stats;
+	metrolink_get_cache_stats(&cache_stats);
+	Serial.print("Destination cache: ");
+	Serial.print(cache_stats.hits);
+	Serial.print(" hits, ");
+	Serial.print(cache_stats.misses);
+	Serial.println(" misses");
+	
+	for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+		if (!config.journeys[j].station_start[0]) {
+			continue;
+		}
+		
+		Serial.print("Journey ");
+		Serial.print(j + 1);
+		Serial.print(" (");
+		Serial.print(config.journeys[j].station_start);
+		Serial.print(" to ");
+		Serial.print(config.journeys[j].station_end);
+		Serial.print("): ");
+		if (waits[j] >= 0) {
+			Serial.print("wait time is ");
+			Serial.print(waits[j]);
+			Serial.println(" min");
+		} else {
+			Serial.println("no next tram time found...");
+		}
 	}
-	return min_wait;
 }
 
 /**
- * If the display is already showing the current wait time, update it with any
- * new value.
+ * Record the latest wait times (-1 where unknown) and, if the display is
+ * already showing the current wait time, update it with any new value.
  */
-void update_wait_display() {
-	int wait = get_next_departure_wait();
+void update_wait_display(const int waits[MAX_JOURNEYS]) {
+	memcpy(last_metrolink_waits, waits, sizeof(last_metrolink_waits));
+	int wait = last_metrolink_waits[DISPLAY_JOURNEY];
 	if (wait != last_metrolink_wait) {
 		last_metrolink_wait = wait;
 		last_metrolink_change_time = millis();
 		
 		if (wait >= 0) {
 			// Wait is valid
-			display_value = wait;
-			display_auto_decrement = true;
-			display_wobble = false;
+			display_show_wait(&display, wait, 0);
+			
+			if (!boot_first_display_time) {
+				boot_first_display_time = last_metrolink_change_time;
+				Serial.print("Time to first valid display: ");
+				Serial.print(boot_first_display_time);
+				Serial.print(" ms after boot (WiFi connected after ");
+				Serial.print(boot_wifi_connected_time);
+				Serial.println(" ms)");
+			}
 		} else {
 			// Wait is invalid, just bounce around between 0 and 1.
 			show_error_display();
 		}
+		save_display_state();
 	}
 }
 
@@ -416,16 +1344,284 @@ void show_wait_display() {
 	if (last_metrolink_wait < 0) {
 		show_error_display();
 	} else {
-		float delta = ((float)millis()) - ((float)last_metrolink_change_time);
-		delta /= (60 * 1000); // Scale to minutes
-		if (delta > 1.0 + DISPLAY_WOBBLE_MAGNITUDE) { // Clamp to a reasonable size
-			delta = 1.0 + DISPLAY_WOBBLE_MAGNITUDE;
+		// Show the updated time
+		display_show_wait(&display, last_metrolink_wait, millis() - last_metrolink_change_time);
+	}
+	save_display_state();
+}
+
+/**
+ * Choose when to make the next poll, given whether the last one succeeded and
+ * how long it took, and report polling statistics.
+ */
+void schedule_next_poll(bool success, unsigned long duration) {
+	unsigned long now = millis();
+	unsigned long interval = scheduler_poll_complete(&poll_scheduler, success, duration,
+	                                                 last_metrolink_wait,
+	                                                 now - last_metrolink_change_time);
+	next_poll_time = now + interval;
+	
+	Serial.print("Next poll in ");
+	Serial.print(interval / 1000);
+	Serial.print(" s (");
+	Serial.print(scheduler_polls_per_hour(&poll_scheduler, now));
+	Serial.print(" polls/hour, radio active for ");
+	Serial.print(poll_scheduler.radio_on_time / 1000);
+	Serial.print(" s, ");
+	Serial.print(scheduler_radio_on_percent(&poll_scheduler, now));
+	Serial.println("% of the time)");
+	
+	power_budget_hourly_t hourly;
+	power_budget_per_hour(&power_budget, now, &hourly);
+	Serial.print("Per hour: radio on for ");
+	Serial.print(hourly.radio_on);
+	Serial.print(" s, radio asleep for ");
+	Serial.print(hourly.radio_asleep);
+	Serial.print(" s, CPU active for at most ");
+	Serial.print(hourly.cpu_active);
+	Serial.println(" s");
+	
+	Serial.print("Display updates take ");
+	Serial.print(perf_histogram_mean(&perf.display_cycles));
+	Serial.print(" cycles on average, ");
+	Serial.print(perf.display_cycles.max);
+	Serial.println(" at most");
+}
+
+/**
+ * Advance the current poll of the API, or start a new one if it is due. Does a
+ * bounded amount of work and never waits for the network.
+ *
+ * Each poll fetches the departures for every journey with a single request.
+ */
+void poll_departures() {
+	if (poll_state == POLL_IDLE) {
+		if ((long)(millis() - next_poll_time) < 0) {
+			return;
 		}
 		
-		// Show the updated time
-		display_auto_decrement = true;
-		display_wobble = false;
-		display_value = last_metrolink_wait - delta;
+		if (WiFi.status() != WL_CONNECTED) {
+			if ((wifi_state == WIFI_FAST_CONNECTING || wifi_state == WIFI_FULL_CONNECTING) &&
+			    millis() - wifi_connect_start_time < WIFI_CONNECT_GRACE_TIME) {
+				// Give the connection in progress a chance
+				return;
+			}
+			
+			Serial.println("WiFi not connected, not fetching times...");
+			int waits[MAX_JOURNEYS];
+			for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+				waits[j] = -1;
+			}
+			update_wait_display(waits);
+			schedule_next_poll(false, 0);
+			return;
+		}
+		
+		Serial.println("Fetching tram times...");
+		poll_start_time = millis();
+		poll_state = start_departures_fetch(api_filter_enabled) ? POLL_FILTERED : POLL_UNFILTERED;
+	}
+	
+	if (http_fetch_busy(&api_fetch)) {
+		http_fetch_poll(&api_fetch, LOOP_TIME_SLICE);
+		if (http_fetch_busy(&api_fetch)) {
+			return;
+		}
+	}
+	
+	int status = finish_departures_fetch();
+	departures_result_t *result = &departures_fetch.result;
+	
+	if (status == 200 && departures_fetch.decode_error && api_compression_enabled) {
+		Serial.println("Compressed response unusable, fetching it uncompressed instead.");
+		api_compression_enabled = false;
+		start_departures_fetch(poll_state == POLL_FILTERED);
+		return;
+	}
+	
+	if (status == 200 && departures_fetch.binary && departures_fetch.parse_error &&
+	    api_binary_enabled) {
+		Serial.println("Binary response unusable, fetching JSON instead.");
+		api_binary_enabled = false;
+		start_departures_fetch(poll_state == POLL_FILTERED);
+		return;
+	}
+	
+	if (poll_state == POLL_FILTERED && status >= 0) {
+		// If the server rejected the filter or returned nothing for one of the
+		// requested stations (e.g. because it spells the name differently), fall
+		// back on fetching everything for a while. Other failures (e.g. 503) are
+		// retried at the next poll as usual.
+		bool all_seen = true;
+		for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+			all_seen &= journeys[j].start_index < 0 || result->start_seen[j];
+		}
+		
+		if (departures_filter_rejected(status) || (status == 200 && !all_seen)) {
+			Serial.print("Filtered request unsuccessful (status ");
+			Serial.print(status);
+			Serial.println("), fetching all departures instead.");
+			api_filter_enabled = false;
+			api_filter_retry_polls = API_FILTER_RETRY_POLLS;
+			start_departures_fetch(false);
+			poll_state = POLL_UNFILTERED;
+			return;
+		}
+	}
+	
+	if (!api_filter_enabled && status == 200 && --api_filter_retry_polls == 0) {
+		Serial.println("Trying filtered requests again.");
+		api_filter_enabled = true;
+	}
+	
+	int waits[MAX_JOURNEYS];
+	for (size_t j = 0; j < MAX_JOURNEYS; j++) {
+		waits[j] = status == 200 ? result->waits[j] : -1;
+	}
+	print_departure_waits(waits);
+	update_wait_display(waits);
+	
+	poll_state = POLL_IDLE;
+	unsigned long duration = millis() - poll_start_time;
+	perf_histogram_add(&perf.poll, duration);
+	schedule_next_poll(status == 200, duration);
+}
+
+/**
+ * Write the metrics served over HTTP into buf. Returns the length written or
+ * -1 if they didn't fit.
+ */
+int render_metrics(char *buf, size_t size) {
+	metrics_writer_t writer;
+	metrics_writer_init(&writer, buf, size);
+	
+	// perf.poll is in milliseconds
+	metrics_write_histogram(&writer, "trambox_poll_duration_seconds",
+	                        "Time taken by each poll of the API.", &perf.poll, 3);
+	metrics_write_counter(&writer, "trambox_requests_total",
+	                      "Requests made to the API.", api_fetch.stats.requests);
+	metrics_write_counter(&writer, "trambox_request_failures_total",
+	                      "Requests to the API which failed or got an error status.",
+	                      perf.failed_requests);
+	metrics_write_gauge(&writer, "trambox_wait_minutes",
+	                    "Wait for the next tram on the displayed journey (-1 if unknown).",
+	                    last_metrolink_wait);
+	metrics_write_gauge(&writer, "trambox_free_heap_bytes",
+	                    "Free heap.", ESP.getFreeHeap());
+	metrics_write_gauge(&writer, "trambox_max_free_block_bytes",
+	                    "Largest free block of heap.", ESP.getMaxFreeBlockSize());
+	metrics_write_counter(&writer, "trambox_uptime_seconds",
+	                      "Time since boot.", (unsigned long)(micros64() / 1000000));
+	metrics_write_gauge(&writer, "trambox_wifi_rssi_dbm",
+	                    "WiFi signal strength.", WiFi.RSSI());
+	
+	return writer.overflow ? -1 : (int)writer.length;
+}
+
+/**
+ * Abandon any poll in progress and poll again as soon as possible.
+ */
+void restart_poll() {
+	http_fetch_cancel(&api_fetch);
+	poll_state = POLL_IDLE;
+	next_poll_time = millis();
+}
+
+void on_wifi_got_ip(const WiFiEventStationModeGotIP &) {
+	wifi_got_ip = true;
+}
+
+void on_wifi_disconnected(const WiFiEventStationModeDisconnected &) {
+	wifi_disconnected = true;
+}
+
+/**
+ * Handle WiFi events: report new connections and fall back on a full connect
+ * if a fast reconnect fails.
+ */
+void wifi_poll() {
+	unsigned long now = millis();
+	
+	if (wifi_disconnected) {
+		wifi_disconnected = false;
+		if (wifi_state == WIFI_CONNECTED) {
+			// The SDK reconnects automatically
+			Serial.println("WiFi disconnected");
+			wifi_state = WIFI_FULL_CONNECTING;
+			wifi_connect_start_time = now;
+		} else if (wifi_state == WIFI_FAST_CONNECTING && !wifi_got_ip) {
+			// The cached access point couldn't be reached: give up on it now
+			wifi_connect_start_time = now - WIFI_FAST_CONNECT_TIMEOUT;
+		}
+	}
+	
+	if (wifi_state == WIFI_FAST_CONNECTING && !wifi_got_ip &&
+	    now - wifi_connect_start_time >= WIFI_FAST_CONNECT_TIMEOUT) {
+		Serial.println("Fast WiFi reconnect failed, scanning for access point...");
+		forget_wifi_cache();
+		WiFi.disconnect(false);
+		wifi_full_connect();
+		wifi_connect_start_time = now;
+	}
+	
+	if (wifi_got_ip) {
+		wifi_got_ip = false;
+		if (wifi_state == WIFI_CONNECTED || wifi_state == WIFI_IDLE) {
+			return;
+		}
+		
+		Serial.print("WiFi connected (");
+		Serial.print(wifi_state == WIFI_FAST_CONNECTING ? "fast reconnect" : "full connect");
+		Serial.print(wifi_using_cached_ip ? ", cached IP" : ", DHCP");
+		Serial.print(") in ");
+		Serial.print(now - wifi_connect_start_time);
+		Serial.print(" ms, IP address: ");
+		Serial.println(WiFi.localIP());
+		if (!boot_wifi_connected_time) {
+			boot_wifi_connected_time = now;
+			Serial.print("Time to WiFi connected: ");
+			Serial.print(now);
+			Serial.println(" ms after boot");
+		}
+		
+		wifi_state = WIFI_CONNECTED;
+		update_wifi_cache();
+		
+		// Fetch the times straight away rather than waiting out any backoff
+		// from polls made while disconnected
+		if (poll_state == POLL_IDLE) {
+			next_poll_time = now;
+		}
+	}
+}
+
+/**
+ * In low power mode, switch the radio off if the next poll is far enough away.
+ */
+void radio_sleep_until_next_poll() {
+	unsigned long now = millis();
+	if (!config.low_power_mode || radio_asleep || poll_state != POLL_IDLE ||
+	    metrics_server_busy(&metrics_server) || dns_resolver_busy(&api_resolver) ||
+	    (long)(next_poll_time - now) < (long)RADIO_SLEEP_MIN_INTERVAL) {
+		return;
+	}
+	
+	// The connection won't survive
+	api_fetch.client->stop();
+	
+	wifi_state = WIFI_IDLE;
+	WiFi.disconnect(false);
+	WiFi.forceSleepBegin();
+	radio_asleep = true;
+	power_budget_set_radio(&power_budget, now, false);
+}
+
+/**
+ * Switch the radio back on (and reconnect) shortly before the next poll.
+ */
+void radio_wake_if_due() {
+	if (radio_asleep && (long)(next_poll_time - millis()) <= (long)RADIO_WAKE_LEAD_TIME) {
+		wifi_connect();
 	}
 }
 
@@ -447,6 +1643,7 @@ void wifi_menu() {
 	
 	Serial.println("WiFi credentials changed.");
 	
+	clear_wifi_cache();
 	eeprom_store();
 	
 	wifi_connect();
@@ -468,35 +1665,173 @@ void tfgm_api_key_menu() {
 }
 
 /**
- * Allow the user to enter a new start/end station
+ * Pin HTTPS connections to the API server to the configured public key.
+ */
+void set_tfgm_public_key() {
+	if (!TFGM_API_TLS) {
+		return;
+	}
+	
+	config.tfgm_public_key[sizeof(config.tfgm_public_key) - 1] = '\0';
+	if (!http_fetch_set_public_key(&api_fetch, config.tfgm_public_key)) {
+		Serial.println("ERROR: No valid API server public key set, so tram times can't be fetched.");
+		Serial.println("Press 'h' to set one. Until then the needle is held at its maximum.");
+		show_error_display();
+	}
+}
+
+/**
+ * Allow the user to enter the (PEM encoded) public key of the API server, e.g.
+ * the output of:
+ *
+ *     openssl s_client -connect api.tfgm.com:443 -servername api.tfgm.com \
+ *         | openssl x509 -pubkey -noout
+ */
+void tfgm_public_key_menu() {
+	Serial.println("Paste the API server's public key (PEM) and press return:");
+	String pem;
+	while (true) {
+		String line = Serial.readStringUntil('\n');
+		line.trim();
+		if (!line.length() && !pem.length()) {
+			// Timed out before anything was entered
+			break;
+		}
+		pem += line;
+		pem += '\n';
+		if (!line.length() || line.startsWith("-----END")) {
+			break;
+		}
+	}
+	
+	if (pem.length() >= sizeof(config.tfgm_public_key)) {
+		Serial.println("Public key too long.");
+		return;
+	}
+	if (!http_fetch_set_public_key(&api_fetch, pem.c_str())) {
+		Serial.println("Invalid public key.");
+		set_tfgm_public_key();
+		return;
+	}
+	strcpy(config.tfgm_public_key, pem.c_str());
+	
+	Serial.println("API server public key changed.");
+	
+	eeprom_store();
+	show_wait_display();
+}
+
+/**
+ * Allow the user to enter a new start/end station for one of the journeys
  */
 void route_menu() {
-	Serial.println("Enter starting station name:");
+	Serial.print("Enter journey number (1-");
+	Serial.print(MAX_JOURNEYS);
+	Serial.print(", journey ");
+	Serial.print(DISPLAY_JOURNEY + 1);
+	Serial.println(" is displayed):");
+	String number = Serial.readStringUntil('\n');
+	number.trim();
+	int j = number.toInt() - 1;
+	if (j < 0 || j >= (int)MAX_JOURNEYS) {
+		Serial.println("Invalid journey number.");
+		return;
+	}
+	
+	Serial.println("Enter starting station name (leave blank to remove journey):");
 	String start = Serial.readStringUntil('\n');
 	start.trim();
-	strncpy(config.station_start, start.c_str(), sizeof(config.station_start) - 1);
-	config.station_start[sizeof(config.station_start) - 1] = '\0';
+	strncpy(config.journeys[j].station_start, start.c_str(), sizeof(config.journeys[j].station_start) - 1);
+	config.journeys[j].station_start[sizeof(config.journeys[j].station_start) - 1] = '\0';
 	
-	Serial.println("Enter destination station name:");
-	String end = Serial.readStringUntil('\n');
-	end.trim();
-	strncpy(config.station_end, end.c_str(), sizeof(config.station_end) - 1);
-	config.station_end[sizeof(config.station_end) - 1] = '\0';
+	String end;
+	if (start.length()) {
+		Serial.println("Enter destination station name:");
+		end = Serial.readStringUntil('\n');
+		end.trim();
+	}
+	strncpy(config.journeys[j].station_end, end.c_str(), sizeof(config.journeys[j].station_end) - 1);
+	config.journeys[j].station_end[sizeof(config.journeys[j].station_end) - 1] = '\0';
 	
 	Serial.println("Metrolink route updated");
 	
 	eeprom_store();
 	
-	metrolink_set_journey(config.station_start, config.station_end);
+	set_journeys();
+}
+
+/**
+ * Switch low power mode on or off.
+ */
+void low_power_menu() {
+	config.low_power_mode = !config.low_power_mode;
+	Serial.print("Low power mode ");
+	Serial.println(config.low_power_mode ? "enabled (radio off between polls)" : "disabled");
+	
+	eeprom_store();
+	
+	if (radio_asleep) {
+		wifi_connect();
+	}
+}
+
+/**
+ * Print the performance measurements.
+ */
+void perf_menu() {
+	Serial.println("Performance statistics:");
+	char summary[128];
+	for (size_t i = 0; i < sizeof(PERF_HISTOGRAMS) / sizeof(PERF_HISTOGRAMS[0]); i++) {
+		const perf_histogram_t *histogram = PERF_HISTOGRAMS[i].histogram;
+		perf_histogram_summary(histogram, summary, sizeof(summary));
+		Serial.print("  ");
+		Serial.print(PERF_HISTOGRAMS[i].name);
+		Serial.print(": ");
+		Serial.println(summary);
+		
+		// The non-empty buckets
+		for (size_t b = 0; b < PERF_HISTOGRAM_BUCKETS; b++) {
+			if (!histogram->buckets[b]) {
+				continue;
+			}
+			if (b < PERF_HISTOGRAM_BUCKETS - 1) {
+				Serial.print("    < ");
+				Serial.print(perf_histogram_bucket_limit(b));
+			} else {
+				Serial.print("    >= ");
+				Serial.print(perf_histogram_bucket_limit(b - 1));
+			}
+			Serial.print(": ");
+			Serial.println(histogram->buckets[b]);
+		}
+	}
+	Serial.print("  failed requests: ");
+	Serial.print(perf.failed_requests);
+	Serial.print("/");
+	Serial.println(api_fetch.stats.requests);
+	const dns_resolver_stats_t *dns_stats = &api_resolver.stats;
+	Serial.print("  DNS: ");
+	Serial.print(dns_stats->queries);
+	Serial.print(" queries (");
+	Serial.print(dns_stats->failures);
+	Serial.print(" failed), ");
+	Serial.print(dns_stats->cache_hits);
+	Serial.print(" cache hits, ");
+	Serial.print(dns_stats->stale_hits);
+	Serial.println(" fell back on last-known-good address");
+	if (api_fetch.tls && api_fetch.mfln_known) {
+		Serial.print("  TLS receive buffer: ");
+		Serial.println(api_fetch.mfln_supported
+		               ? "reduced (server supports max fragment length)"
+		               : "full size (server doesn't support max fragment length)");
+	}
 }
 
 /**
  * Allow the user to calibrate the display
  */
 void display_calibration_menu() {
-	display_value = 0;
-	display_wobble = false;
-	display_auto_decrement = false;
+	display_show_value(&display, 0);
 	
 	Serial.println("Adjust needle position using j and k. Confirm with 'enter'.");
 	
@@ -509,7 +1844,8 @@ void display_calibration_menu() {
 		} else {
 			config.display_pwm_values[i] = config.display_pwm_values[i - 1];
 		}
-		display_value = i;
+		display_set_calibration(&display, config.display_pwm_values);
+		display_show_value(&display, i);
 		
 		int c = 0;
 		while (c != '\n') {
@@ -520,6 +1856,7 @@ void display_calibration_menu() {
 					if (config.display_pwm_values[i] < 0) {
 						config.display_pwm_values[i] = 0;
 					}
+					display_set_calibration(&display, config.display_pwm_values);
 					break;
 				
 				case 'k':
@@ -527,6 +1864,7 @@ void display_calibration_menu() {
 					if (config.display_pwm_values[i] >= 1023) {
 						config.display_pwm_values[i] = 1023;
 					}
+					display_set_calibration(&display, config.display_pwm_values);
 					break;
 			}
 			
@@ -544,56 +1882,82 @@ void display_calibration_menu() {
 
 
 /**
- * Shows the main menu on the serial terminal, timing out after a few seconds
- * of inactivity.
+ * Shows the main menu on the serial terminal.
  */
-void main_menu() {
+void print_main_menu() {
 	Serial.println("Press one of the following keys to configure:");
 	Serial.println("  w: Set WiFi SSID and password");
 	Serial.println("  t: Set TFGM API key");
-	Serial.println("  r: Set metrolink route");
+	Serial.println("  h: Set API server public key (for HTTPS)");
+	Serial.println("  r: Set metrolink routes");
 	Serial.println("  d: Calibrate display");
+	Serial.println("  p: Toggle low power mode");
+	Serial.println("  s: Show performance statistics");
 	Serial.println("[press a key]");
-	
-	unsigned long stop = millis() + 2000;
-	while (millis() < stop) {
-		int c = Serial.read();
-		switch (c) {
-			case 'w':
-				wifi_menu();
-				return;
-			case 't':
-				tfgm_api_key_menu();
-				return;
-			case 'r':
-				route_menu();
-				return;
-			case 'd':
-				display_calibration_menu();
-				return;
-			
-			default:
-				// Do nothing, keep waiting
-				break;
-		}
+}
+
+/**
+ * Handle any key pressed on the serial terminal. The menus wait for the user's
+ * input so any poll in progress is abandoned (and restarted afterwards).
+ */
+void check_main_menu() {
+	int c = Serial.read();
+	switch (c) {
+		case -1:
+		case '\r':
+		case '\n':
+			// Nothing (new) pressed
+			return;
+		
+		case 'w':
+			restart_poll();
+			wifi_menu();
+			break;
+		case 't':
+			restart_poll();
+			tfgm_api_key_menu();
+			break;
+		case 'h':
+			restart_poll();
+			tfgm_public_key_menu();
+			break;
+		case 'r':
+			restart_poll();
+			route_menu();
+			break;
+		case 'd':
+			restart_poll();
+			display_calibration_menu();
+			break;
+		case 'p':
+			low_power_menu();
+			break;
+		case 's':
+			perf_menu();
+			break;
 		
-		// Keep watchdog fed...
-		delay(1);
+		default:
+			// Unknown key, show the options again
+			break;
 	}
 	
-	Serial.println("[no option selected, continuing]");
+	print_main_menu();
 }
 
 void setup() {
 	Serial.begin(9600);
 	Serial.setTimeout(60*1000);
-	EEPROM.begin(sizeof(eeprom_config_t));
 	
-	// Load the network graph
+	for (size_t i = 0; i < sizeof(PERF_HISTOGRAMS) / sizeof(PERF_HISTOGRAMS[0]); i++) {
+		perf_histogram_clear(PERF_HISTOGRAMS[i].histogram);
+	}
+	
+	// Prepare the station lookup
 	metrolink_init();
 	
 	// Load stored configuration
 	eeprom_load();
+	rtc_load();
 	
 	// Setup display pin.
 	// Hack: By setting this as an input we use the internal pull-up reisitor
@@ -604,14 +1968,44 @@ void setup() {
 	
 	// Initially show an 'error' status while we connect to wifi and get the
 	// initial time
-	show_error_display();
-	timer.attach(DISPLAY_UPDATE_INTERVAL, update_display);
+	display_init(&display, config.display_pwm_values);
+	restore_display_state();
+	timer.attach_ms(DISPLAY_UPDATE_INTERVAL_MS, update_display);
 	
-	metrolink_set_journey(config.station_start, config.station_end);
+	set_journeys();
+	dns_resolver_init(&api_resolver, TFGM_API_HOST);
+	http_fetch_init(&api_fetch, &api_resolver, TFGM_API_PORT, TFGM_API_TLS);
+	set_tfgm_public_key();
+	scheduler_init(&poll_scheduler, millis(), ESP.random());
+	power_budget_init(&power_budget, millis());
+	wifi_got_ip_handler = WiFi.onStationModeGotIP(on_wifi_got_ip);
+	wifi_disconnected_handler = WiFi.onStationModeDisconnected(on_wifi_disconnected);
 	wifi_connect();
+	metrics_server_init(&metrics_server, &metrics_listener, render_metrics);
+	
+	print_main_menu();
 }
 
 void loop() {
-	main_menu();
-	update_wait_display();
+	uint32_t start = micros();
+	uint32_t display_start = display_cpu_time;
+	
+	check_main_menu();
+	radio_wake_if_due();
+	wifi_poll();
+	dns_resolver_poll(&api_resolver);
+	poll_departures();
+	metrics_server_poll(&metrics_server);
+	radio_sleep_until_next_poll();
+	
+	// Excluding display updates run by the timer while loop() yielded. Time
+	// spent blocked in a connect (see HTTP_FETCH_TLS_CONNECT_TIMEOUT) is still
+	// counted, so this is an upper bound.
+	power_budget_add_cpu_time(&power_budget,
+	                          (micros() - start) - (display_cpu_time - display_start));
+	
+	// Between polls, let the CPU idle rather than spin
+	if (config.low_power_mode && poll_state == POLL_IDLE) {
+		delay(LOOP_IDLE_DELAY);
+	}
 }
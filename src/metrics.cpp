@@ -0,0 +1,94 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "metrics.h"
+
+void metrics_writer_init(metrics_writer_t *writer, char *buf, size_t size) {
+	writer->buf = buf;
+	writer->size = size;
+	writer->length = 0;
+	writer->overflow = false;
+	if (size) {
+		buf[0] = '\0';
+	}
+}
+
+/**
+ * Append formatted text, discarding the whole of it if it doesn't fit.
+ */
+static void append(metrics_writer_t *writer, const char *format, ...) {
+	if (writer->overflow) {
+		return;
+	}
+
+	size_t space = writer->size - writer->length;
+	va_list args;
+	va_start(args, format);
+	int length = vsnprintf(writer->buf + writer->length, space, format, args);
+	va_end(args);
+
+	if (length < 0 || (size_t)length >= space) {
+		writer->overflow = true;
+		if (writer->size) {
+			writer->buf[writer->length] = '\0';
+		}
+		return;
+	}
+	writer->length += length;
+}
+
+static void write_header(metrics_writer_t *writer, const char *name,
+                         const char *help, const char *type) {
+	append(writer, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void metrics_write_counter(metrics_writer_t *writer, const char *name,
+                           const char *help, unsigned long value) {
+	write_header(writer, name, help, "counter");
+	append(writer, "%s %lu\n", name, value);
+}
+
+void metrics_write_gauge(metrics_writer_t *writer, const char *name,
+                         const char *help, long value) {
+	write_header(writer, name, help, "gauge");
+	append(writer, "%s %ld\n", name, value);
+}
+
+/**
+ * Format value / 10^decimals exactly (without floating point) into buf.
+ */
+static const char *format_scaled(char *buf, size_t size, uint64_t value, unsigned int decimals) {
+	uint64_t divisor = 1;
+	for (unsigned int i = 0; i < decimals; i++) {
+		divisor *= 10;
+	}
+	if (decimals) {
+		snprintf(buf, size, "%lu.%0*lu", (unsigned long)(value / divisor), (int)decimals,
+		         (unsigned long)(value % divisor));
+	} else {
+		snprintf(buf, size, "%lu", (unsigned long)value);
+	}
+	return buf;
+}
+
+void metrics_write_histogram(metrics_writer_t *writer, const char *name,
+                             const char *help, const perf_histogram_t *histogram,
+                             unsigned int decimals) {
+	write_header(writer, name, help, "histogram");
+
+	// Values are integers, so the exclusive limit of each bucket becomes an
+	// inclusive one by subtracting 1
+	char value[24];
+	unsigned long cumulative = 0;
+	for (size_t i = 0; i < PERF_HISTOGRAM_BUCKETS - 1; i++) {
+		cumulative += histogram->buckets[i];
+		append(writer, "%s_bucket{le=\"%s\"} %lu\n", name,
+		       format_scaled(value, sizeof(value), perf_histogram_bucket_limit(i) - 1, decimals),
+		       cumulative);
+	}
+	append(writer, "%s_bucket{le=\"+Inf\"} %lu\n", name, (unsigned long)histogram->count);
+	append(writer, "%s_sum %s\n", name,
+	       format_scaled(value, sizeof(value), histogram->total, decimals));
+	append(writer, "%s_count %lu\n", name, (unsigned long)histogram->count);
+}
@@ -0,0 +1,51 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "perf.h"
+
+/**
+ * Writes metrics in the Prometheus text exposition format into a fixed-size
+ * buffer. Output which doesn't fit is dropped and overflow set; the buffer
+ * always holds a null-terminated string.
+ *
+ * Initialise with metrics_writer_init.
+ */
+typedef struct {
+	char *buf;
+	size_t size;
+
+	// Length of the text written so far
+	size_t length;
+
+	// Did any output not fit in the buffer?
+	bool overflow;
+} metrics_writer_t;
+
+void metrics_writer_init(metrics_writer_t *writer, char *buf, size_t size);
+
+/**
+ * Write a counter: a value which only ever increases (until a reboot).
+ */
+void metrics_write_counter(metrics_writer_t *writer, const char *name,
+                           const char *help, unsigned long value);
+
+/**
+ * Write a gauge: a value which may go up and down.
+ */
+void metrics_write_gauge(metrics_writer_t *writer, const char *name,
+                         const char *help, long value);
+
+/**
+ * Write a histogram with a cumulative bucket for each bucket of the
+ * perf_histogram_t. Values (bucket limits and the sum) are divided by
+ * 10^decimals, so that e.g. durations measured in milliseconds (decimals 3) or
+ * microseconds (decimals 6) are exported in seconds, as is conventional.
+ */
+void metrics_write_histogram(metrics_writer_t *writer, const char *name,
+                             const char *help, const perf_histogram_t *histogram,
+                             unsigned int decimals);
+
+#endif
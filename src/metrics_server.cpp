@@ -0,0 +1,201 @@
+#include <string.h>
+#include <stdio.h>
+
+#include "metrics_server.h"
+
+void metrics_server_init(metrics_server_t *server, WiFiServer *listener,
+                         metrics_server_render_t render) {
+	server->listener = listener;
+	server->render = render;
+	for (size_t i = 0; i < METRICS_SERVER_MAX_CONNECTIONS; i++) {
+		server->connections[i].state = METRICS_CONNECTION_FREE;
+	}
+	server->responding = NULL;
+	memset(&server->stats, 0, sizeof(server->stats));
+
+	listener->begin();
+	listener->setNoDelay(true);
+}
+
+static void close_connection(metrics_server_t *server, metrics_connection_t *connection) {
+	connection->client.stop();
+	connection->state = METRICS_CONNECTION_FREE;
+	if (server->responding == connection) {
+		server->responding = NULL;
+	}
+}
+
+/**
+ * Build the response to a connection's request in the response buffer. The
+ * body is written after the space reserved for the headers and the headers
+ * then written immediately before it.
+ */
+static void build_response(metrics_server_t *server, metrics_connection_t *connection) {
+	char *body = server->response + METRICS_SERVER_HEADER_SIZE;
+	size_t body_space = METRICS_SERVER_BUFFER_SIZE - METRICS_SERVER_HEADER_SIZE;
+
+	const char *status;
+	int body_length;
+	if (strncmp(connection->request_line, "GET /metrics ", 13) == 0) {
+		status = "200 OK";
+		body_length = server->render(body, body_space);
+		if (body_length < 0) {
+			status = "500 Internal Server Error";
+			body_length = snprintf(body, body_space, "Metrics too large\n");
+		}
+	} else {
+		status = "404 Not Found";
+		body_length = snprintf(body, body_space, "Not found: try /metrics\n");
+	}
+
+	char headers[METRICS_SERVER_HEADER_SIZE];
+	int headers_length = snprintf(headers, sizeof(headers),
+	                              "HTTP/1.1 %s\r\n"
+	                              "Content-Type: text/plain; version=0.0.4\r\n"
+	                              "Content-Length: %d\r\n"
+	                              "Connection: close\r\n"
+	                              "\r\n",
+	                              status, body_length);
+
+	server->response_start = METRICS_SERVER_HEADER_SIZE - headers_length;
+	server->response_end = METRICS_SERVER_HEADER_SIZE + body_length;
+	memcpy(server->response + server->response_start, headers, headers_length);
+	server->responding = connection;
+	connection->state = METRICS_CONNECTION_WRITING;
+	server->stats.requests++;
+}
+
+/**
+ * Read whatever part of the request has arrived, keeping the request line.
+ */
+static void read_request(metrics_connection_t *connection) {
+	static const char END[] = "\r\n\r\n";
+	char buf[64];
+	size_t available = connection->client.available();
+	while (available > 0) {
+		int length = connection->client.read((uint8_t *)buf, min(available, sizeof(buf)));
+		if (length <= 0) {
+			return;
+		}
+		available -= length;
+
+		for (int i = 0; i < length; i++) {
+			char c = buf[i];
+			if (c == '\n') {
+				connection->request_line_complete = true;
+			} else if (!connection->request_line_complete && c != '\r' &&
+			           connection->request_line_length < METRICS_SERVER_MAX_REQUEST_LINE) {
+				connection->request_line[connection->request_line_length++] = c;
+				connection->request_line[connection->request_line_length] = '\0';
+			}
+
+			if (c == END[connection->end_matched]) {
+				connection->end_matched++;
+			} else {
+				connection->end_matched = c == '\r';
+			}
+			if (connection->end_matched == 4) {
+				// Anything after the headers (e.g. a body) is ignored
+				connection->state = METRICS_CONNECTION_WAITING;
+				return;
+			}
+		}
+	}
+}
+
+/**
+ * Send as much of the response as the connection will take without blocking.
+ */
+static void write_response(metrics_server_t *server, metrics_connection_t *connection) {
+	size_t remaining = server->response_end - server->response_start;
+	size_t space = connection->client.availableForWrite();
+	if (space == 0) {
+		return;
+	}
+	size_t length = connection->client.write(
+		(const uint8_t *)server->response + server->response_start,
+		min(remaining, space));
+	server->response_start += length;
+	if (server->response_start == server->response_end) {
+		close_connection(server, connection);
+	}
+}
+
+/**
+ * Give a new connection a free slot, or close it if there is none.
+ */
+static void accept_connection(metrics_server_t *server) {
+	WiFiClient client = server->listener->accept();
+	for (size_t i = 0; i < METRICS_SERVER_MAX_CONNECTIONS; i++) {
+		metrics_connection_t *connection = &server->connections[i];
+		if (connection->state == METRICS_CONNECTION_FREE) {
+			connection->client = client;
+			connection->client.setNoDelay(true);
+			connection->state = METRICS_CONNECTION_READING;
+			connection->start_time = millis();
+			connection->request_line[0] = '\0';
+			connection->request_line_length = 0;
+			connection->request_line_complete = false;
+			connection->end_matched = 0;
+			return;
+		}
+	}
+	client.stop();
+	server->stats.rejected++;
+}
+
+bool metrics_server_busy(const metrics_server_t *server) {
+	for (size_t i = 0; i < METRICS_SERVER_MAX_CONNECTIONS; i++) {
+		if (server->connections[i].state != METRICS_CONNECTION_FREE) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void metrics_server_poll(metrics_server_t *server) {
+	if (server->listener->hasClient()) {
+		accept_connection(server);
+	}
+
+	unsigned long now = millis();
+	for (size_t i = 0; i < METRICS_SERVER_MAX_CONNECTIONS; i++) {
+		metrics_connection_t *connection = &server->connections[i];
+		if (connection->state == METRICS_CONNECTION_FREE) {
+			continue;
+		}
+
+		if (now - connection->start_time > METRICS_SERVER_TIMEOUT) {
+			server->stats.timeouts++;
+			close_connection(server, connection);
+			continue;
+		}
+
+		switch (connection->state) {
+			case METRICS_CONNECTION_READING:
+				if (!connection->client.connected() && !connection->client.available()) {
+					close_connection(server, connection);
+				} else {
+					read_request(connection);
+				}
+				break;
+
+			case METRICS_CONNECTION_WAITING:
+				if (!server->responding) {
+					build_response(server, connection);
+				}
+				break;
+
+			case METRICS_CONNECTION_WRITING:
+				if (!connection->client.connected()) {
+					close_connection(server, connection);
+				} else {
+					write_response(server, connection);
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+}
@@ -0,0 +1,129 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiServer.h>
+
+/**
+ * Maximum number of connections served at once. Further connections are
+ * closed as soon as they are accepted.
+ */
+#define METRICS_SERVER_MAX_CONNECTIONS 4
+
+/**
+ * Size of the response buffer (headers and body). Responses are sent one at a
+ * time, so a single buffer is shared by every connection.
+ */
+#define METRICS_SERVER_BUFFER_SIZE 3072
+
+/**
+ * Space reserved at the start of the response buffer for the headers.
+ */
+#define METRICS_SERVER_HEADER_SIZE 128
+
+/**
+ * Maximum length of the request line kept (longer ones are truncated).
+ */
+#define METRICS_SERVER_MAX_REQUEST_LINE 48
+
+/**
+ * Number of milliseconds a connection may take to send its request and to
+ * receive the response before it is closed.
+ */
+#define METRICS_SERVER_TIMEOUT 5000
+
+/**
+ * Writes the metrics (in the Prometheus text format) into buf, returning the
+ * length written or -1 if they didn't fit.
+ */
+typedef int (*metrics_server_render_t)(char *buf, size_t size);
+
+/**
+ * The phases of a connection.
+ */
+typedef enum {
+	// Slot unused
+	METRICS_CONNECTION_FREE,
+	// Reading the request line and headers
+	METRICS_CONNECTION_READING,
+	// Request received, waiting for the response buffer to be free
+	METRICS_CONNECTION_WAITING,
+	// Writing the response
+	METRICS_CONNECTION_WRITING,
+} metrics_connection_state_t;
+
+typedef struct {
+	metrics_connection_state_t state;
+	WiFiClient client;
+
+	// Time (millis()) at which the connection was accepted
+	unsigned long start_time;
+
+	// The start of the request line
+	char request_line[METRICS_SERVER_MAX_REQUEST_LINE + 1];
+	size_t request_line_length;
+	bool request_line_complete;
+
+	// Number of consecutive bytes of the "\r\n\r\n" ending the headers seen
+	uint8_t end_matched;
+} metrics_connection_t;
+
+/**
+ * Statistics on the requests served.
+ */
+typedef struct {
+	unsigned long requests;
+
+	// Connections closed at once because every slot was busy
+	unsigned long rejected;
+
+	// Connections closed for taking too long
+	unsigned long timeouts;
+} metrics_server_stats_t;
+
+/**
+ * A minimal HTTP server answering GET /metrics. Connections occupy a fixed
+ * number of slots and responses are built in a pre-sized buffer, so no memory
+ * is allocated while serving.
+ *
+ * Call metrics_server_poll repeatedly (e.g. from loop()). Each call does a
+ * bounded amount of work, never waiting for the network.
+ *
+ * Initialise with metrics_server_init.
+ */
+typedef struct {
+	WiFiServer *listener;
+
+	metrics_server_render_t render;
+
+	metrics_connection_t connections[METRICS_SERVER_MAX_CONNECTIONS];
+
+	// The response being sent, the part of it still to be sent and the
+	// connection it is being sent on (NULL if the buffer is free)
+	char response[METRICS_SERVER_BUFFER_SIZE];
+	size_t response_start;
+	size_t response_end;
+	metrics_connection_t *responding;
+
+	metrics_server_stats_t stats;
+} metrics_server_t;
+
+/**
+ * Start listening for connections with listener. Metrics are produced by
+ * calling render(buf, size) for each request.
+ */
+void metrics_server_init(metrics_server_t *server, WiFiServer *listener,
+                         metrics_server_render_t render);
+
+/**
+ * Accept a pending connection and advance each connection in progress.
+ */
+void metrics_server_poll(metrics_server_t *server);
+
+/**
+ * Is any connection open?
+ */
+bool metrics_server_busy(const metrics_server_t *server);
+
+#endif
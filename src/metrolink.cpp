@@ -1,176 +1,251 @@
 #include <string.h>
-#include <ctype.h>
-#include <stdlib.h>
+#include <stdint.h>
 
 #include "metrolink.h"
 #include "metrolink_map.h"
+#include "metrolink_tables.h"
 
 /**
- * A node of a linked-list of station indices.
+ * Number of entries in the destination name cache (a power of two).
  */
-typedef struct link {
-	size_t station_index;
-	struct link *next;
-} link_t;
+static const size_t NAME_CACHE_SIZE = 32;
 
 /**
- * An adjacency-list style graph consisting of a linked-list of (undirected)
- * neighbour edges, one per station. Initialise this structure with
- * metrolink_init.
+ * Maximum number of slots probed when looking up a name in the cache.
  */
-static link_t **network;
+static const size_t NAME_CACHE_PROBES = 4;
 
 /**
- * True if a given metrolink station is a valid destination.
+ * A small open-addressed cache of the station indices of destination names
+ * passed to metrolink_is_destination_valid(), keyed by a hash of the raw name.
+ * Entries with a length of zero are empty. Since station indices don't depend
+ * on the journey, one cache serves every journey.
+ *
+ * When all probed slots are full, the first entry not hit since it was last
+ * considered for eviction is replaced (a 'second chance' policy, with new
+ * entries starting with their chance intact).
+ *
+ * Since the names themselves aren't stored, two names with the same length
+ * and 32-bit hash would share an index; with the few dozen distinct names
+ * seen in the feed this is vanishingly unlikely.
  */
-static bool *valid_destinations;
+static struct {
+	uint32_t hash;
+	uint16_t length;
+	int16_t index;
+	bool referenced;
+} name_cache[NAME_CACHE_SIZE];
+
+static metrolink_cache_stats_t name_cache_stats;
+
+// Parameters of the hashes used by the station index. These must match
+// tools/generate_metrolink_tables.py.
+static const uint32_t FNV_OFFSET_BASIS = 0x811C9DC5u;
+static const uint32_t FNV_PRIME = 0x01000193u;
+static const uint32_t SLOT_MULTIPLIER = 0x9E3779B1u;
+
+static bool is_ascii_alnum(unsigned char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static unsigned char ascii_to_lower(unsigned char c) {
+	return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
 
 /**
- * True if a given metrolink station has been visted by the graph traversal
- * logic.
+ * Does the string start with "via " (in any case)?
  */
-static bool *visited;
+static bool starts_with_via(const unsigned char *s) {
+	return ascii_to_lower(s[0]) == 'v' &&
+	       ascii_to_lower(s[1]) == 'i' &&
+	       ascii_to_lower(s[2]) == 'a' &&
+	       s[3] == ' ';
+}
 
 /**
- * Get the index of the station with the given name (must match exactly).
+ * Return the next character of the canonical key of a station name, advancing
+ * *name past it, or '\0' at the end of the key.
+ *
+ * The canonical key consists of only the ASCII letters and digits of the name,
+ * lower-cased. Any other byte (whitespace, punctuation and every byte of a
+ * UTF-8 multi-byte sequence such as the ’ in "Besses O’ Th’ Barn") is skipped,
+ * and the key ends at a 'via' clause.
  */
-static int get_exact_station_index(const char *needle) {
-	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
-		if (strcmp(METROLINK_STATIONS[i], needle) == 0) {
-			return i;
+static char next_key_char(const char **name) {
+	const unsigned char *s = (const unsigned char *)*name;
+	while (*s) {
+		unsigned char c = *s++;
+		if (is_ascii_alnum(c)) {
+			*name = (const char *)s;
+			return ascii_to_lower(c);
+		} else if (starts_with_via(s)) {
+			break;
 		}
 	}
-	return -1;
+	*name = (const char *)s;
+	return '\0';
 }
 
 bool metrolink_station_names_equal(const char *a, const char *b) {
-	bool match = true;
-	while (*a && *b) {
-		// Skip whitespace and punctuation
-		while (!(isalnum(*a) || *a == ' ') && *a) {
-			a++;
-		}
-		while (!(isalnum(*b) || *b == ' ') && *b) {
-			b++;
+	char c;
+	do {
+		c = next_key_char(&a);
+		if (c != next_key_char(&b)) {
+			return false;
 		}
-		
-		// Skip 'via'
-		if (strncmp(a, "via ", 4) == 0) {
-			a += strlen(a);
-		}
-		if (strncmp(b, "via ", 4) == 0) {
-			b += strlen(b);
-		}
-		
-		// Case-insensitive search
-		if (tolower(*a) != tolower(*b)) {
-			match = false;
-			break;
+	} while (c);
+	return true;
+}
+
+/**
+ * Compare a null padded key with a station's key in flash, a word at a time.
+ */
+static bool station_key_equals(const uint32_t *key, int index) {
+	const uint32_t *station_key = (const uint32_t *)METROLINK_STATION_KEYS[index];
+	for (size_t i = 0; i < METROLINK_KEY_STRIDE / 4; i++) {
+		if (pgm_read_dword(&station_key[i]) != key[i]) {
+			return false;
 		}
-		a++;
-		b++;
 	}
-	return match && *a == *b;
+	return true;
 }
 
 /**
  * Get the index of the station with the given name (ignoring punctuation and
- * case and 'via' clauses).
+ * case and 'via' clauses). Normalises and hashes the name in a single pass
+ * and then looks it up in the (generated) station index hash table.
  */
-static int get_station_index(const char *needle) {
-	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
-		const char *a = METROLINK_STATIONS[i];
-		const char *b = needle;
-		
-		if (metrolink_station_names_equal(a, b)) {
-			return i;
+int metrolink_get_station_index(const char *name) {
+	// Padded with nulls like METROLINK_STATION_KEYS
+	uint32_t key[METROLINK_KEY_STRIDE / 4] = {0};
+	size_t length = 0;
+	uint32_t hash = FNV_OFFSET_BASIS;
+	char c;
+	while ((c = next_key_char(&name))) {
+		if (length == METROLINK_MAX_KEY_LENGTH) {
+			// Longer than any station's key
+			return -1;
+		}
+		((char *)key)[length++] = c;
+		hash = (hash ^ (unsigned char)c) * FNV_PRIME;
+	}
+	
+	const uint32_t mask = (1u << METROLINK_STATION_INDEX_BITS) - 1;
+	uint32_t slot = ((hash ^ METROLINK_STATION_INDEX_SEED) * SLOT_MULTIPLIER) >>
+	                (32 - METROLINK_STATION_INDEX_BITS);
+	for (;;) {
+		uint8_t index = pgm_read_byte(&METROLINK_STATION_INDEX[slot]);
+		if (index == METROLINK_STATION_INDEX_EMPTY) {
+			return -1;
+		}
+		if (pgm_read_dword(&METROLINK_STATION_HASHES[index]) == hash &&
+		    station_key_equals(key, index)) {
+			return index;
 		}
+		slot = (slot + 1) & mask;
 	}
-	return -1;
 }
 
-/**
- * Initialise the 'network' graph. Call exactly once on startup.
- */
 void metrolink_init(void) {
-	network = new link_t*[NUM_METROLINK_STATIONS];
-	visited = new bool[NUM_METROLINK_STATIONS];
-	valid_destinations = new bool[NUM_METROLINK_STATIONS];
-	
-	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
-		network[i] = NULL;
+	memset(name_cache, 0, sizeof(name_cache));
+	memset(&name_cache_stats, 0, sizeof(name_cache_stats));
+}
+
+size_t metrolink_get_neighbours(int index, const uint8_t **neighbours) {
+	if (index < 0 || index >= METROLINK_TABLES_NUM_STATIONS) {
+		*neighbours = NULL;
+		return 0;
 	}
 	
-	for (size_t i = 0; i < NUM_METROLINK_LINKS; i++) {
-		link_t *link_a = new link_t;
-		link_t *link_b = new link_t;
-		
-		link_a->station_index = get_exact_station_index(METROLINK_LINKS[i].b);
-		link_b->station_index = get_exact_station_index(METROLINK_LINKS[i].a);
-		
-		link_a->next = network[link_b->station_index];
-		network[link_b->station_index] = link_a;
-		
-		link_b->next = network[link_a->station_index];
-		network[link_a->station_index] = link_b;
-	}
+	size_t begin = METROLINK_READ_NEIGHBOUR_OFFSET(&METROLINK_NEIGHBOUR_OFFSETS[index]);
+	size_t end = METROLINK_READ_NEIGHBOUR_OFFSET(&METROLINK_NEIGHBOUR_OFFSETS[index + 1]);
+	*neighbours = &METROLINK_NEIGHBOURS[begin];
+	return end - begin;
 }
 
 /**
- * Visit a station and all unvisited stations reachable from it. If the target
- * station is reached, mark that station and all reached beyond it as 'valid'.
- *
- * @param index The index of the station to visit
- * @param target The index of the target station
- * @param already_reached Has an earlier traversal step already reached the
- *        target station?
+ * Get a station index (as metrolink_get_station_index) via name_cache.
  */
-static void visit(size_t index, size_t target, bool already_reached) {
-	bool valid = already_reached || (index == target);
-	
-	visited[index] = true;
-	valid_destinations[index] |= valid;
+static int get_cached_station_index(const char *name) {
+	// Hash the raw name
+	uint32_t hash = FNV_OFFSET_BASIS;
+	size_t length = 0;
+	for (const char *c = name; *c; c++) {
+		hash = (hash ^ (unsigned char)*c) * FNV_PRIME;
+		length++;
+	}
+	if (length == 0 || length > UINT16_MAX) {
+		return metrolink_get_station_index(name);
+	}
 	
-	link_t *neighbours_list = network[index];
-	while (neighbours_list) {
-		size_t neighbour_index = neighbours_list->station_index;
-		neighbours_list = neighbours_list->next;
-		
-		if (!visited[neighbour_index]) {
-			visit(neighbour_index, target, valid);
+	// Linear probing over a bounded number of slots
+	size_t home = (hash ^ (hash >> 16)) & (NAME_CACHE_SIZE - 1);
+	size_t empty = NAME_CACHE_SIZE;
+	for (size_t i = 0; i < NAME_CACHE_PROBES; i++) {
+		size_t slot = (home + i) & (NAME_CACHE_SIZE - 1);
+		if (name_cache[slot].length == length && name_cache[slot].hash == hash) {
+			name_cache_stats.hits++;
+			name_cache[slot].referenced = true;
+			return name_cache[slot].index;
+		} else if (name_cache[slot].length == 0 && empty == NAME_CACHE_SIZE) {
+			empty = slot;
 		}
 	}
+	name_cache_stats.misses++;
+	int index = metrolink_get_station_index(name);
 	
-	visited[index] = false;
+	// Insert into the first empty slot or otherwise evict an entry
+	size_t slot = empty;
+	for (size_t i = 0; slot == NAME_CACHE_SIZE && i < NAME_CACHE_PROBES; i++) {
+		size_t candidate = (home + i) & (NAME_CACHE_SIZE - 1);
+		if (name_cache[candidate].referenced) {
+			name_cache[candidate].referenced = false;
+		} else {
+			slot = candidate;
+		}
+	}
+	if (slot == NAME_CACHE_SIZE) {
+		slot = home;
+	}
+	name_cache[slot].hash = hash;
+	name_cache[slot].length = length;
+	name_cache[slot].index = index;
+	name_cache[slot].referenced = true;
+	return index;
 }
 
-
-void metrolink_set_journey(const char *start, const char *target) {
-	for (size_t i = 0; i < NUM_METROLINK_STATIONS; i++) {
-		visited[i] = false;
-		valid_destinations[i] = false;
-	}
+void metrolink_set_journey(metrolink_journey_t *journey,
+                           const char *start, const char *target) {
+	journey->start_index = -1;
+	journey->valid_destinations = NULL;
 	
-	int start_index = get_station_index(start);
-	int target_index = get_station_index(target);
-	
-	// Special case: endpoint 
+	int start_index = metrolink_get_station_index(start);
+	int target_index = metrolink_get_station_index(target);
 	if (start_index < 0 || target_index < 0) {
 		return;
 	}
 	
-	if (start_index == target_index) {
-		return;
-	}
-	
-	visit(start_index, target_index, false);
+	metrolink_destination_set_id_t set = METROLINK_READ_DESTINATION_SET_ID(
+		&METROLINK_JOURNEY_DESTINATION_SETS[start_index][target_index]);
+	journey->start_index = start_index;
+	journey->valid_destinations = METROLINK_DESTINATION_SETS[set];
 }
 
-bool metrolink_is_destination_valid(const char *target) {
-	int index = get_station_index(target);
-	if (index < 0) {
+bool metrolink_is_destination_index_valid(const metrolink_journey_t *journey,
+                                          int index) {
+	if (index < 0 || !journey->valid_destinations) {
 		return false;
 	}
+	
+	return (pgm_read_byte(&journey->valid_destinations[index / 8]) >> (index % 8)) & 1;
+}
+
+bool metrolink_is_destination_valid(const metrolink_journey_t *journey,
+                                    const char *target) {
+	return metrolink_is_destination_index_valid(
+		journey, get_cached_station_index(target));
+}
 
-	return valid_destinations[index];
+void metrolink_get_cache_stats(metrolink_cache_stats_t *stats) {
+	*stats = name_cache_stats;
 }
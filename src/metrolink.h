@@ -3,6 +3,20 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A journey between two stations. Initialise with metrolink_set_journey.
+ */
+typedef struct {
+	// Index of the start station (see metrolink_map.h) or -1 if the journey is
+	// not valid.
+	int start_index;
+
+	// Bitset (in flash) of valid destinations or NULL if the journey is not
+	// valid.
+	const uint8_t *valid_destinations;
+} metrolink_journey_t;
 
 /**
  * Call exactly once on startup before using any other functions.
@@ -10,19 +24,57 @@
 void metrolink_init(void);
 
 /**
- * Specify the journey desired by the user.
+ * Get the stations adjacent to the station with the given index in the
+ * network. Sets *neighbours to their indices (an array in flash: read with
+ * pgm_read_byte) and returns how many there are.
  */
-void metrolink_set_journey(const char *start, const char *target);
+size_t metrolink_get_neighbours(int index, const uint8_t **neighbours);
+
+/**
+ * Get the index (see metrolink_map.h) of the station with the given name
+ * (compared as metrolink_station_names_equal does) or -1 if the name is not a
+ * known station.
+ */
+int metrolink_get_station_index(const char *name);
+
+/**
+ * Specify a journey desired by the user. If either name is not a known
+ * station, the journey will have no valid destinations.
+ */
+void metrolink_set_journey(metrolink_journey_t *journey,
+                           const char *start, const char *target);
+
+/**
+ * If a tram with the destination station index supplied shows up at the
+ * journey's start station, will it stop at the journey's target?
+ */
+bool metrolink_is_destination_index_valid(const metrolink_journey_t *journey,
+                                          int index);
+
+/**
+ * If a tram with the destination name supplied shows up at the journey's start
+ * station, will it stop at the journey's target?
+ *
+ * The station index of each name is cached so repeated calls with the same
+ * name are cheap.
+ */
+bool metrolink_is_destination_valid(const metrolink_journey_t *journey,
+                                    const char *target);
+
+typedef struct {
+	unsigned long hits;
+	unsigned long misses;
+} metrolink_cache_stats_t;
 
 /**
- * If a tram with the destination name supplied shows up at the 'start' station
- * given to metrolink_set_journey, will it stop at the 'target' given?
+ * Get the hit and miss counts of the cache used by
+ * metrolink_is_destination_valid() since metrolink_init.
  */
-bool metrolink_is_destination_valid(const char *target);
+void metrolink_get_cache_stats(metrolink_cache_stats_t *stats);
 
 /**
- * Compare two metrolink station names, ignoring case, punctuation and 'via'
- * clauses. Returns true on equal.
+ * Compare two metrolink station names, ignoring case, whitespace, punctuation,
+ * non-ASCII characters and 'via' clauses. Returns true on equal.
  */
 bool metrolink_station_names_equal(const char *a, const char *b);
 
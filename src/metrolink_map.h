@@ -1,31 +1,42 @@
 #ifndef METROLINK_MAP_H
 #define METROLINK_MAP_H
 
+#include <stdbool.h>
 #include <stddef.h>
 
+#include "metrolink_tables.h"
+
 /**
- * The complete list of Metrolink station names.
+ * The Metrolink network, described in metrolink_map.txt. The station names and
+ * links are held in flash (see metrolink_tables.h) rather than DRAM and are
+ * read with the functions below.
  */
-extern const char *METROLINK_STATIONS[];
 
 /**
  * The number of Metrolink stations.
  */
-extern size_t NUM_METROLINK_STATIONS;
+#define NUM_METROLINK_STATIONS METROLINK_TABLES_NUM_STATIONS
+
+/**
+ * The number of (one directional) connections between stations.
+ */
+#define NUM_METROLINK_LINKS METROLINK_NUM_LINKS
 
-typedef struct {
-	const char *a;
-	const char *b;
-} metrolink_name_pair_t;
+/**
+ * Size of a buffer (including the null terminator) which fits any station name.
+ */
+#define METROLINK_NAME_BUFFER_SIZE (METROLINK_MAX_NAME_LENGTH + 1)
 
 /**
- * Lists (for one direction only) connections between stations.
+ * Copy the name of the station with the given index into buf (of size bytes),
+ * truncating it if necessary. Returns false (leaving buf empty) if there is no
+ * such station.
  */
-extern metrolink_name_pair_t METROLINK_LINKS[];
+bool metrolink_get_station_name(int index, char *buf, size_t size);
 
 /**
- * Number of entries in METROLINK_LINKS.
+ * Get the indices of the stations at either end of a link.
  */
-extern size_t NUM_METROLINK_LINKS;
+void metrolink_get_link(size_t link, int *a, int *b);
 
 #endif
@@ -0,0 +1,1579 @@
+// Generated by tools/generate_metrolink_tables.py from
+// src/metrolink_map.txt. Do not edit.
+
+#include "metrolink_tables.h"
+
+alignas(4) const char METROLINK_STATION_NAMES[] PROGMEM =
+	"Abraham Moss" "\0\0\0\0"
+	"Altrincham" "\0\0"
+	"Anchorage" "\0\0\0"
+	"Ashton Moss" "\0"
+	"Ashton-Under-Lyne" "\0\0\0"
+	"Ashton West" "\0"
+	"Audenshaw" "\0\0\0"
+	"Baguley" "\0"
+	"Barlow Moor Road" "\0\0\0\0"
+	"Benchill" "\0\0\0\0"
+	"Besses O\342\200\231 Th\342\200\231 Barn" "\0\0"
+	"Bowker Vale" "\0"
+	"Broadway" "\0\0\0\0"
+	"Brooklands" "\0\0"
+	"Burton Road" "\0"
+	"Bury" "\0\0\0\0"
+	"Cemetery Road" "\0\0\0"
+	"Central Park" "\0\0\0\0"
+	"Chorlton" "\0\0\0\0"
+	"Clayton Hall" "\0\0\0\0"
+	"Cornbrook" "\0\0\0"
+	"Crossacres" "\0\0"
+	"Crumpsall" "\0\0\0"
+	"Dane Road" "\0\0\0"
+	"Deansgate - Castlefield" "\0"
+	"Derker" "\0\0"
+	"Didsbury Village" "\0\0\0\0"
+	"Droylsden" "\0\0\0"
+	"East Didsbury" "\0\0\0"
+	"Eccles" "\0\0"
+	"Edge Lane" "\0\0\0"
+	"Etihad Campus" "\0\0\0"
+	"Exchange Quay" "\0\0\0"
+	"Exchange Square" "\0"
+	"Failsworth" "\0\0"
+	"Firswood" "\0\0\0\0"
+	"Freehold" "\0\0\0\0"
+	"Harbour City" "\0\0\0\0"
+	"Heaton Park" "\0"
+	"Hollinwood" "\0\0"
+	"Holt Town" "\0\0\0"
+	"Kingsway Business Park" "\0\0"
+	"Ladywell" "\0\0\0\0"
+	"Langworthy" "\0\0"
+	"Manchester Airport" "\0\0"
+	"Market Street" "\0\0\0"
+	"Martinscroft" "\0\0\0\0"
+	"MediaCityUK" "\0"
+	"Milnrow" "\0"
+	"Monsall" "\0"
+	"Moor Road" "\0\0\0"
+	"Navigation Road" "\0"
+	"Newbold" "\0"
+	"Newhey" "\0\0"
+	"New Islington" "\0\0\0"
+	"Newton Heath and Moston" "\0"
+	"Northern Moor" "\0\0\0"
+	"Oldham Central" "\0\0"
+	"Oldham King Street" "\0\0"
+	"Oldham Mumps" "\0\0\0\0"
+	"Old Trafford" "\0\0\0\0"
+	"Peel Hall" "\0\0\0"
+	"Piccadilly" "\0\0"
+	"Piccadilly Gardens" "\0\0"
+	"Pomona" "\0\0"
+	"Prestwich" "\0\0\0"
+	"Queens Road" "\0"
+	"Radcliffe" "\0\0\0"
+	"Robinswood Road" "\0"
+	"Rochdale Railway Station" "\0\0\0\0"
+	"Rochdale Town Centre" "\0\0\0\0"
+	"Roundthorn" "\0\0"
+	"Sale" "\0\0\0\0"
+	"Sale Water Park" "\0"
+	"Salford Quays" "\0\0\0"
+	"Shadowmoss" "\0\0"
+	"Shaw and Crompton" "\0\0\0"
+	"Shudehill" "\0\0\0"
+	"South Chadderton" "\0\0\0\0"
+	"St Peters Square" "\0\0\0\0"
+	"Stretford" "\0\0\0"
+	"St Werburgh\342\200\231s Road" "\0\0\0\0"
+	"Timperley" "\0\0\0"
+	"Trafford Bar" "\0\0\0\0"
+	"Velopark" "\0\0\0\0"
+	"Victoria" "\0\0\0\0"
+	"Weaste" "\0\0"
+	"West Didsbury" "\0\0\0"
+	"Westwood" "\0\0\0\0"
+	"Whitefield" "\0\0"
+	"Withington" "\0\0"
+	"Wythenshawe Park" "\0\0\0\0"
+	"Wythenshawe Town Centre";
+
+const uint16_t METROLINK_STATION_NAME_OFFSETS[METROLINK_TABLES_NUM_STATIONS] PROGMEM = {
+	0, 16, 28, 40, 52, 72, 84, 96, 104, 124, 136, 160,
+	172, 184, 196, 208, 216, 232, 248, 260, 276, 288, 300, 312,
+	324, 348, 356, 376, 388, 404, 412, 424, 440, 456, 472, 484,
+	496, 508, 524, 536, 548, 560, 584, 596, 608, 628, 644, 660,
+	672, 680, 688, 700, 716, 724, 732, 748, 772, 788, 804, 824,
+	840, 856, 868, 880, 900, 908, 920, 932, 944, 960, 988, 1012,
+	1024, 1032, 1048, 1064, 1076, 1096, 1108, 1128, 1148, 1160, 1184, 1196,
+	1212, 1224, 1236, 1244, 1260, 1272, 1284, 1296, 1316,
+};
+
+const uint8_t METROLINK_LINKS[METROLINK_NUM_LINKS][2] PROGMEM = {
+	{29, 42},
+	{42, 86},
+	{86, 43},
+	{43, 12},
+	{12, 47},
+	{12, 37},
+	{47, 37},
+	{37, 2},
+	{2, 74},
+	{74, 32},
+	{32, 64},
+	{64, 20},
+	{1, 51},
+	{51, 82},
+	{82, 13},
+	{13, 72},
+	{72, 23},
+	{23, 80},
+	{80, 60},
+	{60, 83},
+	{83, 20},
+	{44, 75},
+	{75, 61},
+	{61, 68},
+	{68, 92},
+	{92, 21},
+	{21, 9},
+	{9, 46},
+	{46, 71},
+	{71, 7},
+	{7, 50},
+	{50, 91},
+	{91, 56},
+	{56, 73},
+	{73, 8},
+	{8, 81},
+	{81, 18},
+	{18, 35},
+	{35, 83},
+	{28, 26},
+	{26, 87},
+	{87, 14},
+	{14, 90},
+	{90, 81},
+	{20, 24},
+	{24, 79},
+	{79, 33},
+	{33, 85},
+	{79, 45},
+	{45, 77},
+	{77, 85},
+	{79, 63},
+	{63, 45},
+	{63, 62},
+	{62, 54},
+	{15, 67},
+	{67, 89},
+	{89, 10},
+	{10, 65},
+	{65, 38},
+	{38, 11},
+	{11, 22},
+	{22, 0},
+	{0, 66},
+	{66, 85},
+	{70, 69},
+	{69, 52},
+	{52, 41},
+	{41, 48},
+	{48, 53},
+	{53, 76},
+	{76, 25},
+	{25, 59},
+	{59, 57},
+	{57, 58},
+	{58, 88},
+	{88, 36},
+	{36, 78},
+	{78, 39},
+	{39, 34},
+	{34, 55},
+	{55, 17},
+	{17, 49},
+	{49, 85},
+	{4, 5},
+	{5, 3},
+	{3, 6},
+	{6, 27},
+	{27, 16},
+	{16, 30},
+	{30, 19},
+	{19, 84},
+	{84, 31},
+	{31, 40},
+	{40, 54},
+};
+
+alignas(4) const char METROLINK_STATION_KEYS[METROLINK_TABLES_NUM_STATIONS][METROLINK_KEY_STRIDE] PROGMEM = {
+	"abrahammoss",
+	"altrincham",
+	"anchorage",
+	"ashtonmoss",
+	"ashtonunderlyne",
+	"ashtonwest",
+	"audenshaw",
+	"baguley",
+	"barlowmoorroad",
+	"benchill",
+	"bessesothbarn",
+	"bowkervale",
+	"broadway",
+	"brooklands",
+	"burtonroad",
+	"bury",
+	"cemeteryroad",
+	"centralpark",
+	"chorlton",
+	"claytonhall",
+	"cornbrook",
+	"crossacres",
+	"crumpsall",
+	"daneroad",
+	"deansgatecastlefield",
+	"derker",
+	"didsburyvillage",
+	"droylsden",
+	"eastdidsbury",
+	"eccles",
+	"edgelane",
+	"etihadcampus",
+	"exchangequay",
+	"exchangesquare",
+	"failsworth",
+	"firswood",
+	"freehold",
+	"harbourcity",
+	"heatonpark",
+	"hollinwood",
+	"holttown",
+	"kingswaybusinesspark",
+	"ladywell",
+	"langworthy",
+	"manchesterairport",
+	"marketstreet",
+	"martinscroft",
+	"mediacityuk",
+	"milnrow",
+	"monsall",
+	"moorroad",
+	"navigationroad",
+	"newbold",
+	"newhey",
+	"newislington",
+	"newtonheathandmoston",
+	"northernmoor",
+	"oldhamcentral",
+	"oldhamkingstreet",
+	"oldhammumps",
+	"oldtrafford",
+	"peelhall",
+	"piccadilly",
+	"piccadillygardens",
+	"pomona",
+	"prestwich",
+	"queensroad",
+	"radcliffe",
+	"robinswoodroad",
+	"rochdalerailwaystation",
+	"rochdaletowncentre",
+	"roundthorn",
+	"sale",
+	"salewaterpark",
+	"salfordquays",
+	"shadowmoss",
+	"shawandcrompton",
+	"shudehill",
+	"southchadderton",
+	"stpeterssquare",
+	"stretford",
+	"stwerburghsroad",
+	"timperley",
+	"traffordbar",
+	"velopark",
+	"victoria",
+	"weaste",
+	"westdidsbury",
+	"westwood",
+	"whitefield",
+	"withington",
+	"wythenshawepark",
+	"wythenshawetowncentre",
+};
+
+const uint32_t METROLINK_STATION_HASHES[METROLINK_TABLES_NUM_STATIONS] PROGMEM = {
+	0xD062CAB1u, 0x354C8960u, 0x8C7A2627u, 0xD80E3532u, 0x43B337C8u, 0xF84D96CBu,
+	0x308331E5u, 0xC85E0512u, 0x2873EBABu, 0xFFEDC9E8u, 0x8388B9AAu, 0x9DC7B151u,
+	0x60DE4F12u, 0xF80C519Au, 0x4BF1856Du, 0x68F934CDu, 0xEE07D627u, 0x6EEF03D2u,
+	0xCE1287B6u, 0xC074ACFAu, 0x192CC86Eu, 0x317099A7u, 0x6E9831D6u, 0x1D0FB945u,
+	0x7D97F3DBu, 0x42EA3FBAu, 0x655A7341u, 0xEBC76B25u, 0xBC82DFAAu, 0xFA0A85FEu,
+	0xF28CC536u, 0x5937AD19u, 0x7D20B860u, 0x0F579F1Fu, 0x7378D912u, 0x9218AD6Eu,
+	0x45B970DAu, 0x933B12F7u, 0x69CEBB46u, 0x1CF9D47Eu, 0xF695E3E4u, 0x4DB43FACu,
+	0x3C72CB79u, 0x3D61F8A2u, 0x10BEDEC6u, 0x16CD8E1Au, 0x36748715u, 0xECAB4A20u,
+	0x52484467u, 0xD501D995u, 0x4C092BC2u, 0x9C28D901u, 0x10D7E51Au, 0x02054679u,
+	0xBE77374Au, 0x5796AA2Bu, 0x5A5989E2u, 0x30C73F95u, 0xEB8EB264u, 0x361C4FC4u,
+	0x3F6A7BF6u, 0x7EEC16DCu, 0xDE454B4Fu, 0xB02F0133u, 0x23DD4269u, 0x0DFE257Au,
+	0x9E7AC50Cu, 0xEA28E7B9u, 0x9647A233u, 0x915CDB68u, 0xF33F21BAu, 0x7F82A1C8u,
+	0xB10E5CBEu, 0x47424D6Du, 0x35D9525Bu, 0xC065EA2Fu, 0x43FD00ABu, 0xB300DE51u,
+	0xD0092654u, 0x8F7ABC3Eu, 0xDA0EAA40u, 0x2AEF08D9u, 0x918C9246u, 0x0869091Eu,
+	0x4777DAE9u, 0x31801A8Cu, 0xC0097F8Eu, 0x20BD9A78u, 0xB102DA97u, 0xC98781A2u,
+	0x61CBD624u, 0x94F2299Cu, 0xE9B524B3u,
+};
+
+const uint8_t METROLINK_STATION_INDEX[1 << METROLINK_STATION_INDEX_BITS] PROGMEM = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0x3B, 0xFF, 0xFF, 0x4A, 0xFF, 0x47, 0x0D, 0x01, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x2F, 0xFF, 0xFF, 0xFF, 0xFF, 0x2B, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x53, 0x11, 0xFF, 0xFF, 0x18, 0xFF, 0x02, 0x04, 0xFF,
+	0x50, 0xFF, 0x38, 0xFF, 0xFF, 0x4E, 0xFF, 0xFF, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x08, 0xFF, 0xFF, 0xFF, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0x1D, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3A, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x10, 0xFF, 0x24, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4B, 0xFF, 0x14, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x58, 0x55, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3C, 0x26,
+	0x5A, 0xFF, 0xFF, 0x05, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0x2D, 0xFF, 0xFF, 0x00, 0xFF, 0xFF, 0x54, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x4F, 0xFF,
+	0xFF, 0xFF, 0xFF, 0x16, 0xFF, 0xFF, 0x1A, 0xFF, 0x57, 0xFF, 0xFF, 0xFF, 0x2C, 0xFF, 0x4D, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x19, 0x28,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x0B,
+	0xFF, 0x34, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x23, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x0C, 0xFF, 0xFF, 0xFF, 0x37, 0xFF, 0xFF, 0x21, 0xFF, 0x29, 0xFF, 0xFF, 0xFF, 0x07, 0x42, 0x59,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x12, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0x35, 0xFF, 0xFF, 0xFF, 0x20, 0xFF, 0xFF, 0xFF, 0x15, 0xFF, 0xFF, 0x17, 0xFF, 0xFF,
+	0x56, 0xFF, 0xFF, 0xFF, 0xFF, 0x2A, 0xFF, 0xFF, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x51, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x48, 0xFF,
+	0xFF, 0xFF, 0xFF, 0x5C, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x27, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x46, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x36, 0xFF, 0xFF, 0xFF, 0x1C, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x06, 0xFF, 0x31, 0xFF, 0xFF, 0xFF, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0x4C,
+	0xFF, 0xFF, 0xFF, 0x1E, 0x22, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x49, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0x0A, 0xFF, 0xFF, 0x39, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0x40, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x2E, 0xFF, 0xFF, 0x0E, 0x43, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x25, 0xFF, 0xFF, 0x45, 0xFF, 0xFF, 0x13, 0x32, 0xFF, 0xFF, 0xFF, 0x5B,
+	0xFF, 0xFF, 0xFF, 0x3E, 0x44, 0x52, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x41,
+};
+
+const uint8_t METROLINK_DESTINATION_SETS[METROLINK_NUM_DESTINATION_SETS][METROLINK_STATION_SET_BYTES] PROGMEM = {
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x04, 0x10, 0x00, 0x20, 0x20, 0x8C, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00},
+	{0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x78, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x80, 0x02, 0x20, 0x00, 0x00, 0x50, 0x00, 0x20, 0x90, 0x08, 0x00, 0x10},
+	{0x80, 0x03, 0x20, 0x00, 0x00, 0x50, 0x04, 0x21, 0x90, 0x0A, 0x00, 0x18},
+	{0x00, 0x02, 0x20, 0x00, 0x00, 0x10, 0x00, 0x20, 0x10, 0x08, 0x00, 0x10},
+	{0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x02},
+	{0x00, 0x8C, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02},
+	{0x00, 0x10, 0x00, 0x20, 0x00, 0x8C, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00},
+	{0x02, 0x20, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00},
+	{0x00, 0x40, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00},
+	{0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x78, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x02, 0x02, 0x94, 0x02, 0xB1, 0x0E, 0x60, 0x50, 0x00, 0x01},
+	{0x80, 0x43, 0x24, 0x14, 0x00, 0x50, 0x04, 0x21, 0x90, 0x0A, 0x82, 0x1C},
+	{0x78, 0x00, 0x09, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x86, 0x73, 0xB4, 0x34, 0x29, 0xDC, 0x0C, 0x31, 0x91, 0x0F, 0xCF, 0x1C},
+	{0x00, 0x00, 0x20, 0x00, 0x00, 0x10, 0x00, 0x20, 0x10, 0x08, 0x00, 0x10},
+	{0x00, 0x8C, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02},
+	{0x02, 0x20, 0x80, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x01, 0x04, 0x00},
+	{0x86, 0x73, 0xB4, 0x35, 0x29, 0xDC, 0x0C, 0x31, 0x91, 0x0F, 0xCF, 0x1C},
+	{0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x31, 0x00, 0x60, 0x10, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x78, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x78, 0x00, 0x01, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x78, 0x00, 0x09, 0xC8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00},
+	{0x04, 0x10, 0x00, 0x20, 0x21, 0x8C, 0x00, 0x00, 0x00, 0x04, 0x40, 0x00},
+	{0xFE, 0x73, 0xBD, 0xFD, 0x2B, 0xFD, 0x4C, 0xF1, 0x91, 0xAF, 0xDF, 0x1C},
+	{0x00, 0x00, 0x00, 0x02, 0x94, 0x02, 0x31, 0x0E, 0x60, 0x50, 0x00, 0x01},
+	{0x80, 0x43, 0x24, 0x14, 0x08, 0x50, 0x04, 0x21, 0x90, 0x0A, 0x82, 0x1C},
+	{0x00, 0x00, 0x00, 0x02, 0x10, 0x02, 0x31, 0x0E, 0x60, 0x10, 0x00, 0x01},
+	{0x00, 0x10, 0x00, 0x20, 0x20, 0x8C, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00},
+	{0x00, 0x84, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02},
+	{0x00, 0x00, 0x00, 0x02, 0x90, 0x02, 0x31, 0x0E, 0x60, 0x50, 0x00, 0x01},
+	{0x78, 0x00, 0x09, 0xC8, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x10, 0x00, 0x60, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x20, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x20, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x02, 0x20, 0x00, 0x00, 0x50, 0x00, 0x20, 0x10, 0x08, 0x00, 0x10},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x11, 0x00, 0x60, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x02, 0x02, 0x94, 0x02, 0xB3, 0x0E, 0x60, 0x50, 0x00, 0x01},
+	{0x80, 0x02, 0x20, 0x00, 0x00, 0x50, 0x04, 0x20, 0x90, 0x08, 0x00, 0x10},
+	{0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x60, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x31, 0x00, 0x60, 0x00, 0x00, 0x00},
+	{0x78, 0x00, 0x09, 0xC8, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00, 0x10, 0x00},
+	{0x00, 0x00, 0x00, 0x02, 0x94, 0x02, 0xB1, 0x0E, 0x60, 0x50, 0x00, 0x01},
+	{0x80, 0x02, 0x20, 0x00, 0x00, 0x50, 0x04, 0x21, 0x90, 0x08, 0x00, 0x18},
+	{0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x31, 0x0A, 0x60, 0x10, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x31, 0x0E, 0x60, 0x10, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x31, 0x08, 0x60, 0x10, 0x00, 0x00},
+	{0x02, 0x20, 0x80, 0x00, 0x00, 0x00, 0x08, 0x10, 0x00, 0x01, 0x05, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x20, 0x00, 0x08, 0x00, 0x00},
+	{0x78, 0x00, 0x09, 0xC8, 0x00, 0x01, 0x40, 0x40, 0x00, 0x00, 0x10, 0x00},
+	{0x04, 0x10, 0x00, 0x20, 0x21, 0x8C, 0x00, 0x00, 0x01, 0x04, 0x40, 0x00},
+	{0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02},
+	{0xFE, 0x73, 0xBF, 0xFF, 0xBF, 0xFF, 0xFF, 0xFF, 0xF5, 0xFF, 0xFF, 0x1D},
+	{0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x20, 0x10, 0x08, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00},
+	{0x00, 0x02, 0x20, 0x00, 0x00, 0x50, 0x00, 0x20, 0x90, 0x08, 0x00, 0x10},
+	{0x02, 0x20, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x01, 0x04, 0x00},
+	{0x80, 0x02, 0x20, 0x00, 0x00, 0x50, 0x04, 0x21, 0x90, 0x0A, 0x00, 0x18},
+	{0x04, 0x10, 0x00, 0x20, 0x20, 0x8C, 0x00, 0x00, 0x00, 0x04, 0x40, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x31, 0x00, 0x60, 0x10, 0x00, 0x00},
+	{0x00, 0x00, 0x00, 0x02, 0x10, 0x02, 0x31, 0x0E, 0x60, 0x50, 0x00, 0x01},
+	{0x02, 0x20, 0x80, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x01, 0x05, 0x00},
+	{0x80, 0x43, 0x20, 0x14, 0x00, 0x50, 0x04, 0x21, 0x90, 0x0A, 0x82, 0x1C},
+	{0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x04, 0x00},
+	{0x82, 0x63, 0xA4, 0x14, 0x08, 0x50, 0x0C, 0x31, 0x90, 0x0B, 0x8F, 0x1C},
+	{0x78, 0x00, 0x09, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00},
+	{0xFE, 0x73, 0xBF, 0xFF, 0xBF, 0xFF, 0xFF, 0xFF, 0xF1, 0xFF, 0xFF, 0x1D},
+	{0x00, 0x00, 0x00, 0x20, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00},
+	{0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00},
+	{0x00, 0x00, 0x00, 0x02, 0x00, 0x02, 0x31, 0x0E, 0x60, 0x10, 0x00, 0x01},
+	{0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x02},
+	{0x00, 0x40, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x04},
+	{0x80, 0x02, 0x20, 0x00, 0x00, 0x50, 0x04, 0x20, 0x90, 0x08, 0x00, 0x18},
+	{0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x20, 0x10, 0x08, 0x00, 0x10},
+	{0x01, 0x8C, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, 0x0A, 0x00, 0x00, 0x02},
+	{0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFF, 0xFB, 0x1F},
+	{0x7D, 0x9C, 0x5B, 0xEB, 0xF7, 0xAF, 0xF3, 0xCE, 0x6F, 0xF4, 0x70, 0x03},
+	{0xFD, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFE, 0xFB, 0x1F},
+	{0x79, 0x8C, 0x4B, 0xCB, 0xD6, 0x23, 0xF3, 0xCE, 0x6E, 0xF0, 0x30, 0x03},
+	{0x79, 0x8C, 0x4B, 0xCA, 0xD6, 0x23, 0xF3, 0xCE, 0x6E, 0x70, 0x30, 0x03},
+	{0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFD, 0xDF, 0x7F, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFE, 0xFA, 0x1F},
+	{0x01, 0x8C, 0x40, 0x00, 0x40, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x00, 0x02},
+	{0xFD, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFF, 0xFB, 0x1F},
+	{0x79, 0x8C, 0x4B, 0xCA, 0xD6, 0x23, 0xF3, 0xCE, 0x6E, 0xF0, 0x30, 0x03},
+	{0xFD, 0xDF, 0x7F, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFE, 0xFB, 0x1F},
+	{0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFD, 0xDF, 0x7F, 0xFF, 0xFF, 0xFF, 0xF7, 0xEF, 0xFF, 0xFE, 0xFA, 0x1F},
+	{0xFB, 0xEF, 0xFF, 0xDF, 0xDE, 0x73, 0xFF, 0xFF, 0xFE, 0xFB, 0xBF, 0x1F},
+	{0xFB, 0xEF, 0xFF, 0xDF, 0xDF, 0x73, 0xFF, 0xFF, 0xFF, 0xFB, 0xBF, 0x1F},
+	{0xFB, 0xEF, 0xFF, 0xDF, 0xDE, 0x73, 0xFF, 0xFF, 0xFF, 0xFB, 0xBF, 0x1F},
+	{0xFB, 0xEF, 0xFF, 0xDF, 0xDF, 0x73, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0x1F},
+	{0xC7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0x87, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0x87, 0xFF, 0xFE, 0xB7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0x87, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0x87, 0xFF, 0xFE, 0xF7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0xB7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0x37, 0xFF, 0xFE, 0xBF, 0x3F, 0xFF, 0xFF, 0xEF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0x37, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0x37, 0xFF, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0x37, 0xFF, 0xFE, 0xBF, 0xFF, 0xFF, 0xFF, 0xEF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0x37, 0xFF, 0xFE, 0xBF, 0xBF, 0xFF, 0xFF, 0xEF, 0x1F},
+	{0x87, 0xFF, 0xF6, 0xB7, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xCF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xEF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0x7F, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFB, 0xDE, 0x6F, 0xF5, 0xFF, 0x07},
+	{0x7F, 0xBC, 0xDF, 0xEB, 0xFF, 0xAF, 0xFB, 0xDE, 0x6F, 0xF5, 0x7D, 0x03},
+	{0x7F, 0xBC, 0xDB, 0xEB, 0xFF, 0xAF, 0xFB, 0xDE, 0x6F, 0xF5, 0x7D, 0x03},
+	{0x7F, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFF, 0xDF, 0x6F, 0xF7, 0xFF, 0x0F},
+	{0x7F, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFB, 0xDF, 0x6F, 0xF7, 0xFF, 0x07},
+	{0x7F, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFB, 0xDE, 0x6F, 0xF7, 0xFF, 0x07},
+	{0x7F, 0xFC, 0xDF, 0xFF, 0xFF, 0xAF, 0xFB, 0xDE, 0x6F, 0xF5, 0xFF, 0x07},
+	{0x7F, 0xBC, 0xDB, 0xEB, 0xF7, 0xAF, 0xFB, 0xDE, 0x6F, 0xF5, 0x7D, 0x03},
+	{0x7F, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFB, 0xDF, 0x6F, 0xF7, 0xFF, 0x0F},
+	{0xFF, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFF, 0xDF, 0x6F, 0xF7, 0xFF, 0x0F},
+	{0xFF, 0xFD, 0xDF, 0xFF, 0xFF, 0xEF, 0xFF, 0xDF, 0xEF, 0xF7, 0xFF, 0x0F},
+	{0xFF, 0xFD, 0xDF, 0xFF, 0xFF, 0xAF, 0xFF, 0xDF, 0xEF, 0xF7, 0xFF, 0x0F},
+	{0xFF, 0x73, 0xBF, 0xFF, 0xBF, 0xFF, 0xFF, 0xFF, 0xF5, 0xFF, 0xFF, 0x1D},
+	{0xFF, 0x7B, 0xFF, 0xFF, 0xBF, 0xFF, 0xFF, 0xFF, 0xF5, 0xFF, 0xFF, 0x1D},
+	{0xFF, 0x73, 0xFF, 0xFF, 0xBF, 0xFF, 0xFF, 0xFF, 0xF5, 0xFF, 0xFF, 0x1D},
+	{0xFF, 0x7B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF5, 0xFF, 0xFF, 0x1D},
+	{0xFF, 0x7B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0x1D},
+	{0xFF, 0xEF, 0xFF, 0xDF, 0xDF, 0x73, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0x1F},
+	{0xFF, 0xEF, 0xFF, 0xDF, 0xFF, 0xF3, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0x1F},
+	{0xFF, 0xBF, 0xFF, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x1B},
+	{0xFF, 0xBF, 0xFF, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x1F},
+	{0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0x1D},
+	{0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFD, 0xFD, 0x6B, 0xFD, 0x4E, 0xF1, 0x9F, 0xAF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFD, 0xFD, 0x6B, 0xFD, 0x4C, 0xF1, 0x9F, 0xAF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xDF, 0xFF, 0xFF, 0xEF, 0xFF, 0xDF, 0xEF, 0xF7, 0xFF, 0x0F},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0x6B, 0xFD, 0x4E, 0xF1, 0x9F, 0xAF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0x6F, 0xFD, 0xCE, 0xF1, 0x9F, 0xAF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFD, 0xCE, 0xF1, 0x9F, 0xEF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xEF, 0xFD, 0xCE, 0xF1, 0x9F, 0xAF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0x6B, 0xFD, 0xCE, 0xF1, 0x9F, 0xAF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFD, 0xCE, 0xF7, 0x9F, 0xEF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFD, 0xCE, 0xF5, 0x9F, 0xEF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFD, 0xCE, 0xFF, 0x9F, 0xEF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xEF, 0xFD, 0xCE, 0xF1, 0x9F, 0xEF, 0xFF, 0x1E},
+	{0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFD, 0xCE, 0xF1, 0x9F, 0xEF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xEB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xDF, 0xFF, 0xF3, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xDF, 0xFF, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xDF, 0xFF, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xCE, 0xFF, 0x9F, 0xEF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xEF, 0xFF, 0x9F, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xEE, 0xFF, 0x9F, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xCE, 0xFF, 0x9F, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0xDF, 0xEF, 0xF7, 0xFF, 0x0F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0xFF, 0xFF, 0xF7, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0xDF, 0xFF, 0xF7, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0xDF, 0xEF, 0xF7, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xFF, 0x9F, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x9F, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xFF, 0xFF, 0x1F},
+	{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xDF, 0xFF, 0x1F},
+};
+
+const metrolink_destination_set_id_t METROLINK_JOURNEY_DESTINATION_SETS[METROLINK_TABLES_NUM_STATIONS][METROLINK_TABLES_NUM_STATIONS] PROGMEM = {
+	// Abraham Moss
+	{
+		0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Altrincham
+	{
+		88, 0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 89, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 91, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 94, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 97, 70, 71, 72, 73, 93, 74, 98,
+		99, 76, 100, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Anchorage
+	{
+		88, 1, 0, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Ashton Moss
+	{
+		88, 1, 2, 0, 4, 5, 106, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		107, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 109, 28, 29, 110, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Ashton-Under-Lyne
+	{
+		88, 1, 2, 118, 0, 119, 106, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		107, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 109, 28, 29, 110, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Ashton West
+	{
+		88, 1, 2, 118, 4, 0, 106, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		107, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 109, 28, 29, 110, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Audenshaw
+	{
+		88, 1, 2, 3, 4, 5, 0, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		107, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 109, 28, 29, 110, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Baguley
+	{
+		88, 1, 2, 3, 4, 5, 6, 0, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 87,
+	},
+	// Barlow Moor Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 0, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Benchill
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 0, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 131, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 87,
+	},
+	// Besses O’ Th’ Barn
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0, 133, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 135, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 136, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Bowker Vale
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 0, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Broadway
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 0, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 138, 38, 39, 40, 41, 42, 43, 44, 93, 45, 138,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Brooklands
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 0, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 91, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 97, 70, 71, 72, 73, 93, 74, 98,
+		99, 76, 77, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Burton Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 0, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 139, 77, 127, 79, 93, 81, 82, 83, 84, 140, 86, 87,
+	},
+	// Bury
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 141, 133, 12, 13, 14, 0,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 135, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 136, 63, 142, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 143, 85, 86, 87,
+	},
+	// Cemetery Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		0, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 110, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Central Park
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 0, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Chorlton
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 0, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 127, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Clayton Hall
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 0, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Cornbrook
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 0, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Crossacres
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 146, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 0, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 131, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 87,
+	},
+	// Crumpsall
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 0, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Dane Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 0, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		99, 76, 77, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Deansgate - Castlefield
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 0, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Derker
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 0, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Didsbury Village
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 157, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 0, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 139, 77, 127, 79, 93, 81, 158, 83, 84, 140, 86, 87,
+	},
+	// Droylsden
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		107, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 0, 28, 29, 110, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// East Didsbury
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 157, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 159, 27, 0, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 139, 77, 127, 79, 93, 81, 158, 83, 84, 140, 86, 87,
+	},
+	// Eccles
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 160, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 0, 30, 31,
+		103, 93, 34, 35, 36, 138, 38, 39, 40, 41, 161, 162, 44, 93, 45, 138,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 163, 82, 83, 84, 85, 86, 87,
+	},
+	// Edge Lane
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 108, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 0, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 117, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Etihad Campus
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 0,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 79, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Exchange Quay
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		0, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Exchange Square
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 0, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 164, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 164,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 164, 74, 164,
+		75, 76, 77, 78, 79, 164, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Failsworth
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 0, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Firswood
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 0, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 127, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Freehold
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 0, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Harbour City
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 0, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Heaton Park
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 133, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 0, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Hollinwood
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 36, 37, 38, 0, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Holt Town
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 112, 34, 35, 36, 37, 38, 39, 0, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 79, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Kingsway Business Park
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 0, 42, 43, 44, 33, 45, 12,
+		166, 144, 48, 49, 50, 167, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 168, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Ladywell
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 160, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 138, 38, 39, 40, 41, 0, 162, 44, 93, 45, 138,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 163, 82, 83, 84, 85, 86, 87,
+	},
+	// Langworthy
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 160, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 138, 38, 39, 40, 41, 42, 0, 44, 93, 45, 138,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Manchester Airport
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 146, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 169, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 0, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 170, 60, 93,
+		61, 62, 96, 64, 171, 66, 67, 131, 69, 125, 71, 172, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 173,
+	},
+	// Market Street
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 174, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 0, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 174,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 174, 74, 174,
+		75, 76, 77, 78, 79, 174, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Martinscroft
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 0, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 131, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 87,
+	},
+	// MediaCityUK
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 175, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 175, 38, 39, 40, 41, 42, 43, 44, 93, 45, 0,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Milnrow
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		0, 144, 48, 49, 50, 167, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 168, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Monsall
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 0, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Moor Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 0, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 87,
+	},
+	// Navigation Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 89, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 91, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 0, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 97, 70, 71, 72, 73, 93, 74, 98,
+		99, 76, 100, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Newbold
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 176, 42, 43, 44, 33, 45, 12,
+		166, 144, 48, 49, 0, 167, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 168, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Newhey
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 0, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 168, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// New Islington
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 112, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 0, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 79, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Newton Heath and Moston
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 0, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Northern Moor
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 0, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Oldham Central
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 0, 153, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Oldham King Street
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 55, 0, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Oldham Mumps
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 152, 153, 0, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Old Trafford
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 0, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Peel Hall
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 146, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 169, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 0, 60, 93,
+		61, 62, 96, 64, 171, 66, 67, 131, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 173,
+	},
+	// Piccadilly
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 112, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 0, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 79, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Piccadilly Gardens
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 112, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 0,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 79, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Pomona
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		0, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Prestwich
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 133, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 135, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 0, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Queens Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 0, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Radcliffe
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 141, 133, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 135, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 136, 63, 0, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 143, 85, 86, 87,
+	},
+	// Robinswood Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 146, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 169, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 0, 66, 67, 131, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 173,
+	},
+	// Rochdale Railway Station
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 176, 42, 43, 44, 33, 45, 12,
+		166, 144, 48, 49, 177, 167, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 0, 67, 68, 69, 70, 71, 72, 168, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Rochdale Town Centre
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 176, 42, 43, 44, 33, 45, 12,
+		166, 144, 48, 49, 177, 167, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 178, 0, 68, 69, 70, 71, 72, 168, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Roundthorn
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 0, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 87,
+	},
+	// Sale
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 91, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 0, 70, 71, 72, 73, 93, 74, 98,
+		99, 76, 77, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Sale Water Park
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 0, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Salford Quays
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 0, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Shadowmoss
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 146, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 169, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 170, 60, 93,
+		61, 62, 96, 64, 171, 66, 67, 131, 69, 125, 71, 0, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 173,
+	},
+	// Shaw and Crompton
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 165, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 152, 153, 154, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 0, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 156, 84, 85, 86, 87,
+	},
+	// Shudehill
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 179, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 179, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 179,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 0, 74, 179,
+		75, 76, 77, 78, 79, 179, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// South Chadderton
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 36, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 0, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// St Peters Square
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 0,
+		75, 76, 77, 78, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Stretford
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		0, 76, 77, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// St Werburgh’s Road
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 0, 77, 127, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Timperley
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 89, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 91, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 95, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 97, 70, 71, 72, 73, 93, 74, 98,
+		99, 76, 0, 101, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Trafford Bar
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 76, 77, 0, 79, 93, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Velopark
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 111,
+		32, 112, 34, 35, 36, 37, 38, 39, 113, 41, 42, 43, 44, 112, 45, 12,
+		46, 47, 48, 49, 50, 51, 114, 53, 54, 55, 56, 57, 58, 59, 115, 116,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 112, 74, 112,
+		75, 76, 77, 78, 0, 112, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Victoria
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 0, 81, 82, 83, 84, 85, 86, 87,
+	},
+	// Weaste
+	{
+		88, 1, 137, 3, 4, 5, 6, 7, 8, 9, 10, 11, 160, 13, 14, 15,
+		16, 17, 18, 19, 102, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		103, 93, 34, 35, 36, 138, 38, 39, 40, 41, 42, 162, 44, 93, 45, 138,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		104, 62, 96, 64, 65, 66, 67, 68, 69, 70, 105, 72, 73, 93, 74, 98,
+		75, 76, 77, 78, 79, 93, 0, 82, 83, 84, 85, 86, 87,
+	},
+	// West Didsbury
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 157, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 139, 77, 127, 79, 93, 81, 0, 83, 84, 140, 86, 87,
+	},
+	// Westwood
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 147, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 148, 35, 149, 37, 38, 150, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 144, 48, 49, 50, 51, 52, 151, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 155, 33,
+		75, 76, 77, 78, 79, 145, 81, 82, 0, 84, 85, 86, 87,
+	},
+	// Whitefield
+	{
+		132, 1, 2, 3, 4, 5, 6, 7, 8, 9, 141, 133, 12, 13, 14, 15,
+		16, 17, 18, 19, 20, 21, 134, 23, 24, 25, 26, 27, 28, 29, 30, 31,
+		32, 33, 34, 35, 36, 37, 135, 39, 40, 41, 42, 43, 44, 33, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 33,
+		61, 136, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 33, 74, 33,
+		75, 76, 77, 78, 79, 80, 81, 82, 83, 0, 85, 86, 87,
+	},
+	// Withington
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 93, 74, 98,
+		75, 139, 77, 127, 79, 93, 81, 82, 83, 84, 0, 86, 87,
+	},
+	// Wythenshawe Park
+	{
+		88, 1, 2, 3, 4, 5, 6, 7, 120, 9, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 21, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 45, 12,
+		46, 47, 48, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 68, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 0, 87,
+	},
+	// Wythenshawe Town Centre
+	{
+		88, 1, 2, 3, 4, 5, 6, 129, 120, 146, 10, 11, 12, 13, 14, 15,
+		16, 17, 121, 19, 90, 169, 22, 23, 92, 25, 26, 27, 28, 29, 30, 31,
+		32, 93, 34, 122, 36, 37, 38, 39, 40, 41, 42, 43, 44, 93, 130, 12,
+		46, 47, 123, 49, 50, 51, 52, 53, 124, 55, 56, 57, 58, 59, 60, 93,
+		61, 62, 96, 64, 65, 66, 67, 131, 69, 125, 71, 72, 73, 93, 74, 98,
+		75, 126, 77, 127, 79, 93, 81, 82, 83, 84, 85, 128, 0,
+	},
+};
+
+const metrolink_neighbour_offset_t METROLINK_NEIGHBOUR_OFFSETS[METROLINK_TABLES_NUM_STATIONS + 1] PROGMEM = {
+	0, 2, 3, 5, 7, 8, 10, 12, 14, 16, 18, 20, 22, 25, 27, 29,
+	30, 32, 34, 36, 38, 41, 43, 45, 47, 49, 51, 53, 55, 56, 57, 59,
+	61, 63, 65, 67, 69, 71, 74, 76, 78, 80, 82, 84, 86, 87, 90, 92,
+	94, 96, 98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124,
+	127, 129, 131, 133, 135, 137, 139, 140, 142, 144, 146, 148, 150, 152, 154, 156,
+	160, 162, 165, 167, 170, 172, 176, 178, 180, 182, 184, 186, 188, 190,
+};
+
+const uint8_t METROLINK_NEIGHBOURS[METROLINK_NUM_NEIGHBOURS] PROGMEM = {
+	// Abraham Moss
+	22, 66,
+	// Altrincham
+	51,
+	// Anchorage
+	37, 74,
+	// Ashton Moss
+	5, 6,
+	// Ashton-Under-Lyne
+	5,
+	// Ashton West
+	4, 3,
+	// Audenshaw
+	3, 27,
+	// Baguley
+	71, 50,
+	// Barlow Moor Road
+	73, 81,
+	// Benchill
+	21, 46,
+	// Besses O’ Th’ Barn
+	89, 65,
+	// Bowker Vale
+	38, 22,
+	// Broadway
+	43, 47, 37,
+	// Brooklands
+	82, 72,
+	// Burton Road
+	87, 90,
+	// Bury
+	67,
+	// Cemetery Road
+	27, 30,
+	// Central Park
+	55, 49,
+	// Chorlton
+	81, 35,
+	// Clayton Hall
+	30, 84,
+	// Cornbrook
+	64, 83, 24,
+	// Crossacres
+	92, 9,
+	// Crumpsall
+	11, 0,
+	// Dane Road
+	72, 80,
+	// Deansgate - Castlefield
+	20, 79,
+	// Derker
+	76, 59,
+	// Didsbury Village
+	28, 87,
+	// Droylsden
+	6, 16,
+	// East Didsbury
+	26,
+	// Eccles
+	42,
+	// Edge Lane
+	16, 19,
+	// Etihad Campus
+	84, 40,
+	// Exchange Quay
+	74, 64,
+	// Exchange Square
+	79, 85,
+	// Failsworth
+	39, 55,
+	// Firswood
+	18, 83,
+	// Freehold
+	88, 78,
+	// Harbour City
+	12, 47, 2,
+	// Heaton Park
+	65, 11,
+	// Hollinwood
+	78, 34,
+	// Holt Town
+	31, 54,
+	// Kingsway Business Park
+	52, 48,
+	// Ladywell
+	29, 86,
+	// Langworthy
+	86, 12,
+	// Manchester Airport
+	75,
+	// Market Street
+	79, 77, 63,
+	// Martinscroft
+	9, 71,
+	// MediaCityUK
+	12, 37,
+	// Milnrow
+	41, 53,
+	// Monsall
+	17, 85,
+	// Moor Road
+	7, 91,
+	// Navigation Road
+	1, 82,
+	// Newbold
+	69, 41,
+	// Newhey
+	48, 76,
+	// New Islington
+	62, 40,
+	// Newton Heath and Moston
+	34, 17,
+	// Northern Moor
+	91, 73,
+	// Oldham Central
+	59, 58,
+	// Oldham King Street
+	57, 88,
+	// Oldham Mumps
+	25, 57,
+	// Old Trafford
+	80, 83,
+	// Peel Hall
+	75, 68,
+	// Piccadilly
+	63, 54,
+	// Piccadilly Gardens
+	79, 45, 62,
+	// Pomona
+	32, 20,
+	// Prestwich
+	10, 38,
+	// Queens Road
+	0, 85,
+	// Radcliffe
+	15, 89,
+	// Robinswood Road
+	61, 92,
+	// Rochdale Railway Station
+	70, 52,
+	// Rochdale Town Centre
+	69,
+	// Roundthorn
+	46, 7,
+	// Sale
+	13, 23,
+	// Sale Water Park
+	56, 8,
+	// Salford Quays
+	2, 32,
+	// Shadowmoss
+	44, 61,
+	// Shaw and Crompton
+	53, 25,
+	// Shudehill
+	45, 85,
+	// South Chadderton
+	36, 39,
+	// St Peters Square
+	24, 33, 45, 63,
+	// Stretford
+	23, 60,
+	// St Werburgh’s Road
+	8, 18, 90,
+	// Timperley
+	51, 13,
+	// Trafford Bar
+	60, 20, 35,
+	// Velopark
+	19, 31,
+	// Victoria
+	33, 77, 66, 49,
+	// Weaste
+	42, 43,
+	// West Didsbury
+	26, 14,
+	// Westwood
+	58, 36,
+	// Whitefield
+	67, 10,
+	// Withington
+	14, 81,
+	// Wythenshawe Park
+	50, 56,
+	// Wythenshawe Town Centre
+	68, 21,
+};
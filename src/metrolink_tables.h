@@ -0,0 +1,132 @@
+// Generated by tools/generate_metrolink_tables.py from
+// src/metrolink_map.txt. Do not edit.
+
+#ifndef METROLINK_TABLES_H
+#define METROLINK_TABLES_H
+
+#include <stdint.h>
+#include <pgmspace.h>
+
+/**
+ * Number of stations the tables were generated for (equal to
+ * NUM_METROLINK_STATIONS).
+ */
+#define METROLINK_TABLES_NUM_STATIONS 93
+
+/**
+ * Length of the longest station key (see metrolink.cpp).
+ */
+#define METROLINK_MAX_KEY_LENGTH 22
+
+/**
+ * Seed and size (log2) of the station index hash table.
+ */
+#define METROLINK_STATION_INDEX_SEED 0x00002575u
+#define METROLINK_STATION_INDEX_BITS 9
+
+/**
+ * Value of empty slots in METROLINK_STATION_INDEX.
+ */
+#define METROLINK_STATION_INDEX_EMPTY 0xFF
+
+/**
+ * Length in bytes (of UTF-8) of the longest station name.
+ */
+#define METROLINK_MAX_NAME_LENGTH 24
+
+/**
+ * CRC-32 of the station names in order, each followed by a newline. Identifies
+ * the station numbering, e.g. in the binary departures format.
+ */
+#define METROLINK_STATIONS_CRC 0x38745942u
+
+/**
+ * The station names (UTF-8), each starting at the offset given by
+ * METROLINK_STATION_NAME_OFFSETS (a multiple of 4) and padded with at least
+ * one null to a multiple of 4 bytes. In flash, 4-byte aligned.
+ */
+extern const char METROLINK_STATION_NAMES[];
+extern const uint16_t METROLINK_STATION_NAME_OFFSETS[METROLINK_TABLES_NUM_STATIONS];
+
+/**
+ * Number of links between stations.
+ */
+#define METROLINK_NUM_LINKS 95
+
+/**
+ * The indices of the stations at either end of each link (listed in one
+ * direction only). In flash.
+ */
+extern const uint8_t METROLINK_LINKS[METROLINK_NUM_LINKS][2];
+
+/**
+ * Size of each entry in METROLINK_STATION_KEYS: at least
+ * METROLINK_MAX_KEY_LENGTH + 1, rounded up to a multiple of 4.
+ */
+#define METROLINK_KEY_STRIDE 24
+
+/**
+ * Canonical key of each station name, padded with nulls. In flash, 4-byte
+ * aligned.
+ */
+extern const char METROLINK_STATION_KEYS[METROLINK_TABLES_NUM_STATIONS][METROLINK_KEY_STRIDE];
+
+/**
+ * FNV-1a hash of each station's key. In flash.
+ */
+extern const uint32_t METROLINK_STATION_HASHES[METROLINK_TABLES_NUM_STATIONS];
+
+/**
+ * Open-addressed (linear probing) hash table of station indices. In flash.
+ */
+extern const uint8_t METROLINK_STATION_INDEX[1 << METROLINK_STATION_INDEX_BITS];
+
+/**
+ * Number of bytes in a station bitset.
+ */
+#define METROLINK_STATION_SET_BYTES 12
+
+/**
+ * Number of distinct destination sets.
+ */
+#define METROLINK_NUM_DESTINATION_SETS 180
+
+/**
+ * Index into METROLINK_DESTINATION_SETS and a macro to read one from flash.
+ */
+typedef uint8_t metrolink_destination_set_id_t;
+#define METROLINK_READ_DESTINATION_SET_ID(addr) pgm_read_byte(addr)
+
+/**
+ * Distinct sets of valid destinations as bitsets (station index i is bit
+ * i % 8 of byte i / 8). Set 0 is empty. In flash.
+ */
+extern const uint8_t METROLINK_DESTINATION_SETS[METROLINK_NUM_DESTINATION_SETS][METROLINK_STATION_SET_BYTES];
+
+/**
+ * For each [start][target] station index pair, the index of the set in
+ * METROLINK_DESTINATION_SETS of valid destinations. In flash.
+ */
+extern const metrolink_destination_set_id_t METROLINK_JOURNEY_DESTINATION_SETS[METROLINK_TABLES_NUM_STATIONS][METROLINK_TABLES_NUM_STATIONS];
+
+/**
+ * Number of entries in METROLINK_NEIGHBOURS (twice the number of links).
+ */
+#define METROLINK_NUM_NEIGHBOURS 190
+
+/**
+ * Index into METROLINK_NEIGHBOURS and a macro to read one from flash.
+ */
+typedef uint8_t metrolink_neighbour_offset_t;
+#define METROLINK_READ_NEIGHBOUR_OFFSET(addr) pgm_read_byte(addr)
+
+/**
+ * The network as a compressed sparse row adjacency: the neighbours of
+ * station i are METROLINK_NEIGHBOURS[METROLINK_NEIGHBOUR_OFFSETS[i]] up to
+ * (but excluding) METROLINK_NEIGHBOURS[METROLINK_NEIGHBOUR_OFFSETS[i + 1]].
+ * In flash.
+ */
+extern const metrolink_neighbour_offset_t METROLINK_NEIGHBOUR_OFFSETS[METROLINK_TABLES_NUM_STATIONS + 1];
+extern const uint8_t METROLINK_NEIGHBOURS[METROLINK_NUM_NEIGHBOURS];
+
+#endif
@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "perf.h"
+
+void perf_histogram_clear(perf_histogram_t *histogram) {
+	memset(histogram, 0, sizeof(*histogram));
+	histogram->min = UINT32_MAX;
+}
+
+/**
+ * The bucket counting a value: one more than the index of its highest set
+ * bit.
+ */
+static size_t bucket_of(uint32_t value) {
+	size_t bucket = value ? 32 - __builtin_clz(value) : 0;
+	return bucket < PERF_HISTOGRAM_BUCKETS ? bucket : PERF_HISTOGRAM_BUCKETS - 1;
+}
+
+void perf_histogram_add(perf_histogram_t *histogram, uint32_t value) {
+	histogram->buckets[bucket_of(value)]++;
+	histogram->count++;
+	histogram->total += value;
+	if (value < histogram->min) {
+		histogram->min = value;
+	}
+	if (value > histogram->max) {
+		histogram->max = value;
+	}
+}
+
+uint32_t perf_histogram_bucket_limit(size_t bucket) {
+	return bucket < PERF_HISTOGRAM_BUCKETS - 1 ? (uint32_t)1 << bucket : UINT32_MAX;
+}
+
+uint32_t perf_histogram_mean(const perf_histogram_t *histogram) {
+	return histogram->count ? (uint32_t)(histogram->total / histogram->count) : 0;
+}
+
+uint32_t perf_histogram_percentile(const perf_histogram_t *histogram,
+                                   unsigned int percent) {
+	// The rank of the percentile, rounded up
+	uint64_t rank = ((uint64_t)histogram->count * percent + 99) / 100;
+	uint32_t seen = 0;
+	for (size_t i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+		seen += histogram->buckets[i];
+		if (seen >= rank && seen > 0) {
+			// The limit is exclusive
+			uint32_t limit = perf_histogram_bucket_limit(i) - (i < PERF_HISTOGRAM_BUCKETS - 1);
+			return limit < histogram->max ? limit : histogram->max;
+		}
+	}
+	return 0;
+}
+
+int perf_histogram_summary(const perf_histogram_t *histogram, char *buf, size_t size) {
+	if (histogram->count == 0) {
+		return snprintf(buf, size, "n=0");
+	}
+	return snprintf(buf, size, "n=%lu min=%lu mean=%lu p50<=%lu p90<=%lu p99<=%lu max=%lu",
+	                (unsigned long)histogram->count,
+	                (unsigned long)histogram->min,
+	                (unsigned long)perf_histogram_mean(histogram),
+	                (unsigned long)perf_histogram_percentile(histogram, 50),
+	                (unsigned long)perf_histogram_percentile(histogram, 90),
+	                (unsigned long)perf_histogram_percentile(histogram, 99),
+	                (unsigned long)histogram->max);
+}
@@ -0,0 +1,65 @@
+#ifndef PERF_H
+#define PERF_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Number of buckets in a histogram. Bucket 0 counts zeros and bucket i counts
+ * values from 2^(i-1) up to (but excluding) 2^i, except for the last bucket
+ * which counts everything from 2^(PERF_HISTOGRAM_BUCKETS-2) upwards.
+ */
+#define PERF_HISTOGRAM_BUCKETS 20
+
+/**
+ * A fixed-size histogram of measurements (durations, byte counts, etc.) with
+ * logarithmically sized buckets. Adding a value takes constant time and never
+ * allocates, so may be done from timer callbacks.
+ *
+ * Initialise with perf_histogram_clear.
+ */
+typedef struct {
+	uint32_t buckets[PERF_HISTOGRAM_BUCKETS];
+
+	// Number, sum and range of the values added
+	uint32_t count;
+	uint64_t total;
+	uint32_t min;
+	uint32_t max;
+} perf_histogram_t;
+
+/**
+ * Remove all values from the histogram.
+ */
+void perf_histogram_clear(perf_histogram_t *histogram);
+
+/**
+ * Add a value to the histogram.
+ */
+void perf_histogram_add(perf_histogram_t *histogram, uint32_t value);
+
+/**
+ * The smallest value counted by the bucket after the given one (UINT32_MAX
+ * for the last bucket).
+ */
+uint32_t perf_histogram_bucket_limit(size_t bucket);
+
+/**
+ * Mean of the values added (0 if none).
+ */
+uint32_t perf_histogram_mean(const perf_histogram_t *histogram);
+
+/**
+ * An upper bound on the given percentile (0-100) of the values added: the
+ * limit of the bucket containing it (capped at the maximum value).
+ */
+uint32_t perf_histogram_percentile(const perf_histogram_t *histogram,
+                                   unsigned int percent);
+
+/**
+ * Write a one-line summary of the histogram (count, min, mean, percentiles
+ * and max) into buf. Returns the length snprintf would produce.
+ */
+int perf_histogram_summary(const perf_histogram_t *histogram, char *buf, size_t size);
+
+#endif
@@ -0,0 +1,44 @@
+#include "power.h"
+
+void power_budget_init(power_budget_t *budget, unsigned long now) {
+	budget->start_time = now;
+	budget->radio_on = true;
+	budget->radio_change_time = now;
+	budget->radio_on_time = 0;
+	budget->cpu_active_us = 0;
+}
+
+void power_budget_set_radio(power_budget_t *budget, unsigned long now, bool on) {
+	if (on == budget->radio_on) {
+		return;
+	}
+	if (budget->radio_on) {
+		budget->radio_on_time += now - budget->radio_change_time;
+	}
+	budget->radio_on = on;
+	budget->radio_change_time = now;
+}
+
+void power_budget_add_cpu_time(power_budget_t *budget, uint32_t us) {
+	budget->cpu_active_us += us;
+}
+
+/**
+ * Scale a time in milliseconds (out of elapsed) to seconds per hour.
+ */
+static unsigned long seconds_per_hour(uint64_t ms, unsigned long elapsed) {
+	return elapsed ? (unsigned long)((ms * 3600) / elapsed) : 0;
+}
+
+void power_budget_per_hour(const power_budget_t *budget, unsigned long now,
+                           power_budget_hourly_t *hourly) {
+	unsigned long elapsed = now - budget->start_time;
+	unsigned long radio_on_time = budget->radio_on_time;
+	if (budget->radio_on) {
+		radio_on_time += now - budget->radio_change_time;
+	}
+
+	hourly->radio_on = seconds_per_hour(radio_on_time, elapsed);
+	hourly->radio_asleep = elapsed ? 3600 - hourly->radio_on : 0;
+	hourly->cpu_active = seconds_per_hour(budget->cpu_active_us / 1000, elapsed);
+}
@@ -0,0 +1,62 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Measures how the time is divided between the radio being on and asleep, and
+ * how much of it the CPU spends doing work. The CPU time is whatever the caller
+ * adds, so is an upper bound if it includes time blocked waiting on the
+ * network.
+ *
+ * Times are in milliseconds (as returned by millis()) unless stated otherwise.
+ * Initialise with power_budget_init.
+ */
+typedef struct {
+	// Time at which measurement began
+	unsigned long start_time;
+
+	// Is the radio on and when was it last switched on or off?
+	bool radio_on;
+	unsigned long radio_change_time;
+
+	// Total time the radio was on, up to radio_change_time
+	unsigned long radio_on_time;
+
+	// Total time the CPU spent working (microseconds)
+	uint64_t cpu_active_us;
+} power_budget_t;
+
+/**
+ * The mean time spent in each state per hour (seconds). radio_on and
+ * radio_asleep always add up to an hour.
+ */
+typedef struct {
+	unsigned long radio_on;
+	unsigned long radio_asleep;
+	unsigned long cpu_active;
+} power_budget_hourly_t;
+
+/**
+ * Start measuring, with the radio on.
+ */
+void power_budget_init(power_budget_t *budget, unsigned long now);
+
+/**
+ * Record the radio being switched on or off.
+ */
+void power_budget_set_radio(power_budget_t *budget, unsigned long now, bool on);
+
+/**
+ * Record time the CPU spent working (microseconds).
+ */
+void power_budget_add_cpu_time(power_budget_t *budget, uint32_t us);
+
+/**
+ * Get the mean time spent in each state per hour since power_budget_init.
+ */
+void power_budget_per_hour(const power_budget_t *budget, unsigned long now,
+                           power_budget_hourly_t *hourly);
+
+#endif
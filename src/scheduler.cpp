@@ -0,0 +1,119 @@
+#include "scheduler.h"
+
+/**
+ * Poll interval bounds while the feed is working. Between these, the interval
+ * grows with the displayed wait since the display counts down by itself and a
+ * late change matters less the further away the tram is.
+ */
+static const unsigned long MIN_INTERVAL = 15ul * 1000ul;
+static const unsigned long MAX_INTERVAL = 120ul * 1000ul;
+static const unsigned long INTERVAL_PER_MINUTE_WAITED = 10ul * 1000ul;
+
+/**
+ * Interval used when the feed works but has no departure for the displayed
+ * journey (e.g. overnight).
+ */
+static const unsigned long NO_DEPARTURE_INTERVAL = 60ul * 1000ul;
+
+/**
+ * The feed reports waits in whole minutes so a displayed wait which hasn't
+ * changed for longer than this is overdue an update.
+ */
+static const unsigned long EXPECTED_CHANGE_INTERVAL = 60ul * 1000ul;
+
+/**
+ * Backoff after failures: doubles with each consecutive failure up to the
+ * maximum.
+ */
+static const unsigned long MIN_BACKOFF = 5ul * 1000ul;
+static const unsigned long MAX_BACKOFF = 10ul * 60ul * 1000ul;
+
+/**
+ * Fraction of each interval (in 1/256ths) randomly added or removed.
+ */
+static const unsigned long JITTER = 32;
+
+void scheduler_init(scheduler_t *scheduler, unsigned long now, uint32_t seed) {
+	scheduler->consecutive_failures = 0;
+	scheduler->random_state = seed ? seed : 1;
+	scheduler->start_time = now;
+	scheduler->polls = 0;
+	scheduler->radio_on_time = 0;
+}
+
+/**
+ * Xorshift pseudo-random number generator.
+ */
+static uint32_t next_random(scheduler_t *scheduler) {
+	uint32_t x = scheduler->random_state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	scheduler->random_state = x;
+	return x;
+}
+
+/**
+ * Randomly lengthen or shorten an interval by up to JITTER/256ths.
+ */
+static unsigned long add_jitter(scheduler_t *scheduler, unsigned long interval) {
+	unsigned long range = (interval / 256) * JITTER;
+	if (range == 0) {
+		return interval;
+	}
+	return interval - range + (next_random(scheduler) % (2 * range + 1));
+}
+
+unsigned long scheduler_poll_complete(scheduler_t *scheduler, bool success,
+                                      unsigned long duration, int wait,
+                                      unsigned long since_change) {
+	scheduler->polls++;
+	scheduler->radio_on_time += duration;
+
+	unsigned long interval;
+	if (!success) {
+		// Exponential backoff (with 'equal jitter': half fixed, half random)
+		interval = MAX_BACKOFF;
+		if (scheduler->consecutive_failures < 16) {
+			unsigned long backoff = MIN_BACKOFF << scheduler->consecutive_failures;
+			if (backoff < MAX_BACKOFF) {
+				interval = backoff;
+			}
+		}
+		scheduler->consecutive_failures++;
+		return interval / 2 + next_random(scheduler) % (interval / 2 + 1);
+	}
+
+	scheduler->consecutive_failures = 0;
+	if (wait < 0) {
+		interval = NO_DEPARTURE_INTERVAL;
+	} else if (since_change > EXPECTED_CHANGE_INTERVAL) {
+		// The displayed time has counted down beyond what the feed reported:
+		// catch up quickly
+		interval = MIN_INTERVAL;
+	} else {
+		interval = wait * INTERVAL_PER_MINUTE_WAITED;
+		if (interval < MIN_INTERVAL) {
+			interval = MIN_INTERVAL;
+		} else if (interval > MAX_INTERVAL) {
+			interval = MAX_INTERVAL;
+		}
+	}
+	return add_jitter(scheduler, interval);
+}
+
+unsigned long scheduler_polls_per_hour(const scheduler_t *scheduler, unsigned long now) {
+	unsigned long elapsed = now - scheduler->start_time;
+	if (elapsed == 0) {
+		return 0;
+	}
+	return (unsigned long)(((unsigned long long)scheduler->polls * 3600000ull) / elapsed);
+}
+
+unsigned int scheduler_radio_on_percent(const scheduler_t *scheduler, unsigned long now) {
+	unsigned long elapsed = now - scheduler->start_time;
+	if (elapsed == 0) {
+		return 0;
+	}
+	return (unsigned int)(((unsigned long long)scheduler->radio_on_time * 100ull) / elapsed);
+}
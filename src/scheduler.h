@@ -0,0 +1,59 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Chooses when to next poll the API, based on the wait currently displayed and
+ * the recent history of failures, and keeps statistics on the polls made.
+ *
+ * All times are in milliseconds (as returned by millis()). Initialise with
+ * scheduler_init.
+ */
+typedef struct {
+	// Number of polls which have failed in a row
+	unsigned int consecutive_failures;
+
+	// State of the pseudo-random number generator used for jitter
+	uint32_t random_state;
+
+	// Time at which statistics collection began
+	unsigned long start_time;
+
+	// Number of polls made and the total time spent making them (i.e. with
+	// the radio active)
+	unsigned long polls;
+	unsigned long radio_on_time;
+} scheduler_t;
+
+/**
+ * Prepare the scheduler. The seed should differ between devices (and boots) so
+ * that their polls don't synchronise.
+ */
+void scheduler_init(scheduler_t *scheduler, unsigned long now, uint32_t seed);
+
+/**
+ * Record the outcome of a poll and return the number of milliseconds to wait
+ * before the next one.
+ *
+ * @param success Did the poll succeed?
+ * @param duration How long the poll took.
+ * @param wait The wait now being displayed (in minutes) or -1 if none.
+ * @param since_change Time since the displayed wait last changed.
+ */
+unsigned long scheduler_poll_complete(scheduler_t *scheduler, bool success,
+                                      unsigned long duration, int wait,
+                                      unsigned long since_change);
+
+/**
+ * Mean number of polls made per hour since scheduler_init.
+ */
+unsigned long scheduler_polls_per_hour(const scheduler_t *scheduler, unsigned long now);
+
+/**
+ * Percentage of the time since scheduler_init spent polling.
+ */
+unsigned int scheduler_radio_on_percent(const scheduler_t *scheduler, unsigned long now);
+
+#endif
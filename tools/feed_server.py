@@ -0,0 +1,219 @@
+"""
+A local stand-in for the TfGM Metrolinks OData endpoint which serves a recorded
+feed payload. Point a device at it by building with, e.g.:
+
+    $ PLATFORMIO_BUILD_FLAGS='-DTRAMBOX_API_HOST=\\"192.168.1.10\\" -DTRAMBOX_API_PORT=8080' \\
+          pio run -t upload
+
+and then run:
+
+    $ python tools/feed_server.py --port 8080 bench/feed.json
+
+The subset of OData understood by the firmware is supported: a $filter of
+"StationLocation eq '...'" clauses joined by "or" and a $select of field names.
+Use --reject-filter to emulate a server which doesn't support filtering.
+
+Connections are kept alive between requests. Use --chunked to send responses
+with chunked transfer encoding and --idle-timeout to close idle connections
+(to exercise the firmware's reconnection logic).
+
+By default the firmware uses HTTPS. Either also define TRAMBOX_API_PLAIN_HTTP
+when building, or serve HTTPS with --tls-cert and --tls-key, e.g. using a
+self-signed certificate made with:
+
+    $ openssl req -x509 -newkey rsa:2048 -nodes -days 365 -subj /CN=trambox \\
+          -keyout key.pem -out cert.pem
+
+and set the device's pinned public key (the 'h' menu key) to the output of:
+
+    $ openssl x509 -in cert.pem -pubkey -noout
+
+Each new connection is logged with whether it resumed an earlier TLS session.
+Combine with --idle-timeout so that each poll makes a new connection, then
+compare the tls_full_connect_ms and tls_resumed_connect_ms handshake times
+reported by the device (the 's' menu key).
+
+Responses are compressed when the request's Accept-Encoding allows gzip or
+deflate, which the firmware only sends when built with TRAMBOX_API_COMPRESSION.
+The device keeps only a small window of decompressed output (see
+INFLATE_WINDOW_BITS in src/inflate.h) and falls back on uncompressed responses
+if a back reference reaches further: --compress-window-bits sets the window
+used by the compressor (zlib's default of 15, a 32kB window, emulates a typical
+server) and --no-compress disables compression altogether.
+"""
+
+import argparse
+import json
+import re
+import ssl
+import sys
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.parse import urlsplit, parse_qs
+
+
+# Size of the chunks sent when using chunked transfer encoding
+CHUNK_SIZE = 1024
+
+FILTER_CLAUSE = re.compile(r"^\s*StationLocation\s+eq\s+'((?:[^']|'')*)'\s*$")
+
+
+def parse_filter(expression):
+    """
+    Parse a $filter expression into a set of station names. Raises ValueError
+    for unsupported expressions.
+    """
+    stations = set()
+    for clause in expression.split(" or "):
+        match = FILTER_CLAUSE.match(clause)
+        if not match:
+            raise ValueError("Unsupported filter clause: {!r}".format(clause))
+        stations.add(match.group(1).replace("''", "'"))
+    return stations
+
+
+def choose_encoding(accept_encoding):
+    """
+    Choose the Content-Encoding of a response from the request's
+    Accept-Encoding header, or None for no encoding.
+    """
+    codings = {}
+    for item in accept_encoding.split(","):
+        coding, _, params = item.strip().partition(";")
+        q = 1.0
+        match = re.search(r"q\s*=\s*([0-9.]+)", params)
+        if match:
+            q = float(match.group(1))
+        codings[coding.strip().lower()] = q
+    for coding in ("gzip", "deflate"):
+        if codings.get(coding, 0) > 0:
+            return coding
+    return None
+
+
+def compress(body, encoding, window_bits):
+    """
+    Compress body with gzip (RFC 1952) or, for deflate, zlib (RFC 1950).
+    """
+    wbits = window_bits + 16 if encoding == "gzip" else window_bits
+    compressor = zlib.compressobj(9, zlib.DEFLATED, wbits)
+    return compressor.compress(body) + compressor.flush()
+
+
+def make_handler(feed, args):
+    class FeedHandler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+        timeout = args.idle_timeout
+
+        def setup(self):
+            super().setup()
+            if isinstance(self.connection, ssl.SSLSocket):
+                self.log_message("%s connection, %s session, cipher %s",
+                                 self.connection.version(),
+                                 "resumed" if self.connection.session_reused else "new",
+                                 self.connection.cipher()[0])
+
+        def send_body(self, status, body, content_type="application/json"):
+            self.send_response(status)
+            self.send_header("Content-Type", content_type)
+            encoding = None
+            if not args.no_compress:
+                encoding = choose_encoding(self.headers.get("Accept-Encoding", ""))
+            if encoding:
+                length = len(body)
+                body = compress(body, encoding, args.compress_window_bits)
+                self.send_header("Content-Encoding", encoding)
+                self.log_message("%s: %d bytes compressed to %d", encoding, length, len(body))
+            if args.chunked:
+                self.send_header("Transfer-Encoding", "chunked")
+                self.end_headers()
+                for i in range(0, len(body), CHUNK_SIZE):
+                    chunk = body[i:i + CHUNK_SIZE]
+                    self.wfile.write(b"%X\r\n%s\r\n" % (len(chunk), chunk))
+                self.wfile.write(b"0\r\n\r\n")
+            else:
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+        def do_GET(self):
+            url = urlsplit(self.path)
+            if url.path != args.path:
+                self.send_body(404, b'{"error":"not found"}')
+                return
+
+            query = parse_qs(url.query)
+            records = feed["value"]
+
+            if "$filter" in query:
+                if args.reject_filter:
+                    self.send_body(400, b'{"error":"$filter not supported"}')
+                    return
+                try:
+                    stations = parse_filter(query["$filter"][0])
+                except ValueError as e:
+                    self.send_body(400, json.dumps({"error": str(e)}).encode("utf-8"))
+                    return
+                records = [r for r in records if r.get("StationLocation") in stations]
+
+            if "$select" in query:
+                fields = query["$select"][0].split(",")
+                records = [{f: r[f] for f in fields if f in r} for r in records]
+
+            body = json.dumps(
+                {"@odata.context": feed.get("@odata.context", ""), "value": records},
+                separators=(",", ":"),
+            ).encode("utf-8")
+            self.send_body(200, body)
+
+    return FeedHandler
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("feed", nargs="?", default="bench/feed.json",
+                        help="Recorded feed payload to serve (default: %(default)s)")
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--path", default="/odata/Metrolinks")
+    parser.add_argument("--reject-filter", action="store_true",
+                        help="Respond to requests with a $filter with 400 Bad Request")
+    parser.add_argument("--chunked", action="store_true",
+                        help="Send responses using chunked transfer encoding")
+    parser.add_argument("--idle-timeout", type=float, default=None,
+                        help="Close connections idle for this many seconds")
+    parser.add_argument("--tls-cert", default=None,
+                        help="Serve HTTPS using this (PEM) certificate")
+    parser.add_argument("--tls-key", default=None,
+                        help="Private key for --tls-cert")
+    parser.add_argument("--no-compress", action="store_true",
+                        help="Never compress responses")
+    parser.add_argument("--compress-window-bits", type=int, default=15,
+                        choices=range(9, 16), metavar="{9..15}",
+                        help="Compressor window size, as a power of two (default: %(default)s)")
+    args = parser.parse_args(argv)
+
+    with open(args.feed, encoding="utf-8") as f:
+        feed = json.load(f)
+
+    server = ThreadingHTTPServer((args.host, args.port), make_handler(feed, args))
+    if args.tls_cert:
+        # BearSSL on the device supports up to TLS 1.2. Session IDs are cached
+        # by the context, allowing resumption.
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.maximum_version = ssl.TLSVersion.TLSv1_2
+        context.load_cert_chain(args.tls_cert, args.tls_key)
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+    # The port actually bound, in case --port 0 asked for any free one
+    print("Serving {} on {}://{}:{}".format(
+        args.feed, "https" if args.tls_cert else "http", args.host,
+        server.server_address[1]), flush=True)
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,515 @@
+"""
+Generate src/metrolink_tables.{h,cpp} from the network description in
+src/metrolink_map.txt. Everything is placed in flash, leaving the ESP8266's
+scarce DRAM free.
+
+The station names are packed into a single blob, each starting on a 4-byte
+boundary and padded with nulls, so they can be copied out using aligned 32-bit
+flash reads. The links between stations are listed as pairs of station indices.
+
+The station name index maps the canonical key of a station name (see
+station_key()) to its index via a hash table whose seed is chosen such that
+every station occupies a distinct slot. Keys are also padded to a multiple of 4
+bytes so they can be compared a word at a time.
+
+The journey tables hold, for every (start, target) journey, the set of stations which a
+tram leaving 'start' may be heading for if it will call at 'target'. This is
+precisely what the DFS formerly run by metrolink_set_journey() computed on the
+device: a station is a valid destination if some simple path through the
+network from 'start' passes through 'target' and then reaches it.
+
+The network itself is also emitted as a compressed sparse row adjacency: the
+neighbours of station i are METROLINK_NEIGHBOURS[METROLINK_NEIGHBOUR_OFFSETS[i]]
+up to (but excluding) METROLINK_NEIGHBOURS[METROLINK_NEIGHBOUR_OFFSETS[i + 1]].
+
+Runs automatically before every PlatformIO build (see platformio.ini) and may
+also be run by hand:
+
+    $ python tools/generate_metrolink_tables.py
+
+Output files are only rewritten when their contents change.
+"""
+
+import os
+import re
+import zlib
+
+
+def parse_map(filename):
+    """
+    Parse the [stations] and [links] sections of the given network description.
+    Returns (stations, links) where stations is a list of names and links a
+    list of (index, index) pairs.
+    """
+    sections = {"stations": [], "links": []}
+    section = None
+    with open(filename, encoding="utf-8") as f:
+        for number, line in enumerate(f, 1):
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            match = re.match(r"^\[(\w+)\]$", line)
+            if match and match.group(1) in sections:
+                section = sections[match.group(1)]
+            elif section is None:
+                raise ValueError("{}:{}: Not in a section".format(filename, number))
+            else:
+                section.append(line)
+
+    stations = sections["stations"]
+    index = {name: i for i, name in enumerate(stations)}
+    if len(index) != len(stations):
+        raise ValueError("Duplicate station name")
+
+    links = []
+    for link in sections["links"]:
+        names = [name.strip() for name in link.split(" -- ")]
+        if len(names) != 2:
+            raise ValueError("Malformed link: {!r}".format(link))
+        for name in names:
+            if name not in index:
+                raise ValueError("Unknown station in link: {!r}".format(name))
+        links.append((index[names[0]], index[names[1]]))
+
+    return stations, links
+
+
+# Parameters of the 32-bit FNV-1a hash of station keys and the seeded
+# multiplicative hash mapping these to index slots. Must match metrolink.cpp.
+FNV_OFFSET_BASIS = 0x811C9DC5
+FNV_PRIME = 0x01000193
+SLOT_MULTIPLIER = 0x9E3779B1
+
+# Marks an empty slot in the station index
+EMPTY_SLOT = 0xFF
+
+
+def station_key(name):
+    """
+    The canonical key for a station name, as produced by next_key_char() in
+    metrolink.cpp: only ASCII letters and digits are kept (lower-cased) and
+    anything following a non-alphanumeric byte followed by "via " (in any case)
+    is dropped. All other bytes, including every byte of a UTF-8 multi-byte
+    sequence, are skipped.
+    """
+    data = name.encode("utf-8")
+    key = bytearray()
+    for i, c in enumerate(data):
+        if c < 0x80 and chr(c).isalnum():
+            key.append(ord(chr(c).lower()))
+        elif data[i + 1:i + 5].lower() == b"via ":
+            break
+    return key.decode("ascii")
+
+
+def fnv1a(key):
+    h = FNV_OFFSET_BASIS
+    for c in key.encode("ascii"):
+        h = ((h ^ c) * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def slot(h, seed, bits):
+    return (((h ^ seed) * SLOT_MULTIPLIER) & 0xFFFFFFFF) >> (32 - bits)
+
+
+def build_station_index(stations):
+    """
+    Returns (keys, hashes, seed, bits, table) for the station name index.
+    """
+    keys = [station_key(name) for name in stations]
+    hashes = [fnv1a(key) for key in keys]
+    if len(set(keys)) != len(keys):
+        raise ValueError("Station names do not have unique keys")
+    if len(set(hashes)) != len(hashes):
+        raise ValueError("Station key hashes collide")
+    if len(stations) >= EMPTY_SLOT:
+        raise ValueError("Too many stations for an 8-bit index")
+
+    # Use a table with at least four slots per station and search for a seed
+    # which gives a perfect hash, falling back on linear probing if none is
+    # found.
+    bits = max(1, (len(stations) * 4 - 1).bit_length())
+    size = 1 << bits
+    best = None
+    for seed in range(100000):
+        table = [EMPTY_SLOT] * size
+        longest_probe = 0
+        for index, h in enumerate(hashes):
+            s = slot(h, seed, bits)
+            probe = 0
+            while table[(s + probe) % size] != EMPTY_SLOT:
+                probe += 1
+            table[(s + probe) % size] = index
+            longest_probe = max(longest_probe, probe)
+        if best is None or longest_probe < best[0]:
+            best = (longest_probe, seed, table)
+        if longest_probe == 0:
+            break
+
+    _, seed, table = best
+    return keys, hashes, seed, bits, table
+
+
+def build_adjacency(num_stations, links):
+    """
+    Returns a list of the neighbouring station indices of every station (in
+    the order the links are listed).
+    """
+    neighbours = [[] for _ in range(num_stations)]
+    for a, b in links:
+        neighbours[a].append(b)
+        neighbours[b].append(a)
+    return neighbours
+
+
+def compute_destination_sets(num_stations, links):
+    """
+    Returns a matrix valid[start][target] of frozensets of station indices
+    which are valid destinations for the journey from start to target.
+    """
+    neighbours = build_adjacency(num_stations, links)
+
+    valid = [[set() for _ in range(num_stations)] for _ in range(num_stations)]
+
+    for start in range(num_stations):
+        # Enumerate every simple path from start. Every station reached is a
+        # valid destination for a journey to each station earlier on the path
+        # (and to itself).
+        path = [start]
+        on_path = [False] * num_stations
+        on_path[start] = True
+        stack = [iter(neighbours[start])]
+        while stack:
+            station = next(stack[-1], None)
+            if station is None:
+                stack.pop()
+                on_path[path.pop()] = False
+            elif not on_path[station]:
+                for target in path[1:]:
+                    valid[start][target].add(station)
+                valid[start][station].add(station)
+                path.append(station)
+                on_path[station] = True
+                stack.append(iter(neighbours[station]))
+
+    return [[frozenset(s) for s in row] for row in valid]
+
+
+def align4(n):
+    return (n + 3) & ~3
+
+
+def c_string(data):
+    """
+    A C string literal of the given bytes (non-ASCII bytes are escaped).
+    """
+    out = []
+    for c in data:
+        if c in (0x22, 0x5C):
+            out.append("\\" + chr(c))
+        elif 0x20 <= c < 0x7F:
+            out.append(chr(c))
+        else:
+            out.append("\\{:03o}".format(c))
+    return '"' + "".join(out) + '"'
+
+
+def format_array(values, per_line, fmt="{}"):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(", ".join(fmt.format(v) for v in values[i:i + per_line]) + ",")
+    return lines
+
+
+def generate(stations, links):
+    """
+    Returns the (header, source) text of the generated tables.
+    """
+    num_stations = len(stations)
+    set_bytes = (num_stations + 7) // 8
+
+    keys, hashes, seed, bits, index_table = build_station_index(stations)
+    max_key_length = max(len(key) for key in keys)
+
+    # Each name starts on a 4-byte boundary and is padded with at least one
+    # null
+    names = [name.encode("utf-8") for name in stations]
+    max_name_length = max(len(name) for name in names)
+    name_offsets = []
+    names_size = 0
+    for name in names:
+        name_offsets.append(names_size)
+        names_size += align4(len(name) + 1)
+    if names_size > 0xFFFF:
+        raise ValueError("Station names too long for 16-bit offsets")
+
+    stations_crc = zlib.crc32(b"".join(name + b"\n" for name in names))
+
+    valid = compute_destination_sets(num_stations, links)
+
+    adjacency = build_adjacency(num_stations, links)
+    neighbour_offsets = [0]
+    for neighbours in adjacency:
+        neighbour_offsets.append(neighbour_offsets[-1] + len(neighbours))
+    if neighbour_offsets[-1] <= 0xFF:
+        offset_type, offset_read = "uint8_t", "pgm_read_byte"
+    else:
+        offset_type, offset_read = "uint16_t", "pgm_read_word"
+
+    # Deduplicate the destination sets; set 0 is the empty set.
+    set_ids = {frozenset(): 0}
+    for row in valid:
+        for s in row:
+            set_ids.setdefault(s, len(set_ids))
+    sets = sorted(set_ids, key=set_ids.get)
+    if len(sets) <= 0x100:
+        set_id_type, set_id_read = "uint8_t", "pgm_read_byte"
+    else:
+        set_id_type, set_id_read = "uint16_t", "pgm_read_word"
+
+    header = [
+        "// Generated by tools/generate_metrolink_tables.py from",
+        "// src/metrolink_map.txt. Do not edit.",
+        "",
+        "#ifndef METROLINK_TABLES_H",
+        "#define METROLINK_TABLES_H",
+        "",
+        "#include <stdint.h>",
+        "#include <pgmspace.h>",
+        "",
+        "/**",
+        " * Number of stations the tables were generated for (equal to",
+        " * NUM_METROLINK_STATIONS).",
+        " */",
+        "#define METROLINK_TABLES_NUM_STATIONS {}".format(num_stations),
+        "",
+        "/**",
+        " * Length of the longest station key (see metrolink.cpp).",
+        " */",
+        "#define METROLINK_MAX_KEY_LENGTH {}".format(max_key_length),
+        "",
+        "/**",
+        " * Seed and size (log2) of the station index hash table.",
+        " */",
+        "#define METROLINK_STATION_INDEX_SEED 0x{:08X}u".format(seed),
+        "#define METROLINK_STATION_INDEX_BITS {}".format(bits),
+        "",
+        "/**",
+        " * Value of empty slots in METROLINK_STATION_INDEX.",
+        " */",
+        "#define METROLINK_STATION_INDEX_EMPTY 0x{:02X}".format(EMPTY_SLOT),
+        "",
+        "/**",
+        " * Length in bytes (of UTF-8) of the longest station name.",
+        " */",
+        "#define METROLINK_MAX_NAME_LENGTH {}".format(max_name_length),
+        "",
+        "/**",
+        " * CRC-32 of the station names in order, each followed by a newline. Identifies",
+        " * the station numbering, e.g. in the binary departures format.",
+        " */",
+        "#define METROLINK_STATIONS_CRC 0x{:08X}u".format(stations_crc),
+        "",
+        "/**",
+        " * The station names (UTF-8), each starting at the offset given by",
+        " * METROLINK_STATION_NAME_OFFSETS (a multiple of 4) and padded with at least",
+        " * one null to a multiple of 4 bytes. In flash, 4-byte aligned.",
+        " */",
+        "extern const char METROLINK_STATION_NAMES[];",
+        "extern const uint16_t METROLINK_STATION_NAME_OFFSETS[METROLINK_TABLES_NUM_STATIONS];",
+        "",
+        "/**",
+        " * Number of links between stations.",
+        " */",
+        "#define METROLINK_NUM_LINKS {}".format(len(links)),
+        "",
+        "/**",
+        " * The indices of the stations at either end of each link (listed in one",
+        " * direction only). In flash.",
+        " */",
+        "extern const uint8_t METROLINK_LINKS[METROLINK_NUM_LINKS][2];",
+        "",
+        "/**",
+        " * Size of each entry in METROLINK_STATION_KEYS: at least",
+        " * METROLINK_MAX_KEY_LENGTH + 1, rounded up to a multiple of 4.",
+        " */",
+        "#define METROLINK_KEY_STRIDE {}".format(align4(max_key_length + 1)),
+        "",
+        "/**",
+        " * Canonical key of each station name, padded with nulls. In flash, 4-byte",
+        " * aligned.",
+        " */",
+        "extern const char METROLINK_STATION_KEYS"
+        "[METROLINK_TABLES_NUM_STATIONS][METROLINK_KEY_STRIDE];",
+        "",
+        "/**",
+        " * FNV-1a hash of each station's key. In flash.",
+        " */",
+        "extern const uint32_t METROLINK_STATION_HASHES[METROLINK_TABLES_NUM_STATIONS];",
+        "",
+        "/**",
+        " * Open-addressed (linear probing) hash table of station indices. In flash.",
+        " */",
+        "extern const uint8_t METROLINK_STATION_INDEX[1 << METROLINK_STATION_INDEX_BITS];",
+        "",
+        "/**",
+        " * Number of bytes in a station bitset.",
+        " */",
+        "#define METROLINK_STATION_SET_BYTES {}".format(set_bytes),
+        "",
+        "/**",
+        " * Number of distinct destination sets.",
+        " */",
+        "#define METROLINK_NUM_DESTINATION_SETS {}".format(len(sets)),
+        "",
+        "/**",
+        " * Index into METROLINK_DESTINATION_SETS and a macro to read one from flash.",
+        " */",
+        "typedef {} metrolink_destination_set_id_t;".format(set_id_type),
+        "#define METROLINK_READ_DESTINATION_SET_ID(addr) {}(addr)".format(set_id_read),
+        "",
+        "/**",
+        " * Distinct sets of valid destinations as bitsets (station index i is bit",
+        " * i % 8 of byte i / 8). Set 0 is empty. In flash.",
+        " */",
+        "extern const uint8_t METROLINK_DESTINATION_SETS"
+        "[METROLINK_NUM_DESTINATION_SETS][METROLINK_STATION_SET_BYTES];",
+        "",
+        "/**",
+        " * For each [start][target] station index pair, the index of the set in",
+        " * METROLINK_DESTINATION_SETS of valid destinations. In flash.",
+        " */",
+        "extern const metrolink_destination_set_id_t METROLINK_JOURNEY_DESTINATION_SETS"
+        "[METROLINK_TABLES_NUM_STATIONS][METROLINK_TABLES_NUM_STATIONS];",
+        "",
+        "/**",
+        " * Number of entries in METROLINK_NEIGHBOURS (twice the number of links).",
+        " */",
+        "#define METROLINK_NUM_NEIGHBOURS {}".format(neighbour_offsets[-1]),
+        "",
+        "/**",
+        " * Index into METROLINK_NEIGHBOURS and a macro to read one from flash.",
+        " */",
+        "typedef {} metrolink_neighbour_offset_t;".format(offset_type),
+        "#define METROLINK_READ_NEIGHBOUR_OFFSET(addr) {}(addr)".format(offset_read),
+        "",
+        "/**",
+        " * The network as a compressed sparse row adjacency: the neighbours of",
+        " * station i are METROLINK_NEIGHBOURS[METROLINK_NEIGHBOUR_OFFSETS[i]] up to",
+        " * (but excluding) METROLINK_NEIGHBOURS[METROLINK_NEIGHBOUR_OFFSETS[i + 1]].",
+        " * In flash.",
+        " */",
+        "extern const metrolink_neighbour_offset_t METROLINK_NEIGHBOUR_OFFSETS"
+        "[METROLINK_TABLES_NUM_STATIONS + 1];",
+        "extern const uint8_t METROLINK_NEIGHBOURS[METROLINK_NUM_NEIGHBOURS];",
+        "",
+        "#endif",
+    ]
+
+    source = [
+        "// Generated by tools/generate_metrolink_tables.py from",
+        "// src/metrolink_map.txt. Do not edit.",
+        "",
+        '#include "metrolink_tables.h"',
+        "",
+        "alignas(4) const char METROLINK_STATION_NAMES[] PROGMEM =",
+    ]
+    for i, name in enumerate(names):
+        padding = align4(len(name) + 1) - len(name)
+        if i == len(names) - 1:
+            # The literal's own null ends the blob
+            padding -= 1
+        source.append("\t{}{}".format(c_string(name), ' "' + "\\0" * padding + '"' if padding else ""))
+    source[-1] += ";"
+    source.append("")
+    source.append(
+        "const uint16_t METROLINK_STATION_NAME_OFFSETS[METROLINK_TABLES_NUM_STATIONS] PROGMEM = {")
+    source.extend("\t" + line for line in format_array(name_offsets, 12))
+    source.append("};")
+    source.append("")
+    source.append("const uint8_t METROLINK_LINKS[METROLINK_NUM_LINKS][2] PROGMEM = {")
+    source.extend("\t{{{}, {}}},".format(a, b) for a, b in links)
+    source.append("};")
+    source.extend([
+        "",
+        "alignas(4) const char METROLINK_STATION_KEYS"
+        "[METROLINK_TABLES_NUM_STATIONS][METROLINK_KEY_STRIDE] PROGMEM = {",
+    ])
+    source.extend('\t"{}",'.format(key) for key in keys)
+    source.append("};")
+    source.append("")
+    source.append(
+        "const uint32_t METROLINK_STATION_HASHES[METROLINK_TABLES_NUM_STATIONS] PROGMEM = {")
+    source.extend("\t" + line for line in format_array(hashes, 6, "0x{:08X}u"))
+    source.append("};")
+    source.append("")
+    source.append(
+        "const uint8_t METROLINK_STATION_INDEX[1 << METROLINK_STATION_INDEX_BITS] PROGMEM = {")
+    source.extend("\t" + line for line in format_array(index_table, 16, "0x{:02X}"))
+    source.append("};")
+    source.extend([
+        "",
+        "const uint8_t METROLINK_DESTINATION_SETS"
+        "[METROLINK_NUM_DESTINATION_SETS][METROLINK_STATION_SET_BYTES] PROGMEM = {",
+    ])
+    for s in sets:
+        bits = [0] * set_bytes
+        for station in s:
+            bits[station // 8] |= 1 << (station % 8)
+        source.append("\t{" + ", ".join("0x{:02X}".format(b) for b in bits) + "},")
+    source.append("};")
+    source.append("")
+    source.append(
+        "const metrolink_destination_set_id_t METROLINK_JOURNEY_DESTINATION_SETS"
+        "[METROLINK_TABLES_NUM_STATIONS][METROLINK_TABLES_NUM_STATIONS] PROGMEM = {")
+    for start, row in enumerate(valid):
+        source.append("\t// {}".format(stations[start]))
+        source.append("\t{")
+        ids = [0 if target == start else set_ids[s] for target, s in enumerate(row)]
+        source.extend("\t\t" + line for line in format_array(ids, 16))
+        source.append("\t},")
+    source.append("};")
+    source.append("")
+    source.append(
+        "const metrolink_neighbour_offset_t METROLINK_NEIGHBOUR_OFFSETS"
+        "[METROLINK_TABLES_NUM_STATIONS + 1] PROGMEM = {")
+    source.extend("\t" + line for line in format_array(neighbour_offsets, 16))
+    source.append("};")
+    source.append("")
+    source.append("const uint8_t METROLINK_NEIGHBOURS[METROLINK_NUM_NEIGHBOURS] PROGMEM = {")
+    for station, neighbours in enumerate(adjacency):
+        source.append("\t// {}".format(stations[station]))
+        source.extend("\t" + line for line in format_array(neighbours, 16))
+    source.append("};")
+
+    return "\n".join(header) + "\n", "\n".join(source) + "\n"
+
+
+def write_if_changed(filename, contents):
+    try:
+        with open(filename, encoding="utf-8") as f:
+            if f.read() == contents:
+                return
+    except OSError:
+        pass
+    with open(filename, "w", encoding="utf-8") as f:
+        f.write(contents)
+    print("Generated {}".format(filename))
+
+
+def main(project_dir):
+    src_dir = os.path.normpath(os.path.join(project_dir, "src"))
+    stations, links = parse_map(os.path.join(src_dir, "metrolink_map.txt"))
+    header, source = generate(stations, links)
+    write_if_changed(os.path.join(src_dir, "metrolink_tables.h"), header)
+    write_if_changed(os.path.join(src_dir, "metrolink_tables.cpp"), source)
+
+
+try:
+    # Running as a PlatformIO extra script
+    Import("env")  # noqa: F821
+except NameError:
+    main(os.path.join(os.path.dirname(os.path.abspath(__file__)), ".."))
+else:
+    main(env.subst("$PROJECT_DIR"))  # noqa: F821
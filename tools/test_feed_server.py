@@ -0,0 +1,105 @@
+"""
+Tests for tools/feed_server.py, run from the repository root with:
+
+    $ python -m unittest discover -s tools
+
+Each test starts the server on a free port and makes the requests the firmware
+would: a filtered request (as built by departures_build_request_path) and, if
+the filter is rejected, an unfiltered one. The firmware only stops filtering
+for the statuses accepted by departures_filter_rejected (400, 414 and 501).
+"""
+
+import http.client
+import json
+import os
+import re
+import subprocess
+import sys
+import unittest
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+FEED = os.path.join(ROOT, "bench", "feed.json")
+
+BASE_PATH = "/odata/Metrolinks"
+FILTERED_PATH = (
+    BASE_PATH + "?$filter=StationLocation%20eq%20%27Piccadilly%27"
+    "%20or%20StationLocation%20eq%20%27Deansgate%20-%20Castlefield%27"
+    "&$select=StationLocation,Dest0,Wait0,Dest1,Wait1,Dest2,Wait2,Dest3,Wait3"
+)
+FILTERED_STATIONS = {"Piccadilly", "Deansgate - Castlefield"}
+
+# Statuses for which departures_filter_rejected is true
+FILTER_REJECTED_STATUSES = {400, 414, 501}
+
+
+class FeedServer:
+    """
+    Runs tools/feed_server.py with the given options on a free local port.
+    """
+
+    def __init__(self, *options):
+        self.process = subprocess.Popen(
+            [sys.executable, os.path.join(ROOT, "tools", "feed_server.py"),
+             "--host", "127.0.0.1", "--port", "0", "--no-compress", *options, FEED],
+            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, text=True)
+        match = re.search(r":(\d+)$", self.process.stdout.readline().strip())
+        if not match:
+            self.close()
+            raise RuntimeError("feed_server.py didn't start")
+        self.port = int(match.group(1))
+
+    def get(self, path):
+        """
+        Make a request, returning the status and the decoded JSON body.
+        """
+        connection = http.client.HTTPConnection("127.0.0.1", self.port, timeout=10)
+        try:
+            connection.request("GET", path, headers={"User-Agent": "InternetOfTrams"})
+            response = connection.getresponse()
+            return response.status, json.loads(response.read())
+        finally:
+            connection.close()
+
+    def close(self):
+        self.process.terminate()
+        self.process.wait()
+        self.process.stdout.close()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc_info):
+        self.close()
+
+
+class FeedServerTest(unittest.TestCase):
+    def test_filter(self):
+        with FeedServer() as server:
+            status, body = server.get(FILTERED_PATH)
+            self.assertEqual(status, 200)
+            stations = {record["StationLocation"] for record in body["value"]}
+            self.assertEqual(stations, FILTERED_STATIONS)
+            self.assertEqual(set(body["value"][0]),
+                             {"StationLocation", "Dest0", "Wait0", "Dest1", "Wait1",
+                              "Dest2", "Wait2", "Dest3", "Wait3"})
+
+    def test_reject_filter(self):
+        with FeedServer("--reject-filter") as server:
+            status, _ = server.get(FILTERED_PATH)
+            self.assertIn(status, FILTER_REJECTED_STATUSES)
+
+            # The firmware's fallback
+            status, body = server.get(BASE_PATH)
+            self.assertEqual(status, 200)
+            stations = {record["StationLocation"] for record in body["value"]}
+            self.assertTrue(FILTERED_STATIONS <= stations)
+            self.assertGreater(len(stations), len(FILTERED_STATIONS))
+
+    def test_unknown_path(self):
+        with FeedServer("--reject-filter") as server:
+            status, _ = server.get("/odata/Other")
+            self.assertNotIn(status, FILTER_REJECTED_STATUSES)
+
+
+if __name__ == "__main__":
+    unittest.main()